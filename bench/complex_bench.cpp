@@ -0,0 +1,160 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Times a complex multiply-accumulate loop with the inline Complex
+// operators, against the same loop calling out-of-line operators (as
+// when they were defined in complex.cpp), std::complex and plain
+// doubles.
+
+#include "../math/complex.h"
+#include <chrono>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define THMATH_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define THMATH_NOINLINE __declspec(noinline)
+#else
+#define THMATH_NOINLINE
+#endif
+
+namespace
+{
+    using thmath::Complex;
+
+    // What every call cost before: a call the compiler cannot see into.
+    THMATH_NOINLINE Complex multiply(const Complex& a, const Complex& b)
+    {
+        return a * b;
+    }
+
+    THMATH_NOINLINE Complex add(const Complex& a, const Complex& b)
+    {
+        return a + b;
+    }
+
+    // Seconds per call, repeating short calls for at least 0.2 s.
+    template <typename F>
+    double measure(F loop)
+    {
+        size_t repetitions = 0;
+        double seconds = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        while (seconds < 0.2)
+        {
+            loop();
+            repetitions++;
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        return seconds / static_cast<double>(repetitions);
+    }
+}
+
+int main()
+{
+    const size_t size = 4096;
+    std::mt19937_64 generator(14);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+
+    std::vector<Complex> a(size);
+    std::vector<Complex> b(size);
+    std::vector<std::complex<double>> a_std(size);
+    std::vector<std::complex<double>> b_std(size);
+    for (size_t index = 0; index < size; index++)
+    {
+        a[index] = Complex(distribution(generator), distribution(generator));
+        b[index] = Complex(distribution(generator), distribution(generator));
+        a_std[index] = std::complex<double>(a[index].get_real(), a[index].get_imaginary());
+        b_std[index] = std::complex<double>(b[index].get_real(), b[index].get_imaginary());
+    }
+
+    Complex inline_sum;
+    double inline_seconds = measure([&]()
+    {
+        Complex sum;
+        for (size_t index = 0; index < size; index++)
+        {
+            sum += a[index] * b[index];
+        }
+        inline_sum = sum;
+    });
+
+    Complex call_sum;
+    double call_seconds = measure([&]()
+    {
+        Complex sum;
+        for (size_t index = 0; index < size; index++)
+        {
+            sum = add(sum, multiply(a[index], b[index]));
+        }
+        call_sum = sum;
+    });
+
+    std::complex<double> std_sum;
+    double std_seconds = measure([&]()
+    {
+        std::complex<double> sum;
+        for (size_t index = 0; index < size; index++)
+        {
+            sum += a_std[index] * b_std[index];
+        }
+        std_sum = sum;
+    });
+
+    double plain_real = 0.0;
+    double plain_imaginary = 0.0;
+    double plain_seconds = measure([&]()
+    {
+        double real = 0.0;
+        double imaginary = 0.0;
+        for (size_t index = 0; index < size; index++)
+        {
+            double x = a[index].get_real();
+            double y = a[index].get_imaginary();
+            double u = b[index].get_real();
+            double v = b[index].get_imaginary();
+            real += x * u - y * v;
+            imaginary += x * v + y * u;
+        }
+        plain_real = real;
+        plain_imaginary = imaginary;
+    });
+
+    auto report = [&](const char* name, double seconds)
+    {
+        std::printf("%-26s %8.3f ns per multiply-add, %5.2fx the inline loop\n",
+            name, seconds * 1e9 / static_cast<double>(size), seconds / inline_seconds);
+    };
+    std::printf("%zu products, summed %s / %s / (%g, %g) / (%g, %g)\n", size,
+        inline_sum.to_string().c_str(), call_sum.to_string().c_str(),
+        std_sum.real(), std_sum.imag(), plain_real, plain_imaginary);
+    report("inline Complex", inline_seconds);
+    report("out-of-line operators", call_seconds);
+    report("std::complex<double>", std_seconds);
+    report("plain doubles", plain_seconds);
+    return 0;
+}
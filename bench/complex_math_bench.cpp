@@ -0,0 +1,212 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Backs the accuracy table of complex_math.h: for every function, 2^20
+// random inputs over its documented range (and over a small one) are
+// computed in FAST mode and compared to STRICT mode, in ULP of
+// max(|Re|, |Im|) of the STRICT result. Also times both modes against
+// the per-element std::exp / std::log / ... loop over std::complex.
+// Returns 1 if a documented bound is exceeded.
+
+#include "../math/complex_math.h"
+#include "../math/simd.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using thmath::Complex;
+    using thmath::ComplexArray;
+    using thmath::complex_math::Accuracy;
+
+    const size_t SIZE = size_t(1) << 20;
+
+    using BatchFunction = std::function<void(const ComplexArray&, ComplexArray&, Accuracy)>;
+    using ElementFunction = std::function<std::complex<double>(std::complex<double>)>;
+    using Sampler = std::function<Complex(std::mt19937_64&)>;
+
+    struct Case
+    {
+        const char* name;
+        const char* range;
+        BatchFunction batch;
+        ElementFunction element;
+        Sampler sample;
+        // The documented bound, in ULP; 0 when none is documented.
+        double bound;
+    };
+
+    // Seconds per call, repeating short calls for at least 0.2 s.
+    template <typename F>
+    double measure(F function)
+    {
+        size_t repetitions = 0;
+        double seconds = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        while (seconds < 0.2)
+        {
+            function();
+            repetitions++;
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        return seconds / static_cast<double>(repetitions);
+    }
+
+    Sampler uniform(double real, double imaginary)
+    {
+        return [real, imaginary](std::mt19937_64& generator)
+        {
+            std::uniform_real_distribution<double> re(-real, real);
+            std::uniform_real_distribution<double> im(-imaginary, imaginary);
+            return Complex(re(generator), im(generator));
+        };
+    }
+
+    // Both parts of random sign, with magnitudes spread uniformly
+    // over the exponents of [10^-exponent, 10^exponent].
+    Sampler logarithmic(double exponent)
+    {
+        return [exponent](std::mt19937_64& generator)
+        {
+            std::uniform_real_distribution<double> power(-exponent, exponent);
+            std::bernoulli_distribution negative(0.5);
+            double re = std::pow(10.0, power(generator));
+            double im = std::pow(10.0, power(generator));
+            return Complex(negative(generator) ? -re : re, negative(generator) ? -im : im);
+        };
+    }
+
+    double error_in_ulp(const Complex& value, const Complex& expected)
+    {
+        double magnitude = std::max(std::abs(expected.get_real()), std::abs(expected.get_imaginary()));
+        double ulp = std::nextafter(magnitude, std::numeric_limits<double>::infinity()) - magnitude;
+        double error = std::max(
+            std::abs(value.get_real() - expected.get_real()),
+            std::abs(value.get_imaginary() - expected.get_imaginary())
+        );
+        return error / ulp;
+    }
+}
+
+int main()
+{
+    const double TWO_30 = 1073741824.0;
+    const Complex exponent(2.5, 0.5);
+    const std::complex<double> std_exponent(2.5, 0.5);
+
+    const Case cases[] = {
+        {"exp", "|Re| <= 708, |Im| < 2^30", thmath::complex_math::exp,
+            [](std::complex<double> z) { return std::exp(z); }, uniform(708.0, TWO_30), 4.0},
+        {"exp", "|Re| <= 2, |Im| <= 4", thmath::complex_math::exp,
+            [](std::complex<double> z) { return std::exp(z); }, uniform(2.0, 4.0), 4.0},
+        {"log", "1e-150 <= |Re|, |Im| <= 1e150", thmath::complex_math::log,
+            [](std::complex<double> z) { return std::log(z); }, logarithmic(150.0), 3.0},
+        {"log", "|Re|, |Im| <= 2", thmath::complex_math::log,
+            [](std::complex<double> z) { return std::log(z); }, uniform(2.0, 2.0), 3.0},
+        {"sqrt", "1e-150 <= |Re|, |Im| <= 1e150", thmath::complex_math::sqrt,
+            [](std::complex<double> z) { return std::sqrt(z); }, logarithmic(150.0), 2.0},
+        {"sqrt", "|Re|, |Im| <= 2", thmath::complex_math::sqrt,
+            [](std::complex<double> z) { return std::sqrt(z); }, uniform(2.0, 2.0), 2.0},
+        {"sin", "|Re| < 2^30, |Im| <= 708", thmath::complex_math::sin,
+            [](std::complex<double> z) { return std::sin(z); }, uniform(TWO_30, 708.0), 6.0},
+        {"sin", "|Re| <= 10, |Im| <= 5", thmath::complex_math::sin,
+            [](std::complex<double> z) { return std::sin(z); }, uniform(10.0, 5.0), 6.0},
+        {"cos", "|Re| < 2^30, |Im| <= 708", thmath::complex_math::cos,
+            [](std::complex<double> z) { return std::cos(z); }, uniform(TWO_30, 708.0), 6.0},
+        {"cos", "|Re| <= 10, |Im| <= 5", thmath::complex_math::cos,
+            [](std::complex<double> z) { return std::cos(z); }, uniform(10.0, 5.0), 6.0},
+        {"pow", "z^(2.5 + 0.5i), |Re|, |Im| <= 3",
+            [&exponent](const ComplexArray& input, ComplexArray& output, Accuracy accuracy)
+            {
+                thmath::complex_math::pow(input, exponent, output, accuracy);
+            },
+            [&std_exponent](std::complex<double> z) { return std::pow(z, std_exponent); }, uniform(3.0, 3.0), 0.0}
+    };
+
+    if (thmath::simd::get_supported_instruction_set() < thmath::simd::InstructionSet::AVX2)
+    {
+        std::printf("no AVX2: FAST mode is STRICT mode\n");
+    }
+    std::printf("%-5s %-32s %11s %11s %11s %10s %8s\n",
+        "", "range (2^20 inputs)", "std:: ns", "STRICT ns", "FAST ns", "worst ULP", "bound");
+
+    std::mt19937_64 generator(16);
+    bool exceeded = false;
+    for (const Case& test : cases)
+    {
+        std::vector<Complex> values(SIZE);
+        std::vector<std::complex<double>> std_values(SIZE);
+        for (size_t index = 0; index < SIZE; index++)
+        {
+            values[index] = test.sample(generator);
+            std_values[index] = std::complex<double>(values[index].get_real(), values[index].get_imaginary());
+        }
+        ComplexArray input(values);
+        ComplexArray strict(SIZE);
+        ComplexArray fast(SIZE);
+        std::vector<std::complex<double>> std_results(SIZE);
+
+        double element_seconds = measure([&]()
+        {
+            for (size_t index = 0; index < SIZE; index++)
+            {
+                std_results[index] = test.element(std_values[index]);
+            }
+        });
+        double strict_seconds = measure([&]()
+        {
+            test.batch(input, strict, Accuracy::STRICT);
+        });
+        double fast_seconds = measure([&]()
+        {
+            test.batch(input, fast, Accuracy::FAST);
+        });
+
+        double worst = 0.0;
+        for (size_t index = 0; index < SIZE; index++)
+        {
+            worst = std::max(worst, error_in_ulp(fast.get(index), strict.get(index)));
+        }
+        bool within = test.bound == 0.0 || worst <= test.bound;
+        exceeded = exceeded || !within;
+
+        // Room for the longest %g, and the mark.
+        char bound[sizeof("-1.23457e+308 (!)")] = "-";
+        if (test.bound != 0.0)
+        {
+            std::snprintf(bound, sizeof(bound), "%g%s", test.bound, within ? "" : " (!)");
+        }
+        const double scale = 1e9 / static_cast<double>(SIZE);
+        std::printf("%-5s %-32s %11.2f %11.2f %11.2f %10.2f %8s\n",
+            test.name, test.range,
+            element_seconds * scale, strict_seconds * scale, fast_seconds * scale, worst, bound);
+    }
+    return exceeded ? 1 : 0;
+}
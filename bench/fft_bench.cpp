@@ -0,0 +1,111 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Times the FFT plans against the naive O(n^2) DFT, to confirm the
+// O(n log n) scaling: the time per n log2 n of the FFT stays about
+// flat as n grows, while the DFT's grows linearly. Also times the real
+// transform, which should cost about half of the complex one.
+
+#include "../math/fft.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // The naive DFT is only timed up to this size.
+    const size_t LARGEST_DFT = 8192;
+
+    // Seconds per call, repeating short calls for at least 0.2 s.
+    template <typename F>
+    double measure(F transform)
+    {
+        size_t repetitions = 0;
+        double seconds = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        while (seconds < 0.2)
+        {
+            transform();
+            repetitions++;
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        return seconds / static_cast<double>(repetitions);
+    }
+}
+
+int main()
+{
+    std::mt19937_64 generator(12);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+
+    std::printf("%8s %12s %14s %12s %12s %12s %10s\n",
+        "n", "FFT us", "ns / n log n", "real FFT us", "DFT us", "speedup", "max error");
+    // Powers of two, and sizes going through Bluestein's algorithm.
+    for (size_t size : {64, 256, 1000, 1024, 4096, 4999, 8192, 65536, 1048576})
+    {
+        std::vector<thmath::Complex> input(size);
+        std::vector<double> real_input(size);
+        for (size_t index = 0; index < size; index++)
+        {
+            input[index] = thmath::Complex(distribution(generator), distribution(generator));
+            real_input[index] = distribution(generator);
+        }
+        std::shared_ptr<const thmath::FftPlan> plan = thmath::FftPlan::get(size);
+        std::vector<thmath::Complex> output(size);
+        std::vector<thmath::Complex> real_output(size / 2 + 1);
+
+        double fft_seconds = measure([&]()
+        {
+            plan->forward(input.data(), output.data());
+        });
+        double real_seconds = measure([&]()
+        {
+            plan->forward_real(real_input.data(), real_output.data());
+        });
+        double log_size = std::log2(static_cast<double>(size));
+        std::printf("%8zu %12.2f %14.3f %12.2f",
+            size, fft_seconds * 1e6, fft_seconds * 1e9 / (static_cast<double>(size) * log_size), real_seconds * 1e6);
+
+        if (size > LARGEST_DFT)
+        {
+            std::printf(" %12s %12s %10s\n", "-", "-", "-");
+            continue;
+        }
+        std::vector<thmath::Complex> expected;
+        double dft_seconds = measure([&]()
+        {
+            expected = thmath::fft::dft(input);
+        });
+        double error = 0.0;
+        for (size_t index = 0; index < size; index++)
+        {
+            error = std::max(error, (output[index] - expected[index]).norm());
+        }
+        std::printf(" %12.1f %11.1fx %10.2e\n", dft_seconds * 1e6, dft_seconds / fft_seconds, error);
+    }
+    return 0;
+}
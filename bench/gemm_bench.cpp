@@ -0,0 +1,104 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Times the cache blocked GEMM against the naive triple loop for square
+// matrices of 64 to 4096 rows (or up to the size given as argument: the
+// naive product of the largest sizes takes minutes).
+
+#include "../math/matrix.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace
+{
+    thmath::Matrix random_matrix(size_t size, std::mt19937_64& generator)
+    {
+        std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+        thmath::Matrix matrix(size, size);
+        double* entries = matrix.get_entries();
+        for (size_t index = 0; index < size * size; index++)
+        {
+            entries[index] = distribution(generator);
+        }
+        return matrix;
+    }
+
+    // Seconds per call, repeating short calls for at least 0.2 s.
+    template <typename F>
+    double measure(F product)
+    {
+        size_t repetitions = 0;
+        double seconds = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        while (seconds < 0.2)
+        {
+            product();
+            repetitions++;
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        return seconds / static_cast<double>(repetitions);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t largest = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    std::mt19937_64 generator(9);
+
+    std::printf("%6s %12s %9s %12s %9s %8s %10s\n",
+        "n", "naive ms", "GFLOP/s", "blocked ms", "GFLOP/s", "speedup", "max error");
+    for (size_t size = 64; size <= largest; size *= 2)
+    {
+        thmath::Matrix a = random_matrix(size, generator);
+        thmath::Matrix b = random_matrix(size, generator);
+        thmath::Matrix naive(size, size);
+        thmath::Matrix blocked(size, size);
+
+        double naive_seconds = measure([&]()
+        {
+            thmath::multiply_naive(a, b, naive);
+        });
+        double blocked_seconds = measure([&]()
+        {
+            thmath::multiply(a, b, blocked);
+        });
+
+        double error = 0.0;
+        for (size_t index = 0; index < size * size; index++)
+        {
+            error = std::max(error, std::abs(naive.get_entries()[index] - blocked.get_entries()[index]));
+        }
+        double flops = 2.0 * static_cast<double>(size) * static_cast<double>(size) * static_cast<double>(size);
+        std::printf("%6zu %12.2f %9.2f %12.2f %9.2f %7.1fx %10.2e\n",
+            size,
+            naive_seconds * 1e3, flops / naive_seconds * 1e-9,
+            blocked_seconds * 1e3, flops / blocked_seconds * 1e-9,
+            naive_seconds / blocked_seconds, error);
+    }
+    return 0;
+}
@@ -0,0 +1,228 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Times building, copying and measuring distances with Line, which
+// holds its points inline, against the layout it replaced: a point
+// and a direction in two heap-allocated Vectors, each owning another
+// heap buffer. Both give the same distances.
+
+#include "../math/line.h"
+#include "../math/vector.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    const size_t LINES = 200000;
+
+    // The former Line, reduced to what is timed here.
+    class HeapLine
+    {
+    private:
+        thmath::Vector* position_a;
+        thmath::Vector* direction;
+
+    public:
+        HeapLine(const thmath::Vector& point_a, const thmath::Vector& point_b)
+        {
+            this->position_a = new thmath::Vector(point_a);
+            this->direction = new thmath::Vector(point_b - point_a);
+        }
+
+        HeapLine(const HeapLine& other)
+        {
+            this->position_a = new thmath::Vector(*other.position_a);
+            this->direction = new thmath::Vector(*other.direction);
+        }
+
+        HeapLine& operator=(const HeapLine& other)
+        {
+            *this->position_a = *other.position_a;
+            *this->direction = *other.direction;
+            return *this;
+        }
+
+        ~HeapLine()
+        {
+            delete this->position_a;
+            delete this->direction;
+        }
+
+        double distance(const thmath::Vector& point) const
+        {
+            thmath::Vector diff = point - *this->position_a;
+            diff = diff.vector_product(*this->direction);
+            return (diff *= (1 / this->direction->norm())).norm();
+        }
+    };
+
+    // Seconds per line, repeating the loop for at least 0.2 s.
+    template <typename F>
+    double measure(F loop)
+    {
+        size_t repetitions = 0;
+        double seconds = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        while (seconds < 0.2)
+        {
+            loop();
+            repetitions++;
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        return seconds / static_cast<double>(repetitions * LINES);
+    }
+
+    void print(const char* operation, double heap_seconds, double inline_seconds)
+    {
+        std::printf("%-28s %10.1f %10.1f %9.1fx\n", operation, heap_seconds * 1e9, inline_seconds * 1e9, heap_seconds / inline_seconds);
+    }
+}
+
+int main()
+{
+    std::mt19937_64 generator(19);
+    std::uniform_real_distribution<double> coordinate(-1.0, 1.0);
+    std::vector<thmath::Vector> points_a;
+    std::vector<thmath::Vector> points_b;
+    std::vector<thmath::Vector> queries;
+    std::vector<thmath::Vec3> query_points;
+    points_a.reserve(LINES);
+    points_b.reserve(LINES);
+    queries.reserve(LINES);
+    query_points.reserve(LINES);
+    for (size_t index = 0; index < LINES; index++)
+    {
+        points_a.push_back(thmath::Vector{coordinate(generator), coordinate(generator), coordinate(generator)});
+        points_b.push_back(thmath::Vector{coordinate(generator), coordinate(generator), coordinate(generator)});
+        thmath::Vec3 query(coordinate(generator), coordinate(generator), coordinate(generator));
+        query_points.push_back(query);
+        queries.push_back(thmath::Vector{query[0], query[1], query[2]});
+    }
+
+    std::vector<HeapLine> heap_lines;
+    std::vector<thmath::Line> lines;
+    heap_lines.reserve(LINES);
+    lines.reserve(LINES);
+    for (size_t index = 0; index < LINES; index++)
+    {
+        heap_lines.emplace_back(points_a[index], points_b[index]);
+        lines.emplace_back(points_a[index], points_b[index]);
+    }
+
+    size_t mismatches = 0;
+    for (size_t index = 0; index < LINES; index++)
+    {
+        double expected = heap_lines[index].distance(queries[index]);
+        double error = std::fabs(lines[index].distance(queries[index]) - expected);
+        if (error > 1e-14 * (1.0 + expected) || lines[index].distance(query_points[index]) != lines[index].distance(queries[index]))
+        {
+            mismatches++;
+        }
+    }
+
+    std::printf("%zu lines, %zu and %zu bytes per line (plus the heap)\n\n", LINES, sizeof(HeapLine), sizeof(thmath::Line));
+    std::printf("%-28s %10s %10s %10s\n", "ns per line", "heap", "inline", "speedup");
+
+    std::vector<HeapLine> heap_built;
+    std::vector<thmath::Line> built;
+    double heap_seconds = measure([&]()
+    {
+        heap_built.clear();
+        heap_built.reserve(LINES);
+        for (size_t index = 0; index < LINES; index++)
+        {
+            heap_built.emplace_back(points_a[index], points_b[index]);
+        }
+    });
+    double inline_seconds = measure([&]()
+    {
+        built.clear();
+        built.reserve(LINES);
+        for (size_t index = 0; index < LINES; index++)
+        {
+            built.emplace_back(points_a[index], points_b[index]);
+        }
+    });
+    print("construct from Vectors", heap_seconds, inline_seconds);
+
+    heap_seconds = measure([&]()
+    {
+        std::vector<HeapLine> copy(heap_lines);
+        heap_built.swap(copy);
+    });
+    inline_seconds = measure([&]()
+    {
+        std::vector<thmath::Line> copy(lines);
+        built.swap(copy);
+    });
+    print("copy", heap_seconds, inline_seconds);
+
+    heap_seconds = measure([&]()
+    {
+        for (size_t index = 0; index < LINES; index++)
+        {
+            heap_built[index] = heap_lines[LINES - 1 - index];
+        }
+    });
+    inline_seconds = measure([&]()
+    {
+        for (size_t index = 0; index < LINES; index++)
+        {
+            built[index] = lines[LINES - 1 - index];
+        }
+    });
+    print("copy-assign", heap_seconds, inline_seconds);
+
+    double heap_sum = 0.0;
+    double inline_sum = 0.0;
+    heap_seconds = measure([&]()
+    {
+        for (size_t index = 0; index < LINES; index++)
+        {
+            heap_sum += heap_lines[index].distance(queries[index]);
+        }
+    });
+    inline_seconds = measure([&]()
+    {
+        for (size_t index = 0; index < LINES; index++)
+        {
+            inline_sum += lines[index].distance(queries[index]);
+        }
+    });
+    print("distance to a Vector", heap_seconds, inline_seconds);
+
+    inline_seconds = measure([&]()
+    {
+        for (size_t index = 0; index < LINES; index++)
+        {
+            inline_sum += lines[index].distance(query_points[index]);
+        }
+    });
+    print("distance to a Vec3", heap_seconds, inline_seconds);
+
+    std::printf("\n%zu mismatches (checksum %g)\n", mismatches, heap_sum + inline_sum);
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Times the nearest-line and radius queries of LineIndex against the
+// brute-force loop over Line::distance, on 10^6 short segments spread
+// over the unit cube, and checks that both give the same answers.
+
+#include "../math/line_index.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+    const size_t LINES = 1000000;
+    // Brute-force queries are slow: only a few are timed.
+    const size_t BRUTE_FORCE_QUERIES = 50;
+    const size_t QUERIES = 20000;
+    const double RADIUS = 0.02;
+
+    double seconds_since(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    thmath::Vec3 point(const thmath::VectorBatch& points, size_t index)
+    {
+        return thmath::Vec3(points.get_x()[index], points.get_y()[index], points.get_z()[index]);
+    }
+}
+
+int main()
+{
+    std::mt19937_64 generator(21);
+    std::uniform_real_distribution<double> coordinate(0.0, 1.0);
+    std::uniform_real_distribution<double> offset(-0.01, 0.01);
+
+    std::vector<thmath::Line> lines;
+    lines.reserve(LINES);
+    for (size_t index = 0; index < LINES; index++)
+    {
+        thmath::Vec3 start(coordinate(generator), coordinate(generator), coordinate(generator));
+        lines.emplace_back(start, start + thmath::Vec3(offset(generator), offset(generator), offset(generator)));
+    }
+    // Queries also around the cube, where little can be pruned.
+    thmath::VectorBatch points(QUERIES);
+    for (size_t index = 0; index < QUERIES; index++)
+    {
+        points.get_x()[index] = coordinate(generator) * 1.2 - 0.1;
+        points.get_y()[index] = coordinate(generator) * 1.2 - 0.1;
+        points.get_z()[index] = coordinate(generator) * 1.2 - 0.1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    thmath::LineIndex index(lines);
+    std::printf("%zu segments, built in %.0f ms\n\n", LINES, seconds_since(start) * 1e3);
+
+    // Nearest line.
+    std::vector<thmath::LineHit> expected(BRUTE_FORCE_QUERIES);
+    start = std::chrono::steady_clock::now();
+    for (size_t query = 0; query < BRUTE_FORCE_QUERIES; query++)
+    {
+        thmath::Vec3 p = point(points, query);
+        thmath::LineHit best = {0, std::numeric_limits<double>::infinity()};
+        for (size_t line = 0; line < LINES; line++)
+        {
+            double distance = lines[line].distance(p, 0.0, 1.0);
+            if (distance < best.distance)
+            {
+                best = {line, distance};
+            }
+        }
+        expected[query] = best;
+    }
+    double brute_force = seconds_since(start) / BRUTE_FORCE_QUERIES;
+
+    start = std::chrono::steady_clock::now();
+    size_t mismatches = 0;
+    for (size_t query = 0; query < QUERIES; query++)
+    {
+        thmath::LineHit hit = index.nearest(point(points, query));
+        if (query < BRUTE_FORCE_QUERIES && hit.distance != expected[query].distance)
+        {
+            mismatches++;
+        }
+    }
+    double single = seconds_since(start) / QUERIES;
+
+    std::vector<thmath::LineHit> hits(QUERIES);
+    start = std::chrono::steady_clock::now();
+    index.nearest(points, hits.data());
+    double batched = seconds_since(start) / QUERIES;
+
+    std::printf("nearest line         %12s %12s %12s\n", "brute force", "single", "batched");
+    std::printf("  us per query       %12.1f %12.2f %12.2f   (%.0fx, %zu mismatches)\n\n",
+        brute_force * 1e6, single * 1e6, batched * 1e6, brute_force / single, mismatches);
+
+    // All the lines within a radius.
+    std::vector<size_t> expected_counts(BRUTE_FORCE_QUERIES, 0);
+    start = std::chrono::steady_clock::now();
+    for (size_t query = 0; query < BRUTE_FORCE_QUERIES; query++)
+    {
+        thmath::Vec3 p = point(points, query);
+        for (size_t line = 0; line < LINES; line++)
+        {
+            if (lines[line].distance(p, 0.0, 1.0) <= RADIUS)
+            {
+                expected_counts[query]++;
+            }
+        }
+    }
+    brute_force = seconds_since(start) / BRUTE_FORCE_QUERIES;
+
+    std::vector<std::vector<thmath::LineHit>> found;
+    start = std::chrono::steady_clock::now();
+    index.within(points, RADIUS, found);
+    batched = seconds_since(start) / QUERIES;
+    size_t total = 0;
+    mismatches = 0;
+    for (size_t query = 0; query < QUERIES; query++)
+    {
+        total += found[query].size();
+        if (query < BRUTE_FORCE_QUERIES && found[query].size() != expected_counts[query])
+        {
+            mismatches++;
+        }
+    }
+    std::printf("within %.2f          %12s %12s\n", RADIUS, "brute force", "batched");
+    std::printf("  us per query       %12.1f %12.2f   (%.0fx, %.1f hits on average, %zu mismatches)\n\n",
+        brute_force * 1e6, batched * 1e6, brute_force / batched,
+        static_cast<double>(total) / QUERIES, mismatches);
+
+    // The loop the index replaces, over the infinite lines.
+    thmath::Vector p = {0.5, 0.5, 0.5};
+    double sink = 0.0;
+    start = std::chrono::steady_clock::now();
+    for (size_t query = 0; query < BRUTE_FORCE_QUERIES; query++)
+    {
+        for (size_t line = 0; line < LINES; line++)
+        {
+            sink += lines[line].distance(p);
+        }
+    }
+    std::printf("brute force over Line::distance(const Vector&): %.1f us per query (%g)\n",
+        seconds_since(start) / BRUTE_FORCE_QUERIES * 1e6, sink);
+    return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Compares the memory use and matrix-vector product throughput of CSR
+// storage with dense storage, for random matrices with about 10
+// non-zeros per row (under 1% non-zeros), and the parallel SpMV with
+// the sequential one. Dense storage is only timed up to 4000 rows; the
+// larger sizes are past the parallel threshold (65536 non-zeros).
+
+#include "../math/matrix.h"
+#include "../math/sparse.h"
+#include "../math/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+    const size_t NON_ZEROS_PER_ROW = 10;
+    const size_t LARGEST_DENSE = 4000;
+
+    // Seconds per call, repeating short calls for at least 0.2 s.
+    template <typename F>
+    double measure(F product)
+    {
+        size_t repetitions = 0;
+        double seconds = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        while (seconds < 0.2)
+        {
+            product();
+            repetitions++;
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        return seconds / static_cast<double>(repetitions);
+    }
+
+    double max_difference(const thmath::Vector& a, const thmath::Vector& b)
+    {
+        double difference = 0.0;
+        for (size_t index = 0; index < a.get_size(); index++)
+        {
+            difference = std::max(difference, std::abs(a.get_entries()[index] - b.get_entries()[index]));
+        }
+        return difference;
+    }
+}
+
+int main()
+{
+    std::mt19937_64 generator(11);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+
+    std::printf("%zu thread(s), parallel threshold %zu non-zeros\n",
+        thmath::ThreadPool::get_instance().get_thread_count(), thmath::execution::get_parallel_threshold());
+    std::printf("%8s %9s %9s %10s %10s %11s %11s %8s %10s\n",
+        "n", "nnz", "CSR MiB", "dense MiB", "dense ms", "CSR seq ms", "CSR par ms", "speedup", "max error");
+    for (size_t size : {1000, 2000, 4000, 16000, 100000, 1000000})
+    {
+        std::uniform_int_distribution<size_t> column(0, size - 1);
+        thmath::CooMatrix triplets(size, size);
+        triplets.reserve(size * NON_ZEROS_PER_ROW);
+        for (size_t row = 0; row < size; row++)
+        {
+            for (size_t k = 0; k < NON_ZEROS_PER_ROW; k++)
+            {
+                triplets.add(row, column(generator), distribution(generator));
+            }
+        }
+        thmath::CsrMatrix sparse(triplets);
+
+        std::vector<double> values(size);
+        for (double& value : values)
+        {
+            value = distribution(generator);
+        }
+        thmath::Vector x(size, values.data());
+        thmath::Vector sequential_result(size, values.data());
+        thmath::Vector parallel_result(size, values.data());
+
+        double sequential_seconds = measure([&]()
+        {
+            sparse.multiply(x, sequential_result, thmath::execution::seq);
+        });
+        double parallel_seconds = measure([&]()
+        {
+            sparse.multiply(x, parallel_result, thmath::execution::par);
+        });
+        double error = max_difference(sequential_result, parallel_result);
+
+        double csr_bytes = static_cast<double>(
+            sparse.get_values().size() * sizeof(double)
+            + sparse.get_col_indices().size() * sizeof(size_t)
+            + sparse.get_row_offsets().size() * sizeof(size_t)
+        );
+        double dense_bytes = static_cast<double>(size) * static_cast<double>(size) * sizeof(double);
+        std::printf("%8zu %9zu %9.3f %10.1f ", size, sparse.get_non_zeros(), csr_bytes / 1048576.0, dense_bytes / 1048576.0);
+        if (size <= LARGEST_DENSE)
+        {
+            thmath::Matrix dense = sparse.to_matrix();
+            thmath::Vector dense_result(size, values.data());
+            double dense_seconds = measure([&]()
+            {
+                dense_result = dense * x;
+            });
+            error = std::max(error, max_difference(dense_result, sequential_result));
+            std::printf("%10.3f ", dense_seconds * 1e3);
+        }
+        else
+        {
+            std::printf("%10s ", "-");
+        }
+        std::printf("%11.4f %11.4f %7.2fx %10.2e\n",
+            sequential_seconds * 1e3, parallel_seconds * 1e3, sequential_seconds / parallel_seconds, error);
+    }
+    return 0;
+}
@@ -0,0 +1,179 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Counts the heap allocations (and times) of vector expressions, against
+// the copying operators they replaced: every operator allocated a
+// buffer, computed into it and copied it into a new Vector.
+
+#include "../math/vector.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace
+{
+    size_t allocations = 0;
+    double sink = 0.0;
+
+    thmath::Vector copying_sum(const thmath::Vector& a, const thmath::Vector& b)
+    {
+        const size_t size = a.get_size();
+        double* entries = new double[size];
+        for (size_t index = 0; index < size; index++)
+        {
+            entries[index] = a.get_entries()[index] + b.get_entries()[index];
+        }
+        thmath::Vector result(size, entries);
+        // The replaced operators leaked this buffer.
+        delete[] entries;
+        return result;
+    }
+
+    thmath::Vector copying_product(const thmath::Vector& a, double lambda)
+    {
+        const size_t size = a.get_size();
+        double* entries = new double[size];
+        for (size_t index = 0; index < size; index++)
+        {
+            entries[index] = a.get_entries()[index] * lambda;
+        }
+        thmath::Vector result(size, entries);
+        delete[] entries;
+        return result;
+    }
+
+    // Run an expression repeatedly, and report its allocations and
+    // time per evaluation.
+    template <typename F>
+    void measure(const char* name, size_t size, F expression)
+    {
+        const size_t before = allocations;
+        expression();
+        const size_t count = allocations - before;
+
+        size_t repetitions = 1;
+        double seconds = 0.0;
+        while (seconds < 0.05)
+        {
+            repetitions *= 2;
+            auto start = std::chrono::steady_clock::now();
+            for (size_t r = 0; r < repetitions; r++)
+            {
+                expression();
+            }
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        std::printf("%-28s n = %-5zu %zu allocation(s), %10.1f ns\n",
+            name, size, count, seconds * 1e9 / static_cast<double>(repetitions));
+    }
+}
+
+void* operator new(size_t size)
+{
+    allocations++;
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+// The memory resources allocate with an explicit alignment.
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    allocations++;
+    size_t align = static_cast<size_t>(alignment);
+    if (void* pointer = std::aligned_alloc(align, (size + align - 1) / align * align))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+int main()
+{
+    const double s = 0.5;
+    for (size_t size : {3, 64, 4096})
+    {
+        std::vector<double> values(size);
+        for (size_t index = 0; index < size; index++)
+        {
+            values[index] = static_cast<double>(index % 17) - 8.0;
+        }
+        thmath::Vector a(size, values.data());
+        thmath::Vector b(a * 2.0);
+        thmath::Vector c(a - b);
+        thmath::Vector r(size, values.data());
+
+        measure("copying a + b * s", size, [&]()
+        {
+            thmath::Vector result = copying_sum(a, copying_product(b, s));
+            sink += result.get_entries()[0];
+        });
+        measure("Vector r = a + b * s", size, [&]()
+        {
+            thmath::Vector result = a + b * s;
+            sink += result.get_entries()[0];
+        });
+        measure("Vector r = a + b - c * s", size, [&]()
+        {
+            thmath::Vector result = a + b - c * s;
+            sink += result.get_entries()[0];
+        });
+        measure("r = a + b * s", size, [&]()
+        {
+            r = a + b * s;
+            sink += r.get_entries()[0];
+        });
+        measure("r.axpby(1, a, s)", size, [&]()
+        {
+            r.axpby(1.0, a, s);
+            sink += r.get_entries()[0];
+        });
+    }
+    std::printf("(%g)\n", sink);
+    return 0;
+}
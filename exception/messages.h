@@ -26,8 +26,11 @@
 
 #pragma once
 
-constexpr char* ILLEGAL_ACCESS_MESSAGE = "Attempted to perform an access into a non-existant component of the vector - check the index again.";
-constexpr char* DIFFERENT_SIZE_MESSAGE = "Attempted to perform an operation on objects of different sizes - since they do not belong to the same set, the operation is undefined.";
-constexpr char* ILLEGAL_SIZE_MESSAGE = "Attempted to perform an operation with objects of the wrong size (either a cross product or a wrong matrix multiplication).";
+constexpr const char* ILLEGAL_ACCESS_MESSAGE = "Attempted to perform an access into a non-existant component of the vector - check the index again.";
+constexpr const char* DIFFERENT_SIZE_MESSAGE = "Attempted to perform an operation on objects of different sizes - since they do not belong to the same set, the operation is undefined.";
+constexpr const char* ILLEGAL_SIZE_MESSAGE = "Attempted to perform an operation with objects of the wrong size (either a cross product or a wrong matrix multiplication).";
+constexpr const char* FILE_ACCESS_MESSAGE = "Could not open, map or write the file - check the path, the permissions and the free space.";
+constexpr const char* DATASET_FORMAT_MESSAGE = "The file is not a dataset of a supported version, type and byte order, or it is truncated.";
+constexpr const char* DATASET_CHECKSUM_MESSAGE = "The entries of the dataset do not match its checksum - the file is corrupted.";
 
 #endif
\ No newline at end of file
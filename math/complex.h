@@ -21,16 +21,29 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+
 #pragma once
 
 #ifndef __THMATH_COMPLEX_
 #define __THMATH_COMPLEX_
 
-#include <algorithm>
+#include "../exception/illegal_size_exception.h"
+#include "../exception/messages.h"
+#include <cmath>
+#include <initializer_list>
+#include <sstream>
 #include <string>
+#include <type_traits>
 
 namespace thmath
 {
+    /**
+     * Complex number, defined entirely in this header: every
+     * operation can be inlined, and the arithmetic is constexpr.
+     * Copies are left to the compiler, so the type is trivially
+     * copyable (two doubles) and may be memcpy'd, e.g. into the
+     * buffers of ComplexArray or of the FFT.
+    */
     class Complex
     {
     private:
@@ -38,6 +51,16 @@ namespace thmath
         double imaginary;
 
     public:
+        /**
+         * Zero constructor for the Complex class.
+         * 
+         * @return The complex number 0.
+        */
+        constexpr Complex() : real(0.0), imaginary(0.0)
+        {
+
+        }
+
         /**
          * Default constructor for the Complex class.
          * 
@@ -45,7 +68,10 @@ namespace thmath
          * @param imaginary The imaginary part of the complex number.
          * @return A new complex number object.
         */
-        Complex(double real, double imaginary);
+        constexpr Complex(double real, double imaginary) : real(real), imaginary(imaginary)
+        {
+
+        }
         
         /**
          * Initializer list constructor for the Complex class.
@@ -55,56 +81,67 @@ namespace thmath
          * @param args The initializer list containing the real and imaginary parts.
          * @return A new complex number object.
         */
-        Complex(std::initializer_list<double> args);
-
-        /**
-         * Copy constructor for the complex class.
-         * 
-         * @param other The complex number which will be
-         * copied into this one.
-         * @return A new complex number object.
-        */
-        Complex(const Complex& other);
-
-        /**
-         * Destructor for the Complex class.
-        */
-        ~Complex();
+        constexpr Complex(std::initializer_list<double> args) : real(0.0), imaginary(0.0)
+        {
+            if (args.size() != 2)
+            {
+                throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+            }
+            this->real = *args.begin();
+            this->imaginary = *(args.begin() + 1);
+        }
 
         /**
          * Get the real part of the complex number.
          * 
          * @return The real part of the complex number.
         */
-        double get_real() const;
+        constexpr double get_real() const
+        {
+            return this->real;
+        }
 
         /**
          * Get the imaginary part of the complex number.
          * 
          * @return The imaginary part of the complex number.
         */
-        double get_imaginary() const;
+        constexpr double get_imaginary() const
+        {
+            return this->imaginary;
+        }
 
         /**
          * Calculate the norm (magnitude) of the complex number.
          * 
          * @return The norm of the complex number.
         */
-        double norm() const;
+        double norm() const
+        {
+            return std::sqrt(this->real * this->real + this->imaginary * this->imaginary);
+        }
 
         /**
-         * Calculate the argument (angle) of the complex number.
+         * Calculate the argument (angle) of the complex number,
+         * in (-pi, pi], with the quadrant taken from the signs
+         * of both parts (as atan2 does).
          * 
          * @return The argument of the complex number.
         */
-        double argument() const;
+        double argument() const
+        {
+            return std::atan2(this->imaginary, this->real);
+        }
 
         /**
          * Calculate the conjugate of the complex number.
          * 
          * @return The conjugate of the complex number.
         */
-        Complex conjugate() const;
+        constexpr Complex conjugate() const
+        {
+            return Complex(this->real, -this->imaginary);
+        }
 
         /**
          * Overloaded equality operator for comparing two complex numbers.
@@ -112,16 +149,15 @@ namespace thmath
          * @param complex The complex number to compare with.
          * @return True if the complex numbers are equal, false otherwise.
         */
-        bool operator==(const Complex& complex) const;
+        constexpr bool operator==(const Complex& complex) const
+        {
+            return (this->real == complex.real) && (this->imaginary == complex.imaginary);
+        }
 
-        /**
-         * Overloaded assignment operator for complex numbers.
-         * 
-         * @param other The complex numbers which shall be
-         * assigned to this one.
-         * @return A new complex number object.
-        */
-        Complex& operator=(const Complex& other);
+        constexpr bool operator!=(const Complex& complex) const
+        {
+            return !(*this == complex);
+        }
 
         /**
          * Overloaded addition operator for adding two complex numbers.
@@ -129,7 +165,10 @@ namespace thmath
          * @param complex The complex number to add.
          * @return The result of the addition operation.
         */
-        Complex operator+(const Complex& complex) const;
+        constexpr Complex operator+(const Complex& complex) const
+        {
+            return Complex(this->real + complex.real, this->imaginary + complex.imaginary);
+        }
 
         /**
          * Overloaded compound addition operator for adding two complex numbers.
@@ -137,7 +176,12 @@ namespace thmath
          * @param complex The complex number to add.
          * @return The result of the addition operation.
         */
-        Complex& operator+=(const Complex& complex);
+        constexpr Complex& operator+=(const Complex& complex)
+        {
+            this->real += complex.real;
+            this->imaginary += complex.imaginary;
+            return *this;
+        }
 
         /**
          * Overloaded subtraction operator for subtracting two complex numbers.
@@ -145,7 +189,10 @@ namespace thmath
          * @param complex The complex number to subtract.
          * @return The result of the subtraction operation.
         */
-        Complex operator-(const Complex& complex) const;
+        constexpr Complex operator-(const Complex& complex) const
+        {
+            return Complex(this->real - complex.real, this->imaginary - complex.imaginary);
+        }
 
         /**
          * Overloaded compound subtraction operator for subtracting two complex numbers.
@@ -153,7 +200,12 @@ namespace thmath
          * @param complex The complex number to subtract.
          * @return The result of the subtraction operation.
         */
-        Complex& operator-=(const Complex& complex);
+        constexpr Complex& operator-=(const Complex& complex)
+        {
+            this->real -= complex.real;
+            this->imaginary -= complex.imaginary;
+            return *this;
+        }
 
         /**
          * Overloaded multiplication operator for multiplying two complex numbers.
@@ -161,7 +213,13 @@ namespace thmath
          * @param complex The complex number to multiply.
          * @return The result of the multiplication operation.
         */
-        Complex operator*(const Complex& complex) const;
+        constexpr Complex operator*(const Complex& complex) const
+        {
+            return Complex(
+                this->real * complex.real - this->imaginary * complex.imaginary,
+                this->real * complex.imaginary + this->imaginary * complex.real
+            );
+        }
 
         /**
          * Overloaded compound multiplication operator for multiplying two complex numbers.
@@ -169,16 +227,101 @@ namespace thmath
          * @param complex The complex number to multiply.
          * @return The result of the multiplication operation.
         */
-        Complex& operator*=(const Complex& complex);
+        constexpr Complex& operator*=(const Complex& complex)
+        {
+            return *this = *this * complex;
+        }
 
         /**
          * Raises a complex number to another complex number.
+         * Exponents with a null imaginary part take the real
+         * (and, for whole numbers, integer) paths below; only
+         * genuinely complex exponents go through log and exp.
          * 
          * @param complex The number which is used as the exponent
          * to our current base.
          * @return The result of the exponentiation.
         */
-        Complex operator^(const Complex& complex) const;
+        Complex operator^(const Complex& complex) const
+        {
+            if (complex.imaginary == 0.0)
+            {
+                return *this ^ complex.real;
+            }
+            double a = complex.real;
+            double b = complex.imaginary;
+            double arg = argument();
+            double log = std::log(norm());
+
+            double new_norm = std::exp(a * log - b * arg);
+            double theta = a * arg + b * log;
+
+            return Complex(new_norm * std::cos(theta), new_norm * std::sin(theta));
+        }
+
+        /**
+         * Raises a complex number to a real power, in polar form:
+         * |z|^p * e^(i p arg(z)), i.e. one pow, one atan2 and one
+         * sincos. Whole exponents (up to 2^31 in magnitude) use the
+         * integer path instead.
+         * 
+         * @param exponent The real exponent.
+         * @return The result of the exponentiation.
+        */
+        Complex operator^(double exponent) const
+        {
+            if (exponent == std::trunc(exponent) && std::abs(exponent) <= 2147483648.0)
+            {
+                return *this ^ static_cast<long long>(exponent);
+            }
+            double new_norm = std::pow(norm(), exponent);
+            double theta = exponent * argument();
+            return Complex(new_norm * std::cos(theta), new_norm * std::sin(theta));
+        }
+
+        /**
+         * Raises a complex number to an integer power by binary
+         * exponentiation, i.e. with about 2 log2(n) complex
+         * multiplications and no transcendental function; negative
+         * powers take one final reciprocal.
+         * 
+         * @param exponent The integer exponent.
+         * @return The result of the exponentiation.
+        */
+        template <typename I, typename std::enable_if<std::is_integral<I>::value, int>::type = 0>
+        constexpr Complex operator^(I exponent) const
+        {
+            bool negative = exponent < 0;
+            unsigned long long remaining = negative
+                ? 0ull - static_cast<unsigned long long>(exponent)
+                : static_cast<unsigned long long>(exponent);
+            Complex result(1.0, 0.0);
+            Complex base = *this;
+            while (remaining > 0)
+            {
+                if (remaining & 1ull)
+                {
+                    result *= base;
+                }
+                remaining >>= 1;
+                if (remaining > 0)
+                {
+                    base *= base;
+                }
+            }
+            return negative ? result.reciprocal() : result;
+        }
+
+        /**
+         * Calculate the multiplicative inverse, 1 / z.
+         * 
+         * @return The reciprocal of the complex number.
+        */
+        constexpr Complex reciprocal() const
+        {
+            double square = this->real * this->real + this->imaginary * this->imaginary;
+            return Complex(this->real / square, -this->imaginary / square);
+        }
         
         /**
          * Stringify the complex number object for it to be
@@ -187,8 +330,15 @@ namespace thmath
          * 
          * @return The stringified version of the complex number.
         */
-        std::string to_string() const;
+        std::string to_string() const
+        {
+            std::ostringstream stream;
+            stream << "Complex={real=" << this->real << ", imaginary=" << this->imaginary << "}";
+            return stream.str();
+        }
     };
+
+    static_assert(std::is_trivially_copyable<Complex>::value, "Complex must stay trivially copyable.");
 }
 
 #endif
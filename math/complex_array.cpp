@@ -0,0 +1,431 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "complex_array.h"
+#include "simd.h"
+#include "simd_math.h"
+#include "../exception/illegal_access_exception.h"
+#include "../exception/different_size_exception.h"
+#include "../exception/messages.h"
+#include <cmath>
+#include <string>
+
+namespace
+{
+    using thmath::simd::InstructionSet;
+
+    bool use_avx2()
+    {
+#ifdef THMATH_SIMD_X86
+        InstructionSet instruction_set = thmath::simd::get_instruction_set();
+        return instruction_set == InstructionSet::AVX2 || instruction_set == InstructionSet::AVX512;
+#else
+        return false;
+#endif
+    }
+
+    // Element-wise (ar, ai) *= (br, bi), or *= conj(br, bi), over
+    // arrays with a stride of 1 (split) or 2 (interleaved). Both
+    // operands are read before anything is stored, so b may be a.
+    void multiply_scalar(double* ar, double* ai, const double* br, const double* bi, size_t size, size_t stride, bool conjugate)
+    {
+        double sign = conjugate ? -1.0 : 1.0;
+        for (size_t index = 0; index < size * stride; index += stride)
+        {
+            double real = ar[index];
+            double imaginary = ai[index];
+            double b_real = br[index];
+            double b_imaginary = sign * bi[index];
+            ar[index] = real * b_real - imaginary * b_imaginary;
+            ai[index] = real * b_imaginary + imaginary * b_real;
+        }
+    }
+
+    void norm_scalar(const double* re, const double* im, double* result, size_t size, size_t stride)
+    {
+        for (size_t index = 0; index < size; index++)
+        {
+            double real = re[index * stride];
+            double imaginary = im[index * stride];
+            result[index] = std::sqrt(real * real + imaginary * imaginary);
+        }
+    }
+
+    void argument_scalar(const double* re, const double* im, double* result, size_t size, size_t stride)
+    {
+        for (size_t index = 0; index < size; index++)
+        {
+            result[index] = std::atan2(im[index * stride], re[index * stride]);
+        }
+    }
+
+#ifdef THMATH_SIMD_X86
+    __attribute__((target("avx2,fma")))
+    void multiply_split_avx2(double* ar, double* ai, const double* br, const double* bi, size_t size, bool conjugate)
+    {
+        __m256d sign = _mm256_set1_pd(conjugate ? -1.0 : 1.0);
+        size_t index = 0;
+        for (; index + 4 <= size; index += 4)
+        {
+            __m256d real = _mm256_loadu_pd(ar + index);
+            __m256d imaginary = _mm256_loadu_pd(ai + index);
+            __m256d b_real = _mm256_loadu_pd(br + index);
+            __m256d b_imaginary = _mm256_mul_pd(sign, _mm256_loadu_pd(bi + index));
+            _mm256_storeu_pd(ar + index, _mm256_fmsub_pd(real, b_real, _mm256_mul_pd(imaginary, b_imaginary)));
+            _mm256_storeu_pd(ai + index, _mm256_fmadd_pd(real, b_imaginary, _mm256_mul_pd(imaginary, b_real)));
+        }
+        multiply_scalar(ar + index, ai + index, br + index, bi + index, size - index, 1, conjugate);
+    }
+
+    __attribute__((target("avx2,fma")))
+    void multiply_interleaved_avx2(double* a, const double* b, size_t size, bool conjugate)
+    {
+        // Two complex numbers per register: [re0 im0 re1 im1].
+        size_t index = 0;
+        for (; index + 2 <= size; index += 2)
+        {
+            __m256d x = _mm256_loadu_pd(a + 2 * index);
+            __m256d y = _mm256_loadu_pd(b + 2 * index);
+            __m256d y_real = _mm256_movedup_pd(y);
+            __m256d y_imaginary = _mm256_permute_pd(y, 0xF);
+            __m256d x_swapped = _mm256_permute_pd(x, 0x5);
+            __m256d cross = _mm256_mul_pd(x_swapped, y_imaginary);
+            __m256d product = conjugate
+                ? _mm256_fmsubadd_pd(x, y_real, cross)
+                : _mm256_fmaddsub_pd(x, y_real, cross);
+            _mm256_storeu_pd(a + 2 * index, product);
+        }
+        multiply_scalar(a + 2 * index, a + 2 * index + 1, b + 2 * index, b + 2 * index + 1, size - index, 2, conjugate);
+    }
+
+    __attribute__((target("avx2,fma")))
+    void norm_split_avx2(const double* re, const double* im, double* result, size_t size)
+    {
+        size_t index = 0;
+        for (; index + 4 <= size; index += 4)
+        {
+            __m256d real = _mm256_loadu_pd(re + index);
+            __m256d imaginary = _mm256_loadu_pd(im + index);
+            __m256d square = _mm256_fmadd_pd(real, real, _mm256_mul_pd(imaginary, imaginary));
+            _mm256_storeu_pd(result + index, _mm256_sqrt_pd(square));
+        }
+        norm_scalar(re + index, im + index, result + index, size - index, 1);
+    }
+
+    __attribute__((target("avx2,fma")))
+    void norm_interleaved_avx2(const double* a, double* result, size_t size)
+    {
+        size_t index = 0;
+        for (; index + 4 <= size; index += 4)
+        {
+            __m256d first = _mm256_loadu_pd(a + 2 * index);
+            __m256d second = _mm256_loadu_pd(a + 2 * index + 4);
+            // [|z0|^2 |z2|^2 |z1|^2 |z3|^2], then put back in order.
+            __m256d square = _mm256_hadd_pd(_mm256_mul_pd(first, first), _mm256_mul_pd(second, second));
+            square = _mm256_permute4x64_pd(square, 0xD8);
+            _mm256_storeu_pd(result + index, _mm256_sqrt_pd(square));
+        }
+        norm_scalar(a + 2 * index, a + 2 * index + 1, result + index, size - index, 2);
+    }
+
+    __attribute__((target("avx2,fma")))
+    void argument_avx2(const double* re, const double* im, double* result, size_t size, size_t stride)
+    {
+        const __m256d infinity = _mm256_set1_pd(INFINITY);
+        const __m256d sign_mask = _mm256_set1_pd(-0.0);
+        size_t index = 0;
+        for (; index + 4 <= size; index += 4)
+        {
+            __m256d x;
+            __m256d y;
+            if (stride == 1)
+            {
+                x = _mm256_loadu_pd(re + index);
+                y = _mm256_loadu_pd(im + index);
+            }
+            else
+            {
+                __m256d first = _mm256_loadu_pd(re + 2 * index);
+                __m256d second = _mm256_loadu_pd(re + 2 * index + 4);
+                x = _mm256_permute4x64_pd(_mm256_unpacklo_pd(first, second), 0xD8);
+                y = _mm256_permute4x64_pd(_mm256_unpackhi_pd(first, second), 0xD8);
+            }
+            __m256d finite = _mm256_and_pd(
+                _mm256_cmp_pd(_mm256_andnot_pd(sign_mask, x), infinity, _CMP_LT_OQ),
+                _mm256_cmp_pd(_mm256_andnot_pd(sign_mask, y), infinity, _CMP_LT_OQ)
+            );
+            if (_mm256_movemask_pd(finite) == 0xF)
+            {
+                _mm256_storeu_pd(result + index, thmath::simd::avx2::atan2(y, x));
+            }
+            else
+            {
+                argument_scalar(re + index * stride, im + index * stride, result + index, 4, stride);
+            }
+        }
+        argument_scalar(re + index * stride, im + index * stride, result + index, size - index, stride);
+    }
+#endif
+}
+
+thmath::ComplexArray::ComplexArray(size_t size, ComplexLayout layout)
+    : entries(2 * size, 0.0), size(size), layout(layout)
+{
+
+}
+
+thmath::ComplexArray::ComplexArray(const std::vector<Complex>& values, ComplexLayout layout)
+    : ComplexArray(values.size(), layout)
+{
+    for (size_t index = 0; index < this->size; index++)
+    {
+        set(index, values[index]);
+    }
+}
+
+size_t thmath::ComplexArray::get_size() const
+{
+    return this->size;
+}
+
+thmath::ComplexLayout thmath::ComplexArray::get_layout() const
+{
+    return this->layout;
+}
+
+double* thmath::ComplexArray::get_entries()
+{
+    return this->entries.data();
+}
+
+const double* thmath::ComplexArray::get_entries() const
+{
+    return this->entries.data();
+}
+
+thmath::Complex thmath::ComplexArray::get(size_t index) const
+{
+    if (index >= this->size)
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    if (this->layout == ComplexLayout::SPLIT)
+    {
+        return Complex(this->entries[index], this->entries[this->size + index]);
+    }
+    return Complex(this->entries[2 * index], this->entries[2 * index + 1]);
+}
+
+void thmath::ComplexArray::set(size_t index, const Complex& value)
+{
+    if (index >= this->size)
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    if (this->layout == ComplexLayout::SPLIT)
+    {
+        this->entries[index] = value.get_real();
+        this->entries[this->size + index] = value.get_imaginary();
+    }
+    else
+    {
+        this->entries[2 * index] = value.get_real();
+        this->entries[2 * index + 1] = value.get_imaginary();
+    }
+}
+
+thmath::ComplexArray thmath::ComplexArray::with_layout(ComplexLayout layout) const
+{
+    if (layout == this->layout)
+    {
+        return *this;
+    }
+    ComplexArray result(this->size, layout);
+    const double* source = this->entries.data();
+    double* target = result.entries.data();
+    for (size_t index = 0; index < this->size; index++)
+    {
+        if (layout == ComplexLayout::SPLIT)
+        {
+            target[index] = source[2 * index];
+            target[this->size + index] = source[2 * index + 1];
+        }
+        else
+        {
+            target[2 * index] = source[index];
+            target[2 * index + 1] = source[this->size + index];
+        }
+    }
+    return result;
+}
+
+std::vector<thmath::Complex> thmath::ComplexArray::to_vector() const
+{
+    std::vector<Complex> result;
+    result.reserve(this->size);
+    for (size_t index = 0; index < this->size; index++)
+    {
+        result.push_back(get(index));
+    }
+    return result;
+}
+
+thmath::ComplexArray& thmath::ComplexArray::multiply(const ComplexArray& other)
+{
+    if (this->size != other.size)
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    if (other.layout != this->layout)
+    {
+        return multiply(other.with_layout(this->layout));
+    }
+    double* a = this->entries.data();
+    const double* b = other.entries.data();
+#ifdef THMATH_SIMD_X86
+    if (use_avx2())
+    {
+        if (this->layout == ComplexLayout::SPLIT)
+        {
+            multiply_split_avx2(a, a + this->size, b, b + this->size, this->size, false);
+        }
+        else
+        {
+            multiply_interleaved_avx2(a, b, this->size, false);
+        }
+        return *this;
+    }
+#endif
+    if (this->layout == ComplexLayout::SPLIT)
+    {
+        multiply_scalar(a, a + this->size, b, b + this->size, this->size, 1, false);
+    }
+    else
+    {
+        multiply_scalar(a, a + 1, b, b + 1, this->size, 2, false);
+    }
+    return *this;
+}
+
+thmath::ComplexArray& thmath::ComplexArray::conjugate_multiply(const ComplexArray& other)
+{
+    if (this->size != other.size)
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    if (other.layout != this->layout)
+    {
+        return conjugate_multiply(other.with_layout(this->layout));
+    }
+    double* a = this->entries.data();
+    const double* b = other.entries.data();
+#ifdef THMATH_SIMD_X86
+    if (use_avx2())
+    {
+        if (this->layout == ComplexLayout::SPLIT)
+        {
+            multiply_split_avx2(a, a + this->size, b, b + this->size, this->size, true);
+        }
+        else
+        {
+            multiply_interleaved_avx2(a, b, this->size, true);
+        }
+        return *this;
+    }
+#endif
+    if (this->layout == ComplexLayout::SPLIT)
+    {
+        multiply_scalar(a, a + this->size, b, b + this->size, this->size, 1, true);
+    }
+    else
+    {
+        multiply_scalar(a, a + 1, b, b + 1, this->size, 2, true);
+    }
+    return *this;
+}
+
+thmath::ComplexArray& thmath::ComplexArray::scale(double lambda)
+{
+    // Both parts scale alike, whatever the layout.
+    simd::scale(this->entries.data(), lambda, this->entries.size());
+    return *this;
+}
+
+void thmath::ComplexArray::norm(double* result) const
+{
+    const double* a = this->entries.data();
+#ifdef THMATH_SIMD_X86
+    if (use_avx2())
+    {
+        if (this->layout == ComplexLayout::SPLIT)
+        {
+            norm_split_avx2(a, a + this->size, result, this->size);
+        }
+        else
+        {
+            norm_interleaved_avx2(a, result, this->size);
+        }
+        return;
+    }
+#endif
+    if (this->layout == ComplexLayout::SPLIT)
+    {
+        norm_scalar(a, a + this->size, result, this->size, 1);
+    }
+    else
+    {
+        norm_scalar(a, a + 1, result, this->size, 2);
+    }
+}
+
+void thmath::ComplexArray::argument(double* result) const
+{
+    const double* a = this->entries.data();
+    const double* re = a;
+    const double* im = this->layout == ComplexLayout::SPLIT ? a + this->size : a + 1;
+    size_t stride = this->layout == ComplexLayout::SPLIT ? 1 : 2;
+#ifdef THMATH_SIMD_X86
+    if (use_avx2())
+    {
+        argument_avx2(re, im, result, this->size, stride);
+        return;
+    }
+#endif
+    argument_scalar(re, im, result, this->size, stride);
+}
+
+std::string thmath::ComplexArray::to_string() const
+{
+    std::string s = "ComplexArray={size=" + std::to_string(this->size) + ", layout="
+        + (this->layout == ComplexLayout::SPLIT ? "split" : "interleaved") + ", elements=[";
+    for (size_t index = 0; index < this->size; index++)
+    {
+        if (index > 0)
+        {
+            s += ", ";
+        }
+        s += get(index).to_string();
+    }
+    return s + "]}";
+}
@@ -0,0 +1,193 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#ifndef __THMATH_COMPLEX_ARRAY_
+#define __THMATH_COMPLEX_ARRAY_
+
+#include "complex.h"
+#include <string>
+#include <vector>
+
+namespace thmath
+{
+    /**
+     * Memory layout of a ComplexArray of size n:
+     *  - SPLIT stores the n real parts, followed by the n
+     *    imaginary parts (entries[k] and entries[n + k]);
+     *  - INTERLEAVED stores (real, imaginary) pairs, like an
+     *    array of Complex (entries[2k] and entries[2k + 1]).
+     * Split is the faster one for the kernels, interleaved the
+     * one expected by most external code.
+    */
+    enum class ComplexLayout
+    {
+        SPLIT,
+        INTERLEAVED
+    };
+
+    /**
+     * Contiguous array of complex numbers, stored as plain doubles
+     * so that the element-wise kernels below can be vectorized
+     * (with AVX2/FMA when the CPU has it, see simd.h), instead of
+     * going through one out-of-line Complex operator per element.
+    */
+    class ComplexArray
+    {
+    private:
+        std::vector<double> entries;
+        size_t size;
+        ComplexLayout layout;
+
+    public:
+        /**
+         * Default constructor for the ComplexArray class,
+         * filled with zeros.
+         *
+         * @param size The number of complex numbers.
+         * @param layout The memory layout.
+         * @return A new complex array.
+        */
+        explicit ComplexArray(const size_t size, ComplexLayout layout = ComplexLayout::SPLIT);
+
+        /**
+         * Constructor for the ComplexArray class, copying
+         * a list of complex numbers.
+         *
+         * @param values The complex numbers.
+         * @param layout The memory layout.
+         * @return A new complex array.
+        */
+        ComplexArray(const std::vector<Complex>& values, ComplexLayout layout = ComplexLayout::SPLIT);
+
+        /**
+         * Return the number of complex numbers in the array.
+         *
+         * @return The size of the array.
+        */
+        size_t get_size() const;
+
+        /**
+         * Return the memory layout of the array.
+         *
+         * @return The layout.
+        */
+        ComplexLayout get_layout() const;
+
+        /**
+         * Obtain the 2 * get_size() doubles of the array,
+         * arranged as described by get_layout().
+         *
+         * @return The raw entries.
+        */
+        double* get_entries();
+        const double* get_entries() const;
+
+        /**
+         * Obtain the complex number at the given index.
+         *
+         * @param index The index of the element.
+         * @return The element.
+        */
+        Complex get(const size_t index) const;
+
+        /**
+         * Overwrite the complex number at the given index.
+         *
+         * @param index The index of the element.
+         * @param value The new value of the element.
+        */
+        void set(const size_t index, const Complex& value);
+
+        /**
+         * Return a copy of the array with the given layout.
+         *
+         * @param layout The requested layout.
+         * @return A new complex array.
+        */
+        ComplexArray with_layout(ComplexLayout layout) const;
+
+        /**
+         * Copy the array into a list of Complex.
+         *
+         * @return The complex numbers.
+        */
+        std::vector<Complex> to_vector() const;
+
+        /**
+         * Element-wise product: this[k] *= other[k]. The
+         * layouts of the two arrays may differ, and other
+         * may be this array itself (squaring it).
+         *
+         * @param other An array of the same size.
+         * @return The modified array.
+        */
+        ComplexArray& multiply(const ComplexArray& other);
+
+        /**
+         * Element-wise product with the conjugate of the other
+         * array, i.e. this[k] *= conj(other[k]), as needed for
+         * cross-correlations and cross-spectra. Other may be
+         * this array itself (giving the squared moduli).
+         *
+         * @param other An array of the same size.
+         * @return The modified array.
+        */
+        ComplexArray& conjugate_multiply(const ComplexArray& other);
+
+        /**
+         * Multiply every element by a real factor.
+         *
+         * @param lambda The scale factor.
+         * @return The modified array.
+        */
+        ComplexArray& scale(double lambda);
+
+        /**
+         * Compute the modulus of every element.
+         *
+         * @param result An array receiving the get_size() moduli.
+        */
+        void norm(double* result) const;
+
+        /**
+         * Compute the argument of every element, in (-pi, pi].
+         * The vectorized kernel evaluates atan2 with a rational
+         * approximation, which is within 2 ULP of std::atan2.
+         *
+         * @param result An array receiving the get_size() arguments.
+        */
+        void argument(double* result) const;
+
+        /**
+         * Stringify the complex array, for debugging purposes.
+         *
+         * @return The stringified version of the array.
+        */
+        std::string to_string() const;
+    };
+}
+
+#endif
@@ -0,0 +1,386 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "complex_math.h"
+#include "simd.h"
+#include "simd_math.h"
+#include "../exception/different_size_exception.h"
+#include "../exception/messages.h"
+#include <complex>
+
+namespace
+{
+    using cpx = std::complex<double>;
+    using thmath::ComplexArray;
+    using thmath::ComplexLayout;
+    using thmath::complex_math::Accuracy;
+
+    enum class Operation
+    {
+        EXP,
+        LOG,
+        SQRT,
+        SIN,
+        COS,
+        POW
+    };
+
+    /**
+     * Strided access to the parts of a ComplexArray, whatever
+     * its layout: element k is (re[k * stride], im[k * stride]).
+    */
+    struct Parts
+    {
+        double* re;
+        double* im;
+        size_t stride;
+    };
+
+    Parts parts_of(const ComplexArray& array)
+    {
+        double* entries = const_cast<double*>(array.get_entries());
+        if (array.get_layout() == ComplexLayout::SPLIT)
+        {
+            return Parts{entries, entries + array.get_size(), 1};
+        }
+        return Parts{entries, entries + 1, 2};
+    }
+
+    /**
+     * Apply a scalar function to elements [begin, end).
+    */
+    template <typename Scalar>
+    void apply_scalar(Parts input, Parts output, size_t begin, size_t end, Scalar scalar)
+    {
+        for (size_t index = begin; index < end; index++)
+        {
+            cpx result = scalar(cpx(input.re[index * input.stride], input.im[index * input.stride]));
+            output.re[index * output.stride] = result.real();
+            output.im[index * output.stride] = result.imag();
+        }
+    }
+
+#ifdef THMATH_SIMD_X86
+    bool use_avx2()
+    {
+        thmath::simd::InstructionSet instruction_set = thmath::simd::get_instruction_set();
+        return instruction_set == thmath::simd::InstructionSet::AVX2
+            || instruction_set == thmath::simd::InstructionSet::AVX512;
+    }
+
+    __attribute__((target("avx2,fma")))
+    inline void load(Parts parts, size_t index, __m256d& re, __m256d& im)
+    {
+        if (parts.stride == 1)
+        {
+            re = _mm256_loadu_pd(parts.re + index);
+            im = _mm256_loadu_pd(parts.im + index);
+            return;
+        }
+        __m256d first = _mm256_loadu_pd(parts.re + 2 * index);
+        __m256d second = _mm256_loadu_pd(parts.re + 2 * index + 4);
+        re = _mm256_permute4x64_pd(_mm256_unpacklo_pd(first, second), 0xD8);
+        im = _mm256_permute4x64_pd(_mm256_unpackhi_pd(first, second), 0xD8);
+    }
+
+    __attribute__((target("avx2,fma")))
+    inline void store(Parts parts, size_t index, __m256d re, __m256d im)
+    {
+        if (parts.stride == 1)
+        {
+            _mm256_storeu_pd(parts.re + index, re);
+            _mm256_storeu_pd(parts.im + index, im);
+            return;
+        }
+        __m256d low = _mm256_unpacklo_pd(re, im);
+        __m256d high = _mm256_unpackhi_pd(re, im);
+        _mm256_storeu_pd(parts.re + 2 * index, _mm256_permute2f128_pd(low, high, 0x20));
+        _mm256_storeu_pd(parts.re + 2 * index + 4, _mm256_permute2f128_pd(low, high, 0x31));
+    }
+
+    __attribute__((target("avx2,fma")))
+    inline __m256d absolute(__m256d x)
+    {
+        return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x);
+    }
+
+    __attribute__((target("avx2,fma")))
+    inline __m256d below(__m256d x, double bound)
+    {
+        return _mm256_cmp_pd(absolute(x), _mm256_set1_pd(bound), _CMP_LE_OQ);
+    }
+
+    // Lanes whose largest part is in [1e-150, 1e150], where x^2 + y^2
+    // neither overflows nor underflows.
+    __attribute__((target("avx2,fma")))
+    inline __m256d in_square_range(__m256d re, __m256d im)
+    {
+        __m256d largest = _mm256_max_pd(absolute(re), absolute(im));
+        return _mm256_and_pd(
+            _mm256_cmp_pd(largest, _mm256_set1_pd(1e-150), _CMP_GE_OQ),
+            _mm256_cmp_pd(largest, _mm256_set1_pd(1e150), _CMP_LE_OQ)
+        );
+    }
+
+    __attribute__((target("avx2,fma")))
+    inline __m256d exp_block(__m256d re, __m256d im, __m256d& out_re, __m256d& out_im)
+    {
+        __m256d valid = _mm256_and_pd(below(re, 708.0), below(im, 1073741823.0));
+        __m256d modulus = thmath::simd::avx2::exp(re);
+        __m256d sine;
+        __m256d cosine;
+        thmath::simd::avx2::sincos(im, sine, cosine);
+        out_re = _mm256_mul_pd(modulus, cosine);
+        out_im = _mm256_mul_pd(modulus, sine);
+        return valid;
+    }
+
+    __attribute__((target("avx2,fma")))
+    inline __m256d log_block(__m256d re, __m256d im, __m256d& out_re, __m256d& out_im)
+    {
+        // log|z| = log(x^2 + y^2) / 2; near the unit circle, x^2 + y^2 - 1
+        // is formed with a fused multiply-add and fed to log1p instead,
+        // as the rounding of x^2 + y^2 would swamp the result.
+        __m256d valid = in_square_range(re, im);
+        __m256d largest = _mm256_max_pd(absolute(re), absolute(im));
+        __m256d smallest = _mm256_min_pd(absolute(re), absolute(im));
+        __m256d square = _mm256_fmadd_pd(re, re, _mm256_mul_pd(im, im));
+        __m256d near_one = _mm256_and_pd(
+            _mm256_cmp_pd(square, _mm256_set1_pd(0.70710678118654752440), _CMP_GE_OQ),
+            _mm256_cmp_pd(square, _mm256_set1_pd(1.41421356237309504880), _CMP_LE_OQ)
+        );
+        __m256d offset = _mm256_fmadd_pd(
+            smallest, smallest, _mm256_fmsub_pd(largest, largest, _mm256_set1_pd(1.0))
+        );
+        __m256d log_square = _mm256_blendv_pd(
+            thmath::simd::avx2::log(square),
+            thmath::simd::avx2::log1p_reduced(offset, _mm256_setzero_pd()),
+            near_one
+        );
+        out_re = _mm256_mul_pd(_mm256_set1_pd(0.5), log_square);
+        out_im = thmath::simd::avx2::atan2(im, re);
+        return valid;
+    }
+
+    __attribute__((target("avx2,fma")))
+    inline __m256d sqrt_block(__m256d re, __m256d im, __m256d& out_re, __m256d& out_im)
+    {
+        // t = sqrt((|z| + |x|) / 2) is computed without cancellation;
+        // the other part is y / 2t, with the signs of the principal root.
+        const __m256d sign_mask = _mm256_set1_pd(-0.0);
+        __m256d valid = in_square_range(re, im);
+        __m256d modulus = _mm256_sqrt_pd(_mm256_fmadd_pd(re, re, _mm256_mul_pd(im, im)));
+        __m256d t = _mm256_sqrt_pd(_mm256_mul_pd(_mm256_set1_pd(0.5), _mm256_add_pd(modulus, absolute(re))));
+        __m256d other = _mm256_div_pd(im, _mm256_add_pd(t, t));
+        __m256d t_signed = _mm256_or_pd(t, _mm256_and_pd(sign_mask, im));
+        out_re = _mm256_blendv_pd(t, absolute(other), re);
+        out_im = _mm256_blendv_pd(other, t_signed, re);
+        return valid;
+    }
+
+    /**
+     * cosh and sinh of four lanes with |y| <= 708, from e^y and
+     * e^-y; sinh uses its Taylor series below 0.3, where the
+     * difference of the exponentials would cancel.
+    */
+    __attribute__((target("avx2,fma")))
+    inline void cosh_sinh(__m256d y, __m256d& cosh, __m256d& sinh)
+    {
+        const __m256d half = _mm256_set1_pd(0.5);
+        __m256d e = thmath::simd::avx2::exp(y);
+        __m256d inverse = _mm256_div_pd(_mm256_set1_pd(1.0), e);
+        cosh = _mm256_mul_pd(half, _mm256_add_pd(e, inverse));
+        __m256d difference = _mm256_mul_pd(half, _mm256_sub_pd(e, inverse));
+
+        __m256d yy = _mm256_mul_pd(y, y);
+        __m256d series = _mm256_set1_pd(1.0 / 6227020800.0);
+        series = _mm256_fmadd_pd(series, yy, _mm256_set1_pd(1.0 / 39916800.0));
+        series = _mm256_fmadd_pd(series, yy, _mm256_set1_pd(1.0 / 362880.0));
+        series = _mm256_fmadd_pd(series, yy, _mm256_set1_pd(1.0 / 5040.0));
+        series = _mm256_fmadd_pd(series, yy, _mm256_set1_pd(1.0 / 120.0));
+        series = _mm256_fmadd_pd(series, yy, _mm256_set1_pd(1.0 / 6.0));
+        series = _mm256_fmadd_pd(_mm256_mul_pd(series, yy), y, y);
+        sinh = _mm256_blendv_pd(difference, series, below(y, 0.3));
+    }
+
+    __attribute__((target("avx2,fma")))
+    inline __m256d sin_block(__m256d re, __m256d im, __m256d& out_re, __m256d& out_im)
+    {
+        __m256d valid = _mm256_and_pd(below(re, 1073741823.0), below(im, 708.0));
+        __m256d sine;
+        __m256d cosine;
+        __m256d cosh;
+        __m256d sinh;
+        thmath::simd::avx2::sincos(re, sine, cosine);
+        cosh_sinh(im, cosh, sinh);
+        out_re = _mm256_mul_pd(sine, cosh);
+        out_im = _mm256_mul_pd(cosine, sinh);
+        return valid;
+    }
+
+    __attribute__((target("avx2,fma")))
+    inline __m256d cos_block(__m256d re, __m256d im, __m256d& out_re, __m256d& out_im)
+    {
+        __m256d valid = _mm256_and_pd(below(re, 1073741823.0), below(im, 708.0));
+        __m256d sine;
+        __m256d cosine;
+        __m256d cosh;
+        __m256d sinh;
+        thmath::simd::avx2::sincos(re, sine, cosine);
+        cosh_sinh(im, cosh, sinh);
+        out_re = _mm256_mul_pd(cosine, cosh);
+        out_im = _mm256_xor_pd(_mm256_mul_pd(sine, sinh), _mm256_set1_pd(-0.0));
+        return valid;
+    }
+
+    __attribute__((target("avx2,fma")))
+    inline __m256d pow_block(__m256d re, __m256d im, cpx exponent, __m256d& out_re, __m256d& out_im)
+    {
+        __m256d log_re;
+        __m256d log_im;
+        __m256d valid = log_block(re, im, log_re, log_im);
+        __m256d a = _mm256_set1_pd(exponent.real());
+        __m256d b = _mm256_set1_pd(exponent.imag());
+        __m256d product_re = _mm256_fmsub_pd(a, log_re, _mm256_mul_pd(b, log_im));
+        __m256d product_im = _mm256_fmadd_pd(a, log_im, _mm256_mul_pd(b, log_re));
+        return _mm256_and_pd(valid, exp_block(product_re, product_im, out_re, out_im));
+    }
+
+    /**
+     * Run a four-lane kernel over the arrays. A block with an
+     * invalid lane, and the last (partial) block, are handed to
+     * the scalar function instead.
+    */
+    template <Operation operation, typename Scalar>
+    __attribute__((target("avx2,fma")))
+    void apply_avx2(Parts input, Parts output, size_t size, Scalar scalar, cpx exponent)
+    {
+        size_t index = 0;
+        for (; index + 4 <= size; index += 4)
+        {
+            __m256d re;
+            __m256d im;
+            __m256d out_re;
+            __m256d out_im;
+            __m256d valid;
+            load(input, index, re, im);
+            if constexpr (operation == Operation::EXP)
+            {
+                valid = exp_block(re, im, out_re, out_im);
+            }
+            else if constexpr (operation == Operation::LOG)
+            {
+                valid = log_block(re, im, out_re, out_im);
+            }
+            else if constexpr (operation == Operation::SQRT)
+            {
+                valid = sqrt_block(re, im, out_re, out_im);
+            }
+            else if constexpr (operation == Operation::SIN)
+            {
+                valid = sin_block(re, im, out_re, out_im);
+            }
+            else if constexpr (operation == Operation::COS)
+            {
+                valid = cos_block(re, im, out_re, out_im);
+            }
+            else
+            {
+                valid = pow_block(re, im, exponent, out_re, out_im);
+            }
+            if (_mm256_movemask_pd(valid) == 0xF)
+            {
+                store(output, index, out_re, out_im);
+            }
+            else
+            {
+                apply_scalar(input, output, index, index + 4, scalar);
+            }
+        }
+        apply_scalar(input, output, index, size, scalar);
+    }
+#endif
+
+    template <Operation operation, typename Scalar>
+    void apply(const ComplexArray& input, ComplexArray& output, Accuracy accuracy, Scalar scalar, cpx exponent = cpx())
+    {
+        if (input.get_size() != output.get_size())
+        {
+            throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+        }
+        Parts in = parts_of(input);
+        Parts out = parts_of(output);
+#ifdef THMATH_SIMD_X86
+        if (accuracy == Accuracy::FAST && use_avx2())
+        {
+            apply_avx2<operation>(in, out, input.get_size(), scalar, exponent);
+            return;
+        }
+#endif
+        apply_scalar(in, out, 0, input.get_size(), scalar);
+    }
+}
+
+void thmath::complex_math::exp(const ComplexArray& input, ComplexArray& output, Accuracy accuracy)
+{
+    apply<Operation::EXP>(input, output, accuracy, [](cpx z) {
+        return std::exp(z);
+    });
+}
+
+void thmath::complex_math::log(const ComplexArray& input, ComplexArray& output, Accuracy accuracy)
+{
+    apply<Operation::LOG>(input, output, accuracy, [](cpx z) {
+        return std::log(z);
+    });
+}
+
+void thmath::complex_math::sqrt(const ComplexArray& input, ComplexArray& output, Accuracy accuracy)
+{
+    apply<Operation::SQRT>(input, output, accuracy, [](cpx z) {
+        return std::sqrt(z);
+    });
+}
+
+void thmath::complex_math::sin(const ComplexArray& input, ComplexArray& output, Accuracy accuracy)
+{
+    apply<Operation::SIN>(input, output, accuracy, [](cpx z) {
+        return std::sin(z);
+    });
+}
+
+void thmath::complex_math::cos(const ComplexArray& input, ComplexArray& output, Accuracy accuracy)
+{
+    apply<Operation::COS>(input, output, accuracy, [](cpx z) {
+        return std::cos(z);
+    });
+}
+
+void thmath::complex_math::pow(const ComplexArray& input, const Complex& exponent, ComplexArray& output, Accuracy accuracy)
+{
+    cpx power(exponent.get_real(), exponent.get_imaginary());
+    apply<Operation::POW>(input, output, accuracy, [power](cpx z) {
+        return std::pow(z, power);
+    }, power);
+}
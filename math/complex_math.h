@@ -0,0 +1,123 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#ifndef __THMATH_COMPLEX_MATH_
+#define __THMATH_COMPLEX_MATH_
+
+#include "complex.h"
+#include "complex_array.h"
+
+namespace thmath
+{
+    /**
+     * Elementary functions over whole arrays of complex numbers.
+     * The input and output arrays must have the same size, but
+     * may have different layouts, and may be the same array.
+     *
+     * In STRICT mode every element goes through std::complex (i.e.
+     * libm), with its branch cuts and special values. FAST mode runs
+     * the AVX2/FMA approximations of simd_math.h, four elements at a
+     * time; over the ranges below, each part of the result is within
+     * a few ULP of its magnitude (worst cases measured on 2^20 random
+     * inputs by bench/complex_math_bench.cpp, relative to
+     * max(|Re|, |Im|) of the STRICT result):
+     *  - exp: |Re z| <= 708, |Im z| < 2^30 (4 ULP);
+     *  - log: 1e-150 <= max(|Re z|, |Im z|) <= 1e150 (3 ULP);
+     *  - sqrt: same range as log (2 ULP);
+     *  - sin, cos: |Re z| < 2^30, |Im z| <= 708 (6 ULP);
+     *  - pow: log of the base and exp of the product, as above (the
+     *    error grows with |exponent * log(base)|, as for libm).
+     * Groups of four elements with any input outside these ranges
+     * (zeros, infinities and NaNs included) are computed as in STRICT
+     * mode. Without AVX2, FAST mode is STRICT mode.
+    */
+    namespace complex_math
+    {
+        enum class Accuracy
+        {
+            STRICT,
+            FAST
+        };
+
+        /**
+         * Compute e^z for every element.
+         *
+         * @param input The exponents.
+         * @param output The array receiving the results.
+         * @param accuracy Whether to use libm or the approximations.
+        */
+        void exp(const ComplexArray& input, ComplexArray& output, Accuracy accuracy = Accuracy::STRICT);
+
+        /**
+         * Compute the principal logarithm of every element.
+         *
+         * @param input The arguments.
+         * @param output The array receiving the results.
+         * @param accuracy Whether to use libm or the approximations.
+        */
+        void log(const ComplexArray& input, ComplexArray& output, Accuracy accuracy = Accuracy::STRICT);
+
+        /**
+         * Compute the principal square root of every element.
+         *
+         * @param input The arguments.
+         * @param output The array receiving the results.
+         * @param accuracy Whether to use libm or the approximations.
+        */
+        void sqrt(const ComplexArray& input, ComplexArray& output, Accuracy accuracy = Accuracy::STRICT);
+
+        /**
+         * Compute the sine of every element.
+         *
+         * @param input The arguments.
+         * @param output The array receiving the results.
+         * @param accuracy Whether to use libm or the approximations.
+        */
+        void sin(const ComplexArray& input, ComplexArray& output, Accuracy accuracy = Accuracy::STRICT);
+
+        /**
+         * Compute the cosine of every element.
+         *
+         * @param input The arguments.
+         * @param output The array receiving the results.
+         * @param accuracy Whether to use libm or the approximations.
+        */
+        void cos(const ComplexArray& input, ComplexArray& output, Accuracy accuracy = Accuracy::STRICT);
+
+        /**
+         * Raise every element to the same complex power,
+         * e^(exponent * log(z)).
+         *
+         * @param input The bases.
+         * @param exponent The exponent.
+         * @param output The array receiving the results.
+         * @param accuracy Whether to use libm or the approximations.
+        */
+        void pow(const ComplexArray& input, const Complex& exponent, ComplexArray& output, Accuracy accuracy = Accuracy::STRICT);
+    }
+}
+
+#endif
@@ -0,0 +1,343 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "convolution.h"
+#include "../exception/illegal_size_exception.h"
+#include "../exception/messages.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    using thmath::Complex;
+    using thmath::ConvolutionMethod;
+
+    size_t next_power_of_two(size_t size)
+    {
+        size_t result = 1;
+        while (result < size)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    template <typename T>
+    std::vector<T> convolve_direct(const std::vector<T>& signal, const std::vector<T>& kernel)
+    {
+        std::vector<T> result(signal.size() + kernel.size() - 1, T());
+        for (size_t i = 0; i < signal.size(); i++)
+        {
+            const T value = signal[i];
+            T* target = result.data() + i;
+            for (size_t j = 0; j < kernel.size(); j++)
+            {
+                target[j] += value * kernel[j];
+            }
+        }
+        return result;
+    }
+
+    std::vector<double> convolve_direct(const std::vector<double>& signal, const std::vector<double>& kernel)
+    {
+        // Every output is one dot product of the signal with the reversed
+        // kernel, which runs on the SIMD kernels of the dense vectors.
+        const size_t n = signal.size();
+        const size_t m = kernel.size();
+        std::vector<double> reversed(kernel.rbegin(), kernel.rend());
+        std::vector<double> result(n + m - 1);
+        for (size_t k = 0; k < result.size(); k++)
+        {
+            size_t lo = k + 1 < m ? m - 1 - k : 0;
+            size_t hi = std::min(m, n + m - 1 - k);
+            result[k] = thmath::simd::dot(signal.data() + (k + lo + 1 - m), reversed.data() + lo, hi - lo);
+        }
+        return result;
+    }
+
+    // Size of the transforms when a long real signal is convolved block
+    // by block (overlap-add): about four kernel lengths, so that each
+    // block yields at least three quarters of useful outputs.
+    size_t block_fft_size(size_t kernel_size)
+    {
+        return std::max<size_t>(next_power_of_two(4 * kernel_size), 256);
+    }
+
+    double transform_cost(size_t size)
+    {
+        return static_cast<double>(size) * std::log2(static_cast<double>(size) + 1.0);
+    }
+
+    std::vector<double> convolve_fft(const std::vector<double>& signal, const std::vector<double>& kernel)
+    {
+        size_t size = signal.size() + kernel.size() - 1;
+        size_t block_size = block_fft_size(kernel.size()) - kernel.size() + 1;
+        if (signal.size() > 2 * block_size)
+        {
+            // The last block is padded with zeros, which only extends
+            // the output past the n + m - 1 values that are kept.
+            size_t blocks = (signal.size() + block_size - 1) / block_size;
+            std::vector<double> result(blocks * block_size + kernel.size() - 1, 0.0);
+            std::copy(signal.begin(), signal.end(), result.begin());
+            thmath::StreamingConvolver convolver(kernel, block_size);
+            for (size_t block = 0; block < blocks; block++)
+            {
+                convolver.process(result.data() + block * block_size, result.data() + block * block_size);
+            }
+            convolver.flush(result.data() + blocks * block_size);
+            result.resize(size);
+            return result;
+        }
+
+        size_t fft_size = next_power_of_two(size);
+        auto plan = thmath::FftPlan::get(fft_size);
+        std::vector<double> a(fft_size, 0.0);
+        std::vector<double> b(fft_size, 0.0);
+        std::copy(signal.begin(), signal.end(), a.begin());
+        std::copy(kernel.begin(), kernel.end(), b.begin());
+        std::vector<Complex> a_spectrum(fft_size / 2 + 1);
+        std::vector<Complex> b_spectrum(fft_size / 2 + 1);
+        plan->forward_real(a.data(), a_spectrum.data());
+        plan->forward_real(b.data(), b_spectrum.data());
+        for (size_t k = 0; k < a_spectrum.size(); k++)
+        {
+            a_spectrum[k] *= b_spectrum[k];
+        }
+        plan->inverse_real(a_spectrum.data(), a.data());
+        a.resize(size);
+        return a;
+    }
+
+    std::vector<Complex> convolve_fft(const std::vector<Complex>& signal, const std::vector<Complex>& kernel)
+    {
+        size_t size = signal.size() + kernel.size() - 1;
+        size_t fft_size = next_power_of_two(size);
+        auto plan = thmath::FftPlan::get(fft_size);
+        std::vector<Complex> a(fft_size);
+        std::vector<Complex> b(fft_size);
+        std::copy(signal.begin(), signal.end(), a.begin());
+        std::copy(kernel.begin(), kernel.end(), b.begin());
+        plan->forward(a.data(), a.data());
+        plan->forward(b.data(), b.data());
+        for (size_t k = 0; k < fft_size; k++)
+        {
+            a[k] *= b[k];
+        }
+        plan->inverse(a.data(), a.data());
+        a.resize(size);
+        return a;
+    }
+
+    template <typename T>
+    std::vector<T> convolve_with(const std::vector<T>& signal, const std::vector<T>& kernel, ConvolutionMethod method)
+    {
+        if (signal.empty() || kernel.empty())
+        {
+            return std::vector<T>();
+        }
+        if (signal.size() < kernel.size())
+        {
+            return convolve_with(kernel, signal, method);
+        }
+        if (method == ConvolutionMethod::AUTOMATIC)
+        {
+            method = thmath::convolution::choose_method(signal.size(), kernel.size());
+        }
+        if (method == ConvolutionMethod::DIRECT)
+        {
+            return convolve_direct(signal, kernel);
+        }
+        return convolve_fft(signal, kernel);
+    }
+}
+
+thmath::ConvolutionMethod thmath::convolution::choose_method(size_t signal_size, size_t kernel_size)
+{
+    if (signal_size < kernel_size)
+    {
+        std::swap(signal_size, kernel_size);
+    }
+    // Measured with AVX2: a multiply-add of the direct method costs about
+    // 1/8 of a unit of N log2(N) in the transforms (three transforms of
+    // the whole signal, or two per block when it is cut into blocks).
+    double fft_cost = 3.0 * transform_cost(next_power_of_two(signal_size + kernel_size - 1));
+    size_t block_size = block_fft_size(kernel_size) - kernel_size + 1;
+    if (signal_size > 2 * block_size)
+    {
+        double blocks = std::ceil(static_cast<double>(signal_size) / static_cast<double>(block_size));
+        fft_cost = std::min(fft_cost, 2.0 * blocks * transform_cost(block_fft_size(kernel_size)));
+    }
+    double direct_cost = static_cast<double>(signal_size) * static_cast<double>(kernel_size);
+    return direct_cost <= 8.0 * fft_cost ? ConvolutionMethod::DIRECT : ConvolutionMethod::FFT;
+}
+
+std::vector<double> thmath::convolution::convolve(
+    const std::vector<double>& signal, const std::vector<double>& kernel, ConvolutionMethod method
+)
+{
+    return convolve_with(signal, kernel, method);
+}
+
+std::vector<thmath::Complex> thmath::convolution::convolve(
+    const std::vector<Complex>& signal, const std::vector<Complex>& kernel, ConvolutionMethod method
+)
+{
+    return convolve_with(signal, kernel, method);
+}
+
+std::vector<double> thmath::convolution::correlate(
+    const std::vector<double>& signal, const std::vector<double>& kernel, ConvolutionMethod method
+)
+{
+    std::vector<double> reversed(kernel.rbegin(), kernel.rend());
+    return convolve_with(signal, reversed, method);
+}
+
+std::vector<thmath::Complex> thmath::convolution::correlate(
+    const std::vector<Complex>& signal, const std::vector<Complex>& kernel, ConvolutionMethod method
+)
+{
+    std::vector<Complex> reversed;
+    reversed.reserve(kernel.size());
+    for (auto it = kernel.rbegin(); it != kernel.rend(); ++it)
+    {
+        reversed.push_back(it->conjugate());
+    }
+    return convolve_with(signal, reversed, method);
+}
+
+thmath::StreamingConvolver::StreamingConvolver(const std::vector<double>& kernel, size_t block_size, StreamingMethod method)
+    : method(method), block_size(block_size), kernel_size(kernel.size())
+{
+    if (kernel.empty() || block_size == 0)
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+    size_t fft_size = next_power_of_two(block_size + this->kernel_size - 1);
+    this->plan = FftPlan::get(fft_size);
+    this->plan->reserve(this->workspace);
+    this->kernel_spectrum.resize(fft_size / 2 + 1);
+    this->spectrum.resize(fft_size / 2 + 1);
+    this->frame.assign(fft_size, 0.0);
+    this->overlap.assign(this->kernel_size - 1, 0.0);
+    if (method == StreamingMethod::OVERLAP_SAVE)
+    {
+        this->zeros.assign(block_size, 0.0);
+    }
+
+    std::copy(kernel.begin(), kernel.end(), this->frame.begin());
+    this->plan->forward_real(this->frame.data(), this->kernel_spectrum.data(), this->workspace);
+    std::fill(this->frame.begin(), this->frame.end(), 0.0);
+}
+
+size_t thmath::StreamingConvolver::get_block_size() const
+{
+    return this->block_size;
+}
+
+size_t thmath::StreamingConvolver::get_kernel_size() const
+{
+    return this->kernel_size;
+}
+
+size_t thmath::StreamingConvolver::get_fft_size() const
+{
+    return this->frame.size();
+}
+
+void thmath::StreamingConvolver::convolve_frame()
+{
+    this->plan->forward_real(this->frame.data(), this->spectrum.data(), this->workspace);
+    for (size_t k = 0; k < this->spectrum.size(); k++)
+    {
+        this->spectrum[k] *= this->kernel_spectrum[k];
+    }
+    this->plan->inverse_real(this->spectrum.data(), this->frame.data(), this->workspace);
+}
+
+void thmath::StreamingConvolver::process(const double* input, double* output)
+{
+    const size_t history = this->kernel_size - 1;
+    if (this->method == StreamingMethod::OVERLAP_ADD)
+    {
+        std::copy(input, input + this->block_size, this->frame.begin());
+        std::fill(this->frame.begin() + this->block_size, this->frame.end(), 0.0);
+        convolve_frame();
+        for (size_t i = 0; i < this->block_size; i++)
+        {
+            output[i] = this->frame[i] + (i < history ? this->overlap[i] : 0.0);
+        }
+        // The tail shifts by one block, and the new spill is added.
+        for (size_t j = 0; j < history; j++)
+        {
+            double carried = j + this->block_size < history ? this->overlap[j + this->block_size] : 0.0;
+            this->overlap[j] = carried + this->frame[this->block_size + j];
+        }
+        return;
+    }
+
+    // Frame = [previous kernel_size - 1 inputs, block, zeros]; the
+    // wrap-around only reaches the first kernel_size - 1 outputs.
+    std::copy(this->overlap.begin(), this->overlap.end(), this->frame.begin());
+    std::copy(input, input + this->block_size, this->frame.begin() + history);
+    std::fill(this->frame.begin() + history + this->block_size, this->frame.end(), 0.0);
+    if (history > 0)
+    {
+        // The new history is the end of [history, block], still in the frame.
+        std::copy(
+            this->frame.begin() + this->block_size,
+            this->frame.begin() + this->block_size + history,
+            this->overlap.begin()
+        );
+    }
+    convolve_frame();
+    std::copy(this->frame.begin() + history, this->frame.begin() + history + this->block_size, output);
+}
+
+void thmath::StreamingConvolver::flush(double* output)
+{
+    const size_t history = this->kernel_size - 1;
+    if (this->method == StreamingMethod::OVERLAP_ADD)
+    {
+        std::copy(this->overlap.begin(), this->overlap.end(), output);
+    }
+    else
+    {
+        // Feed zeros until the last input has left the history.
+        for (size_t done = 0; done < history; done += this->block_size)
+        {
+            size_t count = std::min(this->block_size, history - done);
+            std::fill(this->zeros.begin(), this->zeros.end(), 0.0);
+            process(this->zeros.data(), this->zeros.data());
+            std::copy(this->zeros.begin(), this->zeros.begin() + count, output + done);
+        }
+    }
+    reset();
+}
+
+void thmath::StreamingConvolver::reset()
+{
+    std::fill(this->overlap.begin(), this->overlap.end(), 0.0);
+}
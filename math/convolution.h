@@ -0,0 +1,198 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#ifndef __THMATH_CONVOLUTION_
+#define __THMATH_CONVOLUTION_
+
+#include "complex.h"
+#include "fft.h"
+#include <memory>
+#include <vector>
+
+namespace thmath
+{
+    enum class ConvolutionMethod
+    {
+        AUTOMATIC,
+        DIRECT,
+        FFT
+    };
+
+    /**
+     * Linear convolution and cross-correlation of finite signals.
+     * The direct method costs n * m multiply-adds, the FFT one three
+     * transforms of the next power of two above n + m - 1 or, for a
+     * real signal much longer than the kernel, overlap-add over blocks
+     * of a few kernel lengths. AUTOMATIC picks the cheaper method from
+     * the sizes alone.
+    */
+    namespace convolution
+    {
+        /**
+         * Pick the cheaper method for the given sizes.
+         *
+         * @param signal_size The size of the first operand.
+         * @param kernel_size The size of the second operand.
+         * @return DIRECT or FFT.
+        */
+        ConvolutionMethod choose_method(const size_t signal_size, const size_t kernel_size);
+
+        /**
+         * Full linear convolution, (a * b)[k] = sum(a[j] b[k - j]).
+         *
+         * @param signal The first operand (n values).
+         * @param kernel The second operand (m values).
+         * @param method The method, or AUTOMATIC.
+         * @return The n + m - 1 values of the convolution (none
+         * if either operand is empty).
+        */
+        std::vector<double> convolve(
+            const std::vector<double>& signal,
+            const std::vector<double>& kernel,
+            ConvolutionMethod method = ConvolutionMethod::AUTOMATIC
+        );
+
+        std::vector<Complex> convolve(
+            const std::vector<Complex>& signal,
+            const std::vector<Complex>& kernel,
+            ConvolutionMethod method = ConvolutionMethod::AUTOMATIC
+        );
+
+        /**
+         * Full cross-correlation, c[k] = sum(a[j + k] conj(b[j])),
+         * for the lags k from -(m - 1) to n - 1.
+         *
+         * @param signal The first operand (n values).
+         * @param kernel The second operand (m values).
+         * @param method The method, or AUTOMATIC.
+         * @return The n + m - 1 values of the correlation; the
+         * value for lag k is found at index k + m - 1.
+        */
+        std::vector<double> correlate(
+            const std::vector<double>& signal,
+            const std::vector<double>& kernel,
+            ConvolutionMethod method = ConvolutionMethod::AUTOMATIC
+        );
+
+        std::vector<Complex> correlate(
+            const std::vector<Complex>& signal,
+            const std::vector<Complex>& kernel,
+            ConvolutionMethod method = ConvolutionMethod::AUTOMATIC
+        );
+    }
+
+    enum class StreamingMethod
+    {
+        OVERLAP_ADD,
+        OVERLAP_SAVE
+    };
+
+    /**
+     * Convolution of an unbounded real signal with a fixed kernel,
+     * block by block. Every call to process() consumes block_size
+     * samples and produces the next block_size samples of the
+     * convolution (with no latency); flush() then emits the last
+     * kernel_size - 1 ones. All the buffers, the workspace of the
+     * transforms included, belong to the object and are sized once,
+     * in the constructor, so that processing never allocates, on
+     * any thread.
+     *
+     * Overlap-add transforms every block on its own and carries
+     * the kernel_size - 1 samples spilling past its end into the
+     * next block; overlap-save transforms every block together with
+     * the kernel_size - 1 previous input samples, and keeps only the
+     * outputs not affected by the circular wrap-around.
+    */
+    class StreamingConvolver
+    {
+    private:
+        StreamingMethod method;
+        size_t block_size;
+        size_t kernel_size;
+        std::shared_ptr<const FftPlan> plan;
+        FftWorkspace workspace;
+        std::vector<Complex> kernel_spectrum;
+        std::vector<Complex> spectrum;
+        std::vector<double> frame;
+        // Overlap-add: the pending tail of the previous blocks.
+        // Overlap-save: the last kernel_size - 1 input samples.
+        std::vector<double> overlap;
+        std::vector<double> zeros;
+
+        void convolve_frame();
+
+    public:
+        /**
+         * Constructor for the StreamingConvolver class.
+         *
+         * @param kernel The kernel (impulse response), not empty.
+         * @param block_size The number of samples per block.
+         * @param method Overlap-add or overlap-save.
+         * @return A new streaming convolver, with an empty history.
+        */
+        StreamingConvolver(
+            const std::vector<double>& kernel,
+            const size_t block_size,
+            StreamingMethod method = StreamingMethod::OVERLAP_ADD
+        );
+
+        size_t get_block_size() const;
+        size_t get_kernel_size() const;
+
+        /**
+         * Return the size of the transforms, the next power
+         * of two above block_size + kernel_size - 1.
+         *
+         * @return The size of the FFT.
+        */
+        size_t get_fft_size() const;
+
+        /**
+         * Convolve the next block of the signal.
+         *
+         * @param input The next block_size input samples.
+         * @param output The array receiving the next block_size
+         * output samples; it may be the input array.
+        */
+        void process(const double* input, double* output);
+
+        /**
+         * Emit the end of the convolution, as if the signal was
+         * followed by zeros, and reset the convolver.
+         *
+         * @param output The array receiving the last
+         * kernel_size - 1 output samples.
+        */
+        void flush(double* output);
+
+        /**
+         * Forget the history, to start a new signal.
+        */
+        void reset();
+    };
+}
+
+#endif
@@ -0,0 +1,459 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "dataset.h"
+#include "../exception/io_exception.h"
+#include "../exception/illegal_access_exception.h"
+#include "../exception/different_size_exception.h"
+#include "../exception/illegal_size_exception.h"
+#include "../exception/messages.h"
+#include <cstring>
+#include <new>
+
+// Files are memory-mapped where POSIX mmap is available; elsewhere
+// they are read into an aligned buffer when they are opened.
+#if defined(__unix__) || defined(__APPLE__)
+#define THMATH_DATASET_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace
+{
+    const char MAGIC[8] = {'T', 'H', 'M', 'A', 'T', 'H', 'D', 'S'};
+    const uint32_t VERSION = 1;
+    // Read back in a different order on a machine of the other endianness.
+    const uint64_t BYTE_ORDER_MARK = 0x0102030405060708ull;
+    const uint64_t FLAG_CHECKSUM = 1;
+#ifndef THMATH_DATASET_MMAP
+    const std::align_val_t BUFFER_ALIGNMENT = std::align_val_t(64);
+#endif
+
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t type;
+        uint64_t byte_order;
+        uint64_t dimension;
+        uint64_t count;
+        uint64_t data_offset;
+        uint64_t flags;
+        uint64_t checksum;
+    };
+
+    // The entries start right after the header, which keeps them
+    // aligned to a cache line (the mapping itself is page aligned,
+    // and the fallback buffer is aligned to BUFFER_ALIGNMENT).
+    static_assert(sizeof(FileHeader) == 64, "The dataset header must take 64 bytes");
+
+    // The primes of xxHash64.
+    const uint64_t PRIME_1 = 0x9E3779B185EBCA87ull;
+    const uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+    const uint64_t PRIME_3 = 0x165667B19E3779F9ull;
+    const uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ull;
+
+    inline uint64_t rotate_left(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    inline uint64_t mix(uint64_t lane, uint64_t word)
+    {
+        return rotate_left(lane + word * PRIME_2, 31) * PRIME_1;
+    }
+
+    FileHeader make_header(uint64_t dimension, uint64_t count, bool checksummed, uint64_t checksum)
+    {
+        FileHeader header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.type = static_cast<uint32_t>(thmath::DatasetType::FLOAT64);
+        header.byte_order = BYTE_ORDER_MARK;
+        header.dimension = dimension;
+        header.count = count;
+        header.data_offset = sizeof(FileHeader);
+        header.flags = checksummed ? FLAG_CHECKSUM : 0;
+        header.checksum = checksummed ? checksum : 0;
+        return header;
+    }
+}
+
+thmath::DatasetChecksum::DatasetChecksum() : lanes{PRIME_1 + PRIME_2, PRIME_2, 0, 0 - PRIME_1}, words(0)
+{
+
+}
+
+void thmath::DatasetChecksum::update(const double* entries, size_t size)
+{
+    size_t index = 0;
+    // Complete the current group of four words, then take whole groups.
+    for (; index < size && (this->words & 3) != 0; index++, this->words++)
+    {
+        uint64_t word;
+        std::memcpy(&word, entries + index, sizeof(word));
+        this->lanes[this->words & 3] = mix(this->lanes[this->words & 3], word);
+    }
+    uint64_t lane0 = this->lanes[0];
+    uint64_t lane1 = this->lanes[1];
+    uint64_t lane2 = this->lanes[2];
+    uint64_t lane3 = this->lanes[3];
+    size_t grouped = index;
+    for (; index + 4 <= size; index += 4)
+    {
+        uint64_t words[4];
+        std::memcpy(words, entries + index, sizeof(words));
+        lane0 = mix(lane0, words[0]);
+        lane1 = mix(lane1, words[1]);
+        lane2 = mix(lane2, words[2]);
+        lane3 = mix(lane3, words[3]);
+    }
+    this->lanes[0] = lane0;
+    this->lanes[1] = lane1;
+    this->lanes[2] = lane2;
+    this->lanes[3] = lane3;
+    this->words += index - grouped;
+    for (; index < size; index++, this->words++)
+    {
+        uint64_t word;
+        std::memcpy(&word, entries + index, sizeof(word));
+        this->lanes[this->words & 3] = mix(this->lanes[this->words & 3], word);
+    }
+}
+
+uint64_t thmath::DatasetChecksum::digest() const
+{
+    uint64_t result = rotate_left(this->lanes[0], 1) + rotate_left(this->lanes[1], 7)
+        + rotate_left(this->lanes[2], 12) + rotate_left(this->lanes[3], 18);
+    for (uint64_t lane : this->lanes)
+    {
+        result = (result ^ mix(0, lane)) * PRIME_1 + PRIME_4;
+    }
+    result += this->words * sizeof(double);
+    result ^= result >> 33;
+    result *= PRIME_2;
+    result ^= result >> 29;
+    result *= PRIME_3;
+    result ^= result >> 32;
+    return result;
+}
+
+thmath::Dataset::Dataset(const std::string& path, bool verify)
+    : mapping(nullptr), mapping_size(0), entries(nullptr), dimension(0), count(0), checksummed(false), checksum(0)
+{
+    map(path);
+
+    FileHeader header;
+    std::memcpy(&header, this->mapping, sizeof(header));
+    bool valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+        && header.version == VERSION
+        && header.type == static_cast<uint32_t>(DatasetType::FLOAT64)
+        && header.byte_order == BYTE_ORDER_MARK
+        && header.dimension > 0
+        && header.data_offset >= sizeof(FileHeader)
+        && header.data_offset % alignof(double) == 0
+        && header.data_offset <= this->mapping_size
+        && header.count <= (this->mapping_size - header.data_offset) / sizeof(double) / header.dimension;
+    if (!valid)
+    {
+        unmap();
+        throw IOException(DATASET_FORMAT_MESSAGE);
+    }
+    this->entries = reinterpret_cast<const double*>(static_cast<const char*>(this->mapping) + header.data_offset);
+    this->dimension = header.dimension;
+    this->count = header.count;
+    this->checksummed = (header.flags & FLAG_CHECKSUM) != 0;
+    this->checksum = header.checksum;
+
+    if (verify && !this->verify())
+    {
+        unmap();
+        throw IOException(DATASET_CHECKSUM_MESSAGE);
+    }
+}
+
+thmath::Dataset::~Dataset()
+{
+    unmap();
+}
+
+thmath::Dataset::Dataset(Dataset&& other) noexcept
+    : mapping(other.mapping), mapping_size(other.mapping_size), entries(other.entries), dimension(other.dimension),
+      count(other.count), checksummed(other.checksummed), checksum(other.checksum)
+{
+    other.mapping = nullptr;
+    other.entries = nullptr;
+    other.count = 0;
+}
+
+thmath::Dataset& thmath::Dataset::operator=(Dataset&& other) noexcept
+{
+    if (this != &other)
+    {
+        unmap();
+        this->mapping = other.mapping;
+        this->mapping_size = other.mapping_size;
+        this->entries = other.entries;
+        this->dimension = other.dimension;
+        this->count = other.count;
+        this->checksummed = other.checksummed;
+        this->checksum = other.checksum;
+        other.mapping = nullptr;
+        other.entries = nullptr;
+        other.count = 0;
+    }
+    return *this;
+}
+
+void thmath::Dataset::map(const std::string& path)
+{
+#ifdef THMATH_DATASET_MMAP
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+    {
+        throw IOException(FILE_ACCESS_MESSAGE);
+    }
+    struct stat status;
+    if (fstat(descriptor, &status) != 0)
+    {
+        ::close(descriptor);
+        throw IOException(FILE_ACCESS_MESSAGE);
+    }
+    if (static_cast<size_t>(status.st_size) < sizeof(FileHeader))
+    {
+        ::close(descriptor);
+        throw IOException(DATASET_FORMAT_MESSAGE);
+    }
+    size_t size = static_cast<size_t>(status.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    // The mapping holds its own reference to the file.
+    ::close(descriptor);
+    if (mapping == MAP_FAILED)
+    {
+        throw IOException(FILE_ACCESS_MESSAGE);
+    }
+#else
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if (!stream)
+    {
+        throw IOException(FILE_ACCESS_MESSAGE);
+    }
+    size_t size = static_cast<size_t>(stream.tellg());
+    if (size < sizeof(FileHeader))
+    {
+        throw IOException(DATASET_FORMAT_MESSAGE);
+    }
+    void* mapping = ::operator new(size, BUFFER_ALIGNMENT);
+    stream.seekg(0);
+    if (!stream.read(static_cast<char*>(mapping), static_cast<std::streamsize>(size)))
+    {
+        ::operator delete(mapping, BUFFER_ALIGNMENT);
+        throw IOException(FILE_ACCESS_MESSAGE);
+    }
+#endif
+    this->mapping = mapping;
+    this->mapping_size = size;
+}
+
+void thmath::Dataset::unmap()
+{
+    if (this->mapping != nullptr)
+    {
+#ifdef THMATH_DATASET_MMAP
+        munmap(this->mapping, this->mapping_size);
+#else
+        ::operator delete(this->mapping, BUFFER_ALIGNMENT);
+#endif
+        this->mapping = nullptr;
+        this->entries = nullptr;
+    }
+}
+
+size_t thmath::Dataset::get_dimension() const
+{
+    return this->dimension;
+}
+
+size_t thmath::Dataset::get_count() const
+{
+    return this->count;
+}
+
+const double* thmath::Dataset::get_entries() const
+{
+    return this->entries;
+}
+
+thmath::VectorView thmath::Dataset::get(const size_t index) const
+{
+    if (index >= this->count)
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    return (*this)[index];
+}
+
+thmath::VectorView thmath::Dataset::column(const size_t component) const
+{
+    if (component >= this->dimension)
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    return VectorView(this->entries + component, this->count, this->dimension);
+}
+
+thmath::Matrix thmath::Dataset::to_matrix() const
+{
+    if (this->count == 0)
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+    return Matrix(this->count, this->dimension, this->entries);
+}
+
+bool thmath::Dataset::has_checksum() const
+{
+    return this->checksummed;
+}
+
+bool thmath::Dataset::verify() const
+{
+    if (!this->checksummed)
+    {
+        return true;
+    }
+    DatasetChecksum result;
+    result.update(this->entries, this->count * this->dimension);
+    return result.digest() == this->checksum;
+}
+
+thmath::DatasetWriter::DatasetWriter(const std::string& path, const size_t dimension, bool checksum)
+    : file(nullptr), dimension(dimension), count(0), checksummed(checksum)
+{
+    if (dimension == 0)
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+    this->file = std::fopen(path.c_str(), "wb");
+    if (this->file == nullptr)
+    {
+        throw IOException(FILE_ACCESS_MESSAGE);
+    }
+    // Until close, the file reads as an empty dataset.
+    FileHeader header = make_header(dimension, 0, false, 0);
+    if (std::fwrite(&header, sizeof(header), 1, this->file) != 1)
+    {
+        std::fclose(this->file);
+        this->file = nullptr;
+        throw IOException(FILE_ACCESS_MESSAGE);
+    }
+}
+
+thmath::DatasetWriter::~DatasetWriter()
+{
+    if (this->file != nullptr)
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+
+        }
+    }
+}
+
+size_t thmath::DatasetWriter::get_count() const
+{
+    return this->count;
+}
+
+void thmath::DatasetWriter::write(const double* entries, size_t size)
+{
+    if (this->file == nullptr || std::fwrite(entries, sizeof(double), size, this->file) != size)
+    {
+        throw IOException(FILE_ACCESS_MESSAGE);
+    }
+    if (this->checksummed)
+    {
+        this->checksum.update(entries, size);
+    }
+}
+
+void thmath::DatasetWriter::append(const VectorView& vec)
+{
+    if (vec.get_size() != this->dimension)
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    if (vec.is_contiguous())
+    {
+        write(vec.get_entries(), this->dimension);
+    }
+    else
+    {
+        for (size_t index = 0; index < this->dimension; index++)
+        {
+            double component = vec[index];
+            write(&component, 1);
+        }
+    }
+    this->count++;
+}
+
+void thmath::DatasetWriter::append(const double* entries, const size_t count)
+{
+    write(entries, count * this->dimension);
+    this->count += count;
+}
+
+void thmath::DatasetWriter::append(const Matrix& matrix)
+{
+    if (matrix.get_cols() != this->dimension)
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    append(matrix.get_entries(), matrix.get_rows());
+}
+
+void thmath::DatasetWriter::close()
+{
+    if (this->file == nullptr)
+    {
+        return;
+    }
+    FileHeader header = make_header(this->dimension, this->count, this->checksummed, this->checksum.digest());
+    bool written = std::fseek(this->file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, this->file) == 1;
+    bool closed = std::fclose(this->file) == 0;
+    this->file = nullptr;
+    if (!written || !closed)
+    {
+        throw IOException(FILE_ACCESS_MESSAGE);
+    }
+}
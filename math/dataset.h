@@ -0,0 +1,286 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#ifndef __THMATH_DATASET_
+#define __THMATH_DATASET_
+
+#include "vector_view.h"
+#include "matrix.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace thmath
+{
+    /**
+     * The type of the components stored in a dataset file.
+    */
+    enum class DatasetType
+    {
+        FLOAT64 = 1
+    };
+
+    /**
+     * Incremental 64-bit checksum of a dataset's entries, in
+     * the style of xxHash64: the words are spread over four
+     * independent multiply-rotate lanes, which runs at memory
+     * speed, and the result does not depend on how the entries
+     * were split into batches.
+    */
+    struct DatasetChecksum
+    {
+        uint64_t lanes[4];
+        uint64_t words;
+
+        DatasetChecksum();
+
+        /**
+         * Feed the next entries into the checksum.
+         *
+         * @param entries The entries.
+         * @param size The number of entries.
+        */
+        void update(const double* entries, size_t size);
+
+        /**
+         * Return the checksum of all the entries fed so far.
+         *
+         * @return The 64-bit checksum.
+        */
+        uint64_t digest() const;
+    };
+
+    /**
+     * Read-only dataset of vectors of the same dimension, mapped
+     * from a binary file (as written by DatasetWriter). Opening a
+     * dataset only maps the file and checks its header, so it takes
+     * the same (short) time whatever its size; the pages are read
+     * lazily, when the vectors are first accessed.
+     *
+     * The file starts with a 64-byte header holding a magic number,
+     * the format version, the component type, a byte order mark, the
+     * dimension and the number of vectors, and an optional checksum.
+     * The vectors follow, row by row, starting at a 64-byte aligned
+     * offset, so every view handed out points straight into the
+     * mapping (no copy), and remains valid as long as the dataset.
+     *
+     * Files are mapped with mmap on POSIX systems; elsewhere, they
+     * are read into an aligned buffer when the dataset is opened,
+     * which keeps the same interface but not the lazy loading.
+    */
+    class Dataset
+    {
+    private:
+        void* mapping;
+        size_t mapping_size;
+        const double* entries;
+        size_t dimension;
+        size_t count;
+        bool checksummed;
+        uint64_t checksum;
+
+        void map(const std::string& path);
+        void unmap();
+
+    public:
+        /**
+         * Constructor for the Dataset class, mapping the given
+         * file. Throws an IOException if the file cannot be mapped,
+         * or is not a valid dataset.
+         *
+         * @param path The path of the dataset file.
+         * @param verify Whether the checksum (if present) shall be
+         * checked now, which reads the whole file.
+         * @return A new dataset object.
+        */
+        explicit Dataset(const std::string& path, bool verify = false);
+
+        /**
+         * Destructor for the Dataset class, unmapping the file.
+         * All the views into the dataset become invalid.
+        */
+        ~Dataset();
+
+        Dataset(const Dataset&) = delete;
+        Dataset& operator=(const Dataset&) = delete;
+        Dataset(Dataset&& other) noexcept;
+        Dataset& operator=(Dataset&& other) noexcept;
+
+        /**
+         * Return the dimension of the vectors.
+         *
+         * @return The number of components per vector.
+        */
+        size_t get_dimension() const;
+
+        /**
+         * Return the number of vectors in the dataset.
+         *
+         * @return The number of vectors.
+        */
+        size_t get_count() const;
+
+        /**
+         * Obtain the row-major array of all the components,
+         * i.e. the vector i starts at entries[i * dimension].
+         *
+         * @return The components, inside the mapping.
+        */
+        const double* get_entries() const;
+
+        /**
+         * Obtain a view of the vector at the given index.
+         *
+         * @param index The index of the vector.
+         * @return A view into the mapping.
+        */
+        VectorView get(const size_t index) const;
+
+        /**
+         * Unchecked access to the vector at the given index.
+         *
+         * @param index The index of the vector.
+         * @return A view into the mapping.
+        */
+        VectorView operator[](const size_t index) const
+        {
+            return VectorView(this->entries + index * this->dimension, this->dimension);
+        }
+
+        /**
+         * Obtain a (strided) view of one component
+         * across all the vectors.
+         *
+         * @param component The index of the component.
+         * @return A view into the mapping.
+        */
+        VectorView column(const size_t component) const;
+
+        /**
+         * Copy the dataset into a matrix, one vector per row.
+         * Since a matrix cannot be empty, this throws an
+         * IllegalSizeException if the dataset holds no vectors
+         * (e.g. because its writer was never closed).
+         *
+         * @return A new matrix object.
+        */
+        Matrix to_matrix() const;
+
+        /**
+         * Return whether the file carries a checksum.
+         *
+         * @return Whether the dataset is checksummed.
+        */
+        bool has_checksum() const;
+
+        /**
+         * Check the entries against the checksum of the file,
+         * which reads the whole file.
+         *
+         * @return Whether the entries match, or true if the
+         * file carries no checksum.
+        */
+        bool verify() const;
+    };
+
+    /**
+     * Streaming writer of dataset files. The vectors are appended
+     * in batches and written through immediately, so the dataset
+     * never has to be held in memory; the header (with the final
+     * count and checksum) is written by close.
+    */
+    class DatasetWriter
+    {
+    private:
+        std::FILE* file;
+        size_t dimension;
+        size_t count;
+        bool checksummed;
+        DatasetChecksum checksum;
+
+        void write(const double* entries, size_t size);
+
+    public:
+        /**
+         * Constructor for the DatasetWriter class, creating (or
+         * truncating) the given file. Throws an IOException if the
+         * file cannot be created.
+         *
+         * @param path The path of the dataset file.
+         * @param dimension The dimension of the vectors.
+         * @param checksum Whether a checksum shall be stored.
+         * @return A new writer object.
+        */
+        DatasetWriter(const std::string& path, const size_t dimension, bool checksum = true);
+
+        /**
+         * Destructor for the DatasetWriter class, closing the
+         * file if close was not called (errors are ignored).
+        */
+        ~DatasetWriter();
+
+        DatasetWriter(const DatasetWriter&) = delete;
+        DatasetWriter& operator=(const DatasetWriter&) = delete;
+
+        /**
+         * Return the number of vectors appended so far.
+         *
+         * @return The number of vectors.
+        */
+        size_t get_count() const;
+
+        /**
+         * Append a single vector (a Vector converts to a view).
+         *
+         * @param vec The vector, of the dataset's dimension.
+        */
+        void append(const VectorView& vec);
+
+        /**
+         * Append a batch of vectors, stored row by row.
+         *
+         * @param entries The count * dimension components.
+         * @param count The number of vectors.
+        */
+        void append(const double* entries, const size_t count);
+
+        /**
+         * Append every row of a matrix as a vector.
+         *
+         * @param matrix A matrix with as many columns as
+         * the dataset's dimension.
+        */
+        void append(const Matrix& matrix);
+
+        /**
+         * Write the header and close the file. Throws an
+         * IOException if any write failed.
+        */
+        void close();
+    };
+}
+
+#endif
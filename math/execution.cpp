@@ -0,0 +1,77 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "execution.h"
+#include "thread_pool.h"
+#include <atomic>
+
+namespace
+{
+    // Below this many components, waking up the workers
+    // costs more than a single core running the loop.
+    std::atomic<size_t> parallel_threshold(1 << 16);
+
+    // Chunks are never smaller than this, whatever the number
+    // of threads, so that every task amortizes its scheduling.
+    const size_t MIN_GRAIN = 1 << 14;
+
+    size_t grain(size_t size)
+    {
+        // A few chunks per thread leave room for stealing
+        // when some of the workers are busy elsewhere.
+        size_t chunks = 4 * thmath::ThreadPool::get_instance().get_thread_count();
+        size_t grain = (size + chunks - 1) / chunks;
+        return grain < MIN_GRAIN ? MIN_GRAIN : grain;
+    }
+}
+
+size_t thmath::execution::get_parallel_threshold()
+{
+    return parallel_threshold.load(std::memory_order_relaxed);
+}
+
+void thmath::execution::set_parallel_threshold(size_t threshold)
+{
+    parallel_threshold.store(threshold, std::memory_order_relaxed);
+}
+
+bool thmath::execution::is_parallel(Policy policy, size_t size)
+{
+    return policy != Policy::SEQUENTIAL && size >= get_parallel_threshold();
+}
+
+void thmath::execution::parallel_for(size_t size, const std::function<void(size_t, size_t)>& body)
+{
+    ThreadPool::get_instance().parallel_for(0, size, grain(size), body);
+}
+
+std::vector<double> thmath::execution::map_chunks(size_t size, const std::function<double(size_t, size_t)>& body)
+{
+    size_t chunk = grain(size);
+    std::vector<double> results(size == 0 ? 0 : (size + chunk - 1) / chunk);
+    ThreadPool::get_instance().parallel_for(0, size, chunk, [&](size_t begin, size_t end) {
+        results[begin / chunk] = body(begin, end);
+    });
+    return results;
+}
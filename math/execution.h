@@ -0,0 +1,111 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#ifndef __THMATH_EXECUTION_
+#define __THMATH_EXECUTION_
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace thmath
+{
+    /**
+     * Execution policies for the vector algorithms, after the
+     * ones of <execution>. Parallel algorithms split the vector
+     * into contiguous chunks which are run on the library thread
+     * pool (see ThreadPool); vectors shorter than the parallel
+     * threshold are always processed on the calling thread, since
+     * waking the workers costs more than the loop itself.
+     *
+     * The kernels running over each chunk are vectorized in every
+     * case, so PARALLEL and PARALLEL_UNSEQUENCED currently behave
+     * the same; the distinction is kept for parity with std.
+    */
+    namespace execution
+    {
+        enum class Policy
+        {
+            SEQUENTIAL,
+            PARALLEL,
+            PARALLEL_UNSEQUENCED
+        };
+
+        constexpr Policy seq = Policy::SEQUENTIAL;
+        constexpr Policy par = Policy::PARALLEL;
+        constexpr Policy par_unseq = Policy::PARALLEL_UNSEQUENCED;
+
+        /**
+         * Return the number of components below which
+         * the parallel policies run sequentially.
+         *
+         * @return The parallel threshold.
+        */
+        size_t get_parallel_threshold();
+
+        /**
+         * Set the number of components below which
+         * the parallel policies run sequentially.
+         *
+         * @param threshold The new parallel threshold.
+        */
+        void set_parallel_threshold(size_t threshold);
+
+        /**
+         * Check whether an algorithm over the given number
+         * of components shall run in parallel.
+         *
+         * @param policy The requested execution policy.
+         * @param size The number of components.
+         * @return Whether the work is split across threads.
+        */
+        bool is_parallel(Policy policy, size_t size);
+
+        /**
+         * Run body over [0, size), split into contiguous chunks
+         * which are processed by the library thread pool.
+         *
+         * @param size The number of components.
+         * @param body The function run over every chunk, given
+         * the bounds [begin, end) of the chunk.
+        */
+        void parallel_for(size_t size, const std::function<void(size_t, size_t)>& body);
+
+        /**
+         * Evaluate body over every chunk of [0, size), in parallel,
+         * and return the results in chunk order. The chunks only
+         * depend on size and on the number of threads, so reductions
+         * over them are reproducible from one call to the next.
+         *
+         * @param size The number of components.
+         * @param body The function evaluated over every chunk.
+         * @return The value of body for every chunk.
+        */
+        std::vector<double> map_chunks(size_t size, const std::function<double(size_t, size_t)>& body);
+    }
+}
+
+#endif
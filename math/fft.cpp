@@ -0,0 +1,527 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "fft.h"
+#include "../exception/illegal_size_exception.h"
+#include "../exception/messages.h"
+#include <cmath>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    using cpx = std::complex<double>;
+
+    const double PI = 3.14159265358979323846;
+
+    // Plain complex product: std::complex's operator* goes through
+    // the (slow) C99 Annex G NaN recovery when not built with
+    // -ffast-math, which the butterflies do not need.
+    inline cpx multiply(cpx a, cpx b)
+    {
+        return cpx(
+            a.real() * b.real() - a.imag() * b.imag(),
+            a.real() * b.imag() + a.imag() * b.real()
+        );
+    }
+
+    inline cpx conjugate_if(cpx a, bool inverse)
+    {
+        return inverse ? std::conj(a) : a;
+    }
+
+    // The workspace of the transforms called without one, reused
+    // across calls (of any plan) to avoid allocating.
+    thmath::FftWorkspace& thread_workspace()
+    {
+        thread_local thmath::FftWorkspace workspace;
+        return workspace;
+    }
+
+    std::vector<cpx>& grown(std::vector<cpx>& buffer, size_t size)
+    {
+        if (buffer.size() < size)
+        {
+            buffer.resize(size);
+        }
+        return buffer;
+    }
+
+    // Least recently used cache: the plans, most recent first,
+    // and where each size sits in that list.
+    using PlanList = std::list<std::shared_ptr<const thmath::FftPlan>>;
+
+    std::mutex plans_mutex;
+    PlanList plans;
+    std::unordered_map<size_t, PlanList::iterator> plan_positions;
+}
+
+thmath::FftPlan::FftPlan(size_t size) : size(size), power_of_two(size > 0 && (size & (size - 1)) == 0)
+{
+    if (size == 0)
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+    this->twiddles.resize(size / 2);
+    for (size_t k = 0; k < size / 2; k++)
+    {
+        double angle = -2.0 * PI * static_cast<double>(k) / static_cast<double>(size);
+        this->twiddles[k] = cpx(std::cos(angle), std::sin(angle));
+    }
+
+    if (this->power_of_two)
+    {
+        this->bit_reverse.resize(size);
+        unsigned int bits = 0;
+        while ((size_t(1) << bits) < size)
+        {
+            bits++;
+        }
+        for (size_t index = 0; index < size; index++)
+        {
+            uint32_t reversed = 0;
+            for (unsigned int bit = 0; bit < bits; bit++)
+            {
+                reversed |= ((index >> bit) & 1u) << (bits - 1 - bit);
+            }
+            this->bit_reverse[index] = reversed;
+        }
+        return;
+    }
+
+    size_t padded = 1;
+    while (padded < 2 * size - 1)
+    {
+        padded <<= 1;
+    }
+    this->convolution = get(padded);
+    this->chirp.resize(size);
+    for (size_t k = 0; k < size; k++)
+    {
+        // k^2 mod 2n keeps the angle small, hence accurate.
+        size_t square = (k * k) % (2 * size);
+        double angle = -PI * static_cast<double>(square) / static_cast<double>(size);
+        this->chirp[k] = cpx(std::cos(angle), std::sin(angle));
+    }
+    this->kernel.assign(padded, cpx(0.0, 0.0));
+    this->kernel[0] = std::conj(this->chirp[0]);
+    for (size_t k = 1; k < size; k++)
+    {
+        this->kernel[k] = std::conj(this->chirp[k]);
+        this->kernel[padded - k] = std::conj(this->chirp[k]);
+    }
+    this->convolution->transform_power_of_two(this->kernel.data(), false);
+}
+
+std::shared_ptr<const thmath::FftPlan> thmath::FftPlan::get(size_t size)
+{
+    {
+        std::lock_guard<std::mutex> lock(plans_mutex);
+        auto found = plan_positions.find(size);
+        if (found != plan_positions.end())
+        {
+            plans.splice(plans.begin(), plans, found->second);
+            return plans.front();
+        }
+    }
+    // Built outside of the lock, since a plan may need another one.
+    auto plan = std::make_shared<const FftPlan>(size);
+    std::lock_guard<std::mutex> lock(plans_mutex);
+    auto found = plan_positions.find(size);
+    if (found != plan_positions.end())
+    {
+        // Another thread built it in the meantime.
+        plans.splice(plans.begin(), plans, found->second);
+        return plans.front();
+    }
+    plans.push_front(plan);
+    plan_positions[size] = plans.begin();
+    if (plans.size() > FFT_PLAN_CACHE_CAPACITY)
+    {
+        plan_positions.erase(plans.back()->size);
+        plans.pop_back();
+    }
+    return plan;
+}
+
+void thmath::FftPlan::clear_cache()
+{
+    std::lock_guard<std::mutex> lock(plans_mutex);
+    plan_positions.clear();
+    plans.clear();
+}
+
+const thmath::FftPlan& thmath::FftPlan::half_plan() const
+{
+    std::call_once(this->half_once, [this]()
+    {
+        this->half = get(this->size / 2);
+    });
+    return *this->half;
+}
+
+size_t thmath::FftPlan::get_size() const
+{
+    return this->size;
+}
+
+void thmath::FftPlan::reserve(FftWorkspace& workspace) const
+{
+    grown(workspace.staging, this->size);
+    if (!this->power_of_two)
+    {
+        grown(workspace.padded, this->convolution->size);
+    }
+    if (this->size % 2 == 0 && this->size > 1)
+    {
+        // The real transforms run a complex one of half the size.
+        const FftPlan& half = half_plan();
+        if (!half.power_of_two)
+        {
+            grown(workspace.padded, half.convolution->size);
+        }
+    }
+}
+
+void thmath::FftPlan::transform(cpx* data, bool inverse, FftWorkspace& workspace) const
+{
+    if (this->power_of_two)
+    {
+        transform_power_of_two(data, inverse);
+    }
+    else
+    {
+        transform_bluestein(data, inverse, workspace);
+    }
+}
+
+void thmath::FftPlan::transform_power_of_two(cpx* data, bool inverse) const
+{
+    const size_t n = this->size;
+    for (size_t index = 0; index < n; index++)
+    {
+        size_t reversed = this->bit_reverse[index];
+        if (index < reversed)
+        {
+            std::swap(data[index], data[reversed]);
+        }
+    }
+
+    // Half-size of the butterflies of the next stage.
+    size_t m = 1;
+    size_t levels = 0;
+    while ((size_t(1) << levels) < n)
+    {
+        levels++;
+    }
+    if (levels % 2 == 1)
+    {
+        for (size_t index = 0; index < n; index += 2)
+        {
+            cpx a = data[index];
+            cpx b = data[index + 1];
+            data[index] = a + b;
+            data[index + 1] = a - b;
+        }
+        m = 2;
+    }
+
+    // Two radix-2 stages (spans m and 2m) at a time: the four
+    // values x[j], x[j + m], x[j + 2m], x[j + 3m] of every group
+    // are loaded once and combined in registers.
+    const cpx rotation = inverse ? cpx(0.0, 1.0) : cpx(0.0, -1.0);
+    for (; m < n; m *= 4)
+    {
+        size_t stride_inner = n / (2 * m);
+        size_t stride_outer = n / (4 * m);
+        for (size_t group = 0; group < n; group += 4 * m)
+        {
+            cpx* x = data + group;
+            for (size_t j = 0; j < m; j++)
+            {
+                cpx w_inner = conjugate_if(this->twiddles[j * stride_inner], inverse);
+                cpx w_outer = conjugate_if(this->twiddles[j * stride_outer], inverse);
+                cpx a = x[j];
+                cpx b = multiply(x[j + m], w_inner);
+                cpx c = x[j + 2 * m];
+                cpx d = multiply(x[j + 3 * m], w_inner);
+                cpx sum_ab = a + b;
+                cpx difference_ab = a - b;
+                cpx sum_cd = multiply(c + d, w_outer);
+                cpx difference_cd = multiply(multiply(c - d, w_outer), rotation);
+                x[j] = sum_ab + sum_cd;
+                x[j + 2 * m] = sum_ab - sum_cd;
+                x[j + m] = difference_ab + difference_cd;
+                x[j + 3 * m] = difference_ab - difference_cd;
+            }
+        }
+    }
+}
+
+void thmath::FftPlan::transform_bluestein(cpx* data, bool inverse, FftWorkspace& workspace) const
+{
+    // X_k = conj(w_k) * sum(x_j * conj(w_j) * w_(k - j)) with
+    // w_k = e^(pi i k^2 / n): a convolution, done by FFT.
+    const size_t n = this->size;
+    const size_t padded = this->convolution->size;
+    std::vector<cpx>& buffer = grown(workspace.padded, padded);
+    cpx* a = buffer.data();
+    for (size_t k = 0; k < n; k++)
+    {
+        a[k] = multiply(conjugate_if(data[k], inverse), this->chirp[k]);
+    }
+    std::fill(a + n, a + padded, cpx(0.0, 0.0));
+    this->convolution->transform_power_of_two(a, false);
+    for (size_t k = 0; k < padded; k++)
+    {
+        a[k] = multiply(a[k], this->kernel[k]);
+    }
+    this->convolution->transform_power_of_two(a, true);
+    double scale = 1.0 / static_cast<double>(padded);
+    for (size_t k = 0; k < n; k++)
+    {
+        data[k] = conjugate_if(multiply(a[k], this->chirp[k]) * scale, inverse);
+    }
+}
+
+void thmath::FftPlan::forward(const Complex* input, Complex* output) const
+{
+    forward(input, output, thread_workspace());
+}
+
+void thmath::FftPlan::forward(const Complex* input, Complex* output, FftWorkspace& workspace) const
+{
+    std::vector<cpx>& buffer = grown(workspace.staging, this->size);
+    for (size_t k = 0; k < this->size; k++)
+    {
+        buffer[k] = cpx(input[k].get_real(), input[k].get_imaginary());
+    }
+    transform(buffer.data(), false, workspace);
+    for (size_t k = 0; k < this->size; k++)
+    {
+        output[k] = Complex(buffer[k].real(), buffer[k].imag());
+    }
+}
+
+void thmath::FftPlan::inverse(const Complex* input, Complex* output) const
+{
+    inverse(input, output, thread_workspace());
+}
+
+void thmath::FftPlan::inverse(const Complex* input, Complex* output, FftWorkspace& workspace) const
+{
+    std::vector<cpx>& buffer = grown(workspace.staging, this->size);
+    for (size_t k = 0; k < this->size; k++)
+    {
+        buffer[k] = cpx(input[k].get_real(), input[k].get_imaginary());
+    }
+    transform(buffer.data(), true, workspace);
+    double scale = 1.0 / static_cast<double>(this->size);
+    for (size_t k = 0; k < this->size; k++)
+    {
+        output[k] = Complex(buffer[k].real() * scale, buffer[k].imag() * scale);
+    }
+}
+
+void thmath::FftPlan::forward_real(const double* input, Complex* output) const
+{
+    forward_real(input, output, thread_workspace());
+}
+
+void thmath::FftPlan::forward_real(const double* input, Complex* output, FftWorkspace& workspace) const
+{
+    const size_t n = this->size;
+    if (n % 2 == 1)
+    {
+        std::vector<cpx>& buffer = grown(workspace.staging, n);
+        for (size_t k = 0; k < n; k++)
+        {
+            buffer[k] = cpx(input[k], 0.0);
+        }
+        transform(buffer.data(), false, workspace);
+        for (size_t k = 0; k <= n / 2; k++)
+        {
+            output[k] = Complex(buffer[k].real(), buffer[k].imag());
+        }
+        return;
+    }
+
+    // z_j = x_2j + i x_(2j+1); its spectrum Z gives the spectra
+    // of the even (E) and odd (O) samples, and X_k = E_k + w^k O_k.
+    const size_t half = n / 2;
+    std::vector<cpx>& buffer = grown(workspace.staging, half);
+    cpx* z = buffer.data();
+    for (size_t j = 0; j < half; j++)
+    {
+        z[j] = cpx(input[2 * j], input[2 * j + 1]);
+    }
+    half_plan().transform(z, false, workspace);
+    for (size_t k = 0; k <= half; k++)
+    {
+        cpx z_k = z[k % half];
+        cpx z_mirror = std::conj(z[(half - k) % half]);
+        cpx even = (z_k + z_mirror) * 0.5;
+        cpx difference = (z_k - z_mirror) * 0.5;
+        cpx odd(difference.imag(), -difference.real());
+        cpx twiddle = k < half ? this->twiddles[k] : cpx(-1.0, 0.0);
+        cpx bin = even + multiply(twiddle, odd);
+        output[k] = Complex(bin.real(), bin.imag());
+    }
+}
+
+void thmath::FftPlan::inverse_real(const Complex* input, double* output) const
+{
+    inverse_real(input, output, thread_workspace());
+}
+
+void thmath::FftPlan::inverse_real(const Complex* input, double* output, FftWorkspace& workspace) const
+{
+    const size_t n = this->size;
+    if (n % 2 == 1)
+    {
+        std::vector<cpx>& buffer = grown(workspace.staging, n);
+        for (size_t k = 0; k <= n / 2; k++)
+        {
+            buffer[k] = cpx(input[k].get_real(), input[k].get_imaginary());
+        }
+        for (size_t k = n / 2 + 1; k < n; k++)
+        {
+            buffer[k] = std::conj(buffer[n - k]);
+        }
+        transform(buffer.data(), true, workspace);
+        double scale = 1.0 / static_cast<double>(n);
+        for (size_t k = 0; k < n; k++)
+        {
+            output[k] = buffer[k].real() * scale;
+        }
+        return;
+    }
+
+    // Undo the split: E_k and O_k are recovered from X_k and
+    // conj(X_(n/2 - k)), and Z_k = E_k + i O_k.
+    const size_t half = n / 2;
+    std::vector<cpx>& buffer = grown(workspace.staging, half);
+    cpx* z = buffer.data();
+    for (size_t k = 0; k < half; k++)
+    {
+        cpx x_k(input[k].get_real(), input[k].get_imaginary());
+        cpx x_mirror(input[half - k].get_real(), -input[half - k].get_imaginary());
+        cpx even = (x_k + x_mirror) * 0.5;
+        cpx odd = multiply((x_k - x_mirror) * 0.5, std::conj(this->twiddles[k]));
+        z[k] = cpx(even.real() - odd.imag(), even.imag() + odd.real());
+    }
+    half_plan().transform(z, true, workspace);
+    double scale = 1.0 / static_cast<double>(half);
+    for (size_t j = 0; j < half; j++)
+    {
+        output[2 * j] = z[j].real() * scale;
+        output[2 * j + 1] = z[j].imag() * scale;
+    }
+}
+
+std::vector<thmath::Complex> thmath::fft::forward(const std::vector<Complex>& input)
+{
+    std::vector<Complex> output(input.size(), Complex(0, 0));
+    if (!input.empty())
+    {
+        FftPlan::get(input.size())->forward(input.data(), output.data());
+    }
+    return output;
+}
+
+std::vector<thmath::Complex> thmath::fft::inverse(const std::vector<Complex>& input)
+{
+    std::vector<Complex> output(input.size(), Complex(0, 0));
+    if (!input.empty())
+    {
+        FftPlan::get(input.size())->inverse(input.data(), output.data());
+    }
+    return output;
+}
+
+void thmath::fft::forward_in_place(std::vector<Complex>& data)
+{
+    if (!data.empty())
+    {
+        FftPlan::get(data.size())->forward(data.data(), data.data());
+    }
+}
+
+void thmath::fft::inverse_in_place(std::vector<Complex>& data)
+{
+    if (!data.empty())
+    {
+        FftPlan::get(data.size())->inverse(data.data(), data.data());
+    }
+}
+
+std::vector<thmath::Complex> thmath::fft::forward_real(const std::vector<double>& input)
+{
+    if (input.empty())
+    {
+        return std::vector<Complex>();
+    }
+    std::vector<Complex> output(input.size() / 2 + 1, Complex(0, 0));
+    FftPlan::get(input.size())->forward_real(input.data(), output.data());
+    return output;
+}
+
+std::vector<double> thmath::fft::inverse_real(const std::vector<Complex>& input, size_t size)
+{
+    if (size == 0)
+    {
+        return std::vector<double>();
+    }
+    if (input.size() != size / 2 + 1)
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+    std::vector<double> output(size);
+    FftPlan::get(size)->inverse_real(input.data(), output.data());
+    return output;
+}
+
+std::vector<thmath::Complex> thmath::fft::dft(const std::vector<Complex>& input, bool inverse)
+{
+    const size_t n = input.size();
+    double sign = inverse ? 1.0 : -1.0;
+    double scale = inverse && n > 0 ? 1.0 / static_cast<double>(n) : 1.0;
+    std::vector<Complex> output(n, Complex(0, 0));
+    for (size_t k = 0; k < n; k++)
+    {
+        double real = 0.0;
+        double imaginary = 0.0;
+        for (size_t j = 0; j < n; j++)
+        {
+            double angle = sign * 2.0 * PI * static_cast<double>((j * k) % n) / static_cast<double>(n);
+            double c = std::cos(angle);
+            double s = std::sin(angle);
+            real += input[j].get_real() * c - input[j].get_imaginary() * s;
+            imaginary += input[j].get_real() * s + input[j].get_imaginary() * c;
+        }
+        output[k] = Complex(real * scale, imaginary * scale);
+    }
+    return output;
+}
@@ -0,0 +1,250 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#ifndef __THMATH_FFT_
+#define __THMATH_FFT_
+
+#include "complex.h"
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace thmath
+{
+    // The number of plans kept by FftPlan::get().
+    constexpr size_t FFT_PLAN_CACHE_CAPACITY = 32;
+
+    class FftPlan;
+
+    /**
+     * Scratch memory of the transforms: the staged values, and
+     * the zero-padded sequence of Bluestein's convolution. The
+     * transforms called without a workspace use one owned by the
+     * calling thread; an object which runs transforms from any
+     * thread, and must not allocate while doing so, keeps its own
+     * workspace, sized once by FftPlan::reserve.
+    */
+    class FftWorkspace
+    {
+    private:
+        friend class FftPlan;
+
+        std::vector<std::complex<double>> staging;
+        std::vector<std::complex<double>> padded;
+    };
+
+    /**
+     * Precomputed plan for discrete Fourier transforms of a given
+     * size. Power-of-two sizes run an iterative decimation-in-time
+     * FFT whose radix-2 stages are fused pairwise into radix-4
+     * butterflies (with one radix-2 stage when log2(size) is odd);
+     * any other size goes through Bluestein's algorithm, i.e. a
+     * convolution computed with a power-of-two FFT.
+     *
+     * Plans are immutable once built, so one plan may be used by
+     * several threads at once; get() caches them by size. The cache
+     * keeps the FFT_PLAN_CACHE_CAPACITY most recently requested
+     * plans (and clear_cache() empties it); an evicted plan stays
+     * valid for as long as somebody holds it.
+     *
+     * The forward transform is X_k = sum(x_j * e^(-2 pi i j k / n)),
+     * and the inverse one is scaled by 1/n, so that it undoes it.
+    */
+    class FftPlan
+    {
+    private:
+        size_t size;
+        bool power_of_two;
+        // e^(-2 pi i k / size) for k in [0, size / 2).
+        std::vector<std::complex<double>> twiddles;
+        std::vector<uint32_t> bit_reverse;
+        // Bluestein's chirp e^(-pi i k^2 / size), the transformed
+        // convolution kernel, and the plan for the convolution.
+        std::vector<std::complex<double>> chirp;
+        std::vector<std::complex<double>> kernel;
+        std::shared_ptr<const FftPlan> convolution;
+        // The complex plan of size / 2 run by the real transforms of
+        // even sizes, looked up on first use and then held.
+        mutable std::once_flag half_once;
+        mutable std::shared_ptr<const FftPlan> half;
+
+        const FftPlan& half_plan() const;
+        void transform(std::complex<double>* data, bool inverse, FftWorkspace& workspace) const;
+        void transform_power_of_two(std::complex<double>* data, bool inverse) const;
+        void transform_bluestein(std::complex<double>* data, bool inverse, FftWorkspace& workspace) const;
+
+    public:
+        /**
+         * Constructor for the FftPlan class, precomputing the
+         * twiddle factors (and Bluestein's kernel) for a size.
+         * Prefer get(), which shares plans between callers.
+         *
+         * @param size The size of the transforms, at least 1.
+         * @return A new plan.
+        */
+        explicit FftPlan(const size_t size);
+
+        /**
+         * Return the cached plan for the given size,
+         * building it on first use.
+         *
+         * @param size The size of the transforms.
+         * @return The shared plan.
+        */
+        static std::shared_ptr<const FftPlan> get(const size_t size);
+
+        /**
+         * Drop every cached plan. The plans still held by
+         * callers stay valid.
+        */
+        static void clear_cache();
+
+        /**
+         * Return the size of the transforms of this plan.
+         *
+         * @return The size.
+        */
+        size_t get_size() const;
+
+        /**
+         * Grow a workspace so that no transform of this plan
+         * (complex or real) allocates when given it.
+         *
+         * @param workspace The workspace which shall be sized.
+        */
+        void reserve(FftWorkspace& workspace) const;
+
+        /**
+         * Forward transform of get_size() values. The input and
+         * output may be the same array (in-place transform). Each
+         * transform may be given the workspace it shall use.
+         *
+         * @param input The values which shall be transformed.
+         * @param output The array receiving the spectrum.
+        */
+        void forward(const Complex* input, Complex* output) const;
+        void forward(const Complex* input, Complex* output, FftWorkspace& workspace) const;
+
+        /**
+         * Inverse transform of get_size() values, scaled by 1/n.
+         * The input and output may be the same array.
+         *
+         * @param input The spectrum which shall be transformed.
+         * @param output The array receiving the values.
+        */
+        void inverse(const Complex* input, Complex* output) const;
+        void inverse(const Complex* input, Complex* output, FftWorkspace& workspace) const;
+
+        /**
+         * Forward transform of get_size() real values. By the
+         * Hermitian symmetry of the spectrum, only the bins
+         * [0, n / 2] are returned. For even sizes, the values
+         * are packed into a complex transform of half the size,
+         * which halves the cost.
+         *
+         * @param input The get_size() real values.
+         * @param output The array receiving the n / 2 + 1 bins.
+        */
+        void forward_real(const double* input, Complex* output) const;
+        void forward_real(const double* input, Complex* output, FftWorkspace& workspace) const;
+
+        /**
+         * Inverse of forward_real, scaled by 1/n.
+         *
+         * @param input The n / 2 + 1 bins of a Hermitian spectrum.
+         * @param output The array receiving the get_size() values.
+        */
+        void inverse_real(const Complex* input, double* output) const;
+        void inverse_real(const Complex* input, double* output, FftWorkspace& workspace) const;
+    };
+
+    namespace fft
+    {
+        /**
+         * Out-of-place forward transform, using the cached plan.
+         *
+         * @param input The values which shall be transformed.
+         * @return The spectrum.
+        */
+        std::vector<Complex> forward(const std::vector<Complex>& input);
+
+        /**
+         * Out-of-place inverse transform (scaled by 1/n),
+         * using the cached plan.
+         *
+         * @param input The spectrum which shall be transformed.
+         * @return The values.
+        */
+        std::vector<Complex> inverse(const std::vector<Complex>& input);
+
+        /**
+         * In-place forward transform, using the cached plan.
+         *
+         * @param data The values, overwritten by their spectrum.
+        */
+        void forward_in_place(std::vector<Complex>& data);
+
+        /**
+         * In-place inverse transform (scaled by 1/n),
+         * using the cached plan.
+         *
+         * @param data The spectrum, overwritten by the values.
+        */
+        void inverse_in_place(std::vector<Complex>& data);
+
+        /**
+         * Forward transform of real values.
+         *
+         * @param input The real values.
+         * @return The input.size() / 2 + 1 first bins.
+        */
+        std::vector<Complex> forward_real(const std::vector<double>& input);
+
+        /**
+         * Inverse transform of a Hermitian spectrum.
+         *
+         * @param input The size / 2 + 1 first bins.
+         * @param size The number of real values.
+         * @return The real values.
+        */
+        std::vector<double> inverse_real(const std::vector<Complex>& input, const size_t size);
+
+        /**
+         * Naive O(n^2) discrete Fourier transform, kept
+         * as a reference for the fast transforms.
+         *
+         * @param input The values which shall be transformed.
+         * @param inverse Whether to compute the inverse
+         * (scaled) transform instead.
+         * @return The transformed values.
+        */
+        std::vector<Complex> dft(const std::vector<Complex>& input, bool inverse = false);
+    }
+}
+
+#endif
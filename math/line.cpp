@@ -23,111 +23,110 @@
 
 #include "line.h"
 #include "vector.h"
+#include "predicates.h"
+#include "../exception/illegal_size_exception.h"
+#include "../exception/messages.h"
 #include <cmath>
 #include <stdexcept>
 #include <sstream>
 
-thmath::Line::Line(const thmath::Vector& point_a, const thmath::Vector& point_b)
+thmath::Vec3 thmath::Line::promote(const thmath::Vector& point)
 {
-    auto direction = point_b - point_a;
-    this->position_a = new thmath::Vector(point_a.get_size(), point_a.get_entries());
-    this->direction = new thmath::Vector(direction.get_size(), direction.get_entries());
+    if (point.get_size() == 2)
+    {
+        return Vec3(point.get_component(0), point.get_component(1), 0.0);
+    }
+    if (point.get_size() != 3)
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+    return Vec3(point);
 }
 
-thmath::Line::~Line()
+thmath::Line::Line(const thmath::Vector& point_a, const thmath::Vector& point_b)
+    : position_a(promote(point_a)), position_b(promote(point_b)), direction(position_b - position_a)
 {
-    delete this->position_a;
-    delete this->direction;
+
 }
 
-thmath::Vector thmath::Line::get_direction() const
+bool thmath::Line::contains(const thmath::Vec3& point) const
 {
-    return *this->direction;
+    return predicates::collinear(this->position_a, this->position_b, point);
 }
 
-thmath::Vector thmath::Line::get_point(double lambda) const
+bool thmath::Line::contains(const thmath::Vector& point) const
 {
-    return (*this->position_a) + (*this->direction * lambda);
+    return contains(promote(point));
 }
 
-bool thmath::Line::contains(const thmath::Vector& point) const
+double thmath::Line::distance(const thmath::Vec3& point) const
 {
-    auto potential_direction = point - *this->position_a;
-    return potential_direction.is_parallel(point);
+    thmath::Vec3 diff = (point - this->position_a).vector_product(this->direction);
+    return (diff *= (1 / this->direction.norm())).norm();
 }
 
 double thmath::Line::distance(const thmath::Vector& point) const
 {
-    auto diff = point - *this->position_a;
-    diff = diff.vector_product(*this->direction);
-    return (diff *= (1 / this->direction->norm())).norm();
+    return distance(promote(point));
+}
+
+double thmath::Line::distance(const thmath::Vec3& point, double lower, double upper) const
+{
+    double lambda = (point - this->position_a).dot_product(this->direction) / this->direction.norm_squared();
+    if (lambda >= lower && lambda <= upper)
+    {
+        return distance(point);
+    }
+    return (point - get_point(lambda < lower ? lower : upper)).norm();
 }
 
 double thmath::Line::distance(const thmath::Line& line) const
 {
     if (is_parallel(line))
     {
-        return distance(*line.position_a);
+        return distance(line.position_a);
     }
 
-    auto normal = (*this->direction).vector_product(*line.direction).normalized();
-    auto diff = *this->position_a - *line.position_a;
+    auto normal = this->direction.vector_product(line.direction).normalized();
+    thmath::Vec3 diff = this->position_a - line.position_a;
     return std::abs(
         diff.dot_product(normal)
     );
 }
 
-thmath::Vector thmath::Line::intersect(const Line& line) const
+thmath::Vec3 thmath::Line::intersect(const Line& line) const
 {
     if (is_parallel(line))
     {
         throw std::exception();
     }
 
-    Vector positionDifference = *line.position_a - *position_a;
-    Vector crossProduct1 = positionDifference.vector_product(line.get_direction());
-    Vector crossProduct2 = direction->vector_product(line.get_direction());
-    double lambda = crossProduct1.dot_product(crossProduct2) / std::pow(crossProduct2.norm(), 2);
-
+    Vec3 positionDifference = line.position_a - this->position_a;
+    Vec3 crossProduct1 = positionDifference.vector_product(line.direction);
+    Vec3 crossProduct2 = this->direction.vector_product(line.direction);
+    double lambda = crossProduct1.dot_product(crossProduct2) / crossProduct2.norm_squared();
 
     return get_point(lambda);
 }
 
 bool thmath::Line::is_perpendicular(const Line& line) const
 {
-    return (*this->direction).dot_product(*line.direction) == 0;
+    return predicates::perpendicular(this->position_a, this->position_b, line.position_a, line.position_b);
 }
 
 bool thmath::Line::is_parallel(const Line& line) const
 {
-    return (*this->direction).vector_product(*line.direction) == nullvec3;
-}
-
-thmath::Line::Line(const Line& other) {
-    position_a = new thmath::Vector(*other.position_a);
-    direction = new thmath::Vector(*other.direction);
-}
-
-thmath::Line& thmath::Line::operator=(const thmath::Line& other)
-{
-    if (this != &other)
-    {
-        delete this->position_a;
-        delete this->direction;
-        this->position_a = new thmath::Vector(*other.position_a);
-        this->direction = new thmath::Vector(*other.direction);
-    }
-    return *this;
+    return predicates::parallel(this->position_a, this->position_b, line.position_a, line.position_b);
 }
 
 bool thmath::Line::operator==(const thmath::Line& other) const
 {
-    return is_parallel(other) && contains(*(other.position_a));
+    return is_parallel(other) && contains(other.position_a);
 }
 
 std::string thmath::Line::to_string() const
 {
     std::ostringstream stream;
-    stream << "Line={position_a=" << this->position_a->to_string() << ", direction=" << this->direction->to_string() << "}";
+    stream << "Line={position_a=" << this->position_a.to_string() << ", position_b=" << this->position_b.to_string() << ", direction=" << this->direction.to_string() << "}";
     return stream.str();
-}
\ No newline at end of file
+}
@@ -26,20 +26,38 @@
 #ifndef __THMATH_LINE_
 #define __THMATH_LINE_
 
+#include "vec.h"
 #include "vector.h"
 #include <string>
 
 namespace thmath
 {
     /**
-     * Represents a line in three-dimensional space.
+     * Represents a line in three-dimensional space, through
+     * two points. Both points, and the (rounded) direction between
+     * them, are stored inline, so that a line is a plain 72-byte
+     * value: building, copying or moving one never allocates. The
+     * predicates (contains, is_parallel, is_perpendicular, ==) work
+     * from the two points, so they are exact for the line the user
+     * gave. Lines in the plane are embedded in R^3 with a null
+     * third component.
      */
     class Line
     {
     private:
-        Vector* position_a;  /**< The position vector of a point on the line. */
-        Vector* direction;   /**< The direction vector of the line. */
-        
+        Vec3 position_a;  /**< The position vector of the first point. */
+        Vec3 position_b;  /**< The position vector of the second point. */
+        Vec3 direction;   /**< The direction vector of the line, b - a rounded. */
+
+        /**
+         * Convert a point given as a dynamic vector, promoting
+         * points of R^2 to R^3.
+         *
+         * @param point A vector with 2 or 3 components.
+         * @return The point in R^3.
+        */
+        static Vec3 promote(const Vector& point);
+
     public:
 
         /**
@@ -52,23 +70,60 @@ namespace thmath
         Line(const Vector& point_a, const Vector& point_b);
 
         /**
-         * Copy constructor for the line class.
+         * Constructor for the Line class, between two points
+         * of R^3 (or of the plane).
          * 
-         * @param other The line object to copy from.
+         * @param point_a The first point.
+         * @param point_b The second point.
         */
-       Line(const Line& other);
+        constexpr Line(const Vec3& point_a, const Vec3& point_b)
+            : position_a(point_a), position_b(point_b), direction(point_b - point_a)
+        {
+
+        }
+
+        constexpr Line(const Vec2& point_a, const Vec2& point_b)
+            : position_a(point_a[0], point_a[1], 0.0),
+              position_b(point_b[0], point_b[1], 0.0),
+              direction(point_b[0] - point_a[0], point_b[1] - point_a[1], 0.0)
+        {
+
+        }
+
+        Line(const Line& other) = default;
+        Line(Line&& other) = default;
+        Line& operator=(const Line& other) = default;
+        Line& operator=(Line&& other) = default;
 
         /**
-         * Destructor for the Line class.
+         * Get the point the line was built from.
+         * 
+         * @return The position vector of the first point.
          */
-        ~Line();
+        const Vec3& get_position() const
+        {
+            return this->position_a;
+        }
+
+        /**
+         * Get the second point the line was built from.
+         * 
+         * @return The position vector of the second point.
+         */
+        const Vec3& get_second_position() const
+        {
+            return this->position_b;
+        }
 
         /**
          * Get the direction vector of the line.
          * 
          * @return The direction vector of the line.
          */
-        Vector get_direction() const;
+        const Vec3& get_direction() const
+        {
+            return this->direction;
+        }
 
         /**
          * Get a point on the line corresponding to a parameter lambda.
@@ -76,14 +131,19 @@ namespace thmath
          * @param lambda The parameter representing a point on the line.
          * @return A vector representing a point on the line.
          */
-        Vector get_point(double lambda) const;
+        Vec3 get_point(double lambda) const
+        {
+            return this->position_a + this->direction * lambda;
+        }
 
         /**
-         * Check if a point lies on the line.
+         * Check if a point lies on the line. The test is
+         * exact (see predicates::collinear).
          * 
          * @param point The point to check.
          * @return True if the point lies on the line, false otherwise.
          */
+        bool contains(const Vec3& point) const;
         bool contains(const Vector& point) const;
 
         /**
@@ -92,8 +152,23 @@ namespace thmath
          * @param point The point to calculate the distance to.
          * @return The distance between the point and the line.
          */
+        double distance(const Vec3& point) const;
         double distance(const Vector& point) const;
 
+        /**
+         * Calculate the distance between a point and the part
+         * of the line whose parameters (as in get_point) lie in
+         * [lower, upper]: the segment between the two points the
+         * line was built from is [0, 1], the ray from the first
+         * one is [0, infinity).
+         * 
+         * @param point The point to calculate the distance to.
+         * @param lower The lowest parameter, possibly -infinity.
+         * @param upper The highest parameter, possibly infinity.
+         * @return The distance between the point and the part of the line.
+         */
+        double distance(const Vec3& point, double lower, double upper) const;
+
         /**
          * Calculate the shortest distance between two lines.
          * 
@@ -108,10 +183,11 @@ namespace thmath
          * @param line The other line to intersect with.
          * @return The point of intersection between the two lines.
          */
-        Vector intersect(const Line& line) const;
+        Vec3 intersect(const Line& line) const;
 
         /**
-         * Check if this line is perpendicular to another line.
+         * Check if this line is perpendicular to another line,
+         * exactly (see predicates::perpendicular).
          * 
          * @param line The other line to check against.
          * @return True if this line is perpendicular to the other line, false otherwise.
@@ -119,21 +195,14 @@ namespace thmath
         bool is_perpendicular(const Line& line) const;
 
         /**
-         * Check if this line is parallel to another line.
+         * Check if this line is parallel to another line,
+         * exactly (see predicates::parallel).
          * 
          * @param line The other line to check against.
          * @return True if this line is parallel to the other line, false otherwise.
          */
         bool is_parallel(const Line& line) const;
 
-        /**
-         * Assignment operator overload for the line class
-         * 
-         * @param other The object to assign from.
-         * @return A reference to the assigned object.
-        */
-        Line& operator=(const Line& other);
-
         /**
          * Equality operator overloading between
          * two lines.
@@ -153,6 +222,8 @@ namespace thmath
         */
         std::string to_string() const;
     };
+
+    static_assert(std::is_trivially_copyable<Line>::value, "Line must stay trivially copyable.");
 }
 
 #endif
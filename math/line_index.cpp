@@ -0,0 +1,371 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "line_index.h"
+#include "thread_pool.h"
+#include "../exception/illegal_access_exception.h"
+#include "../exception/messages.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace
+{
+    const size_t LEAF_SIZE = 4;
+    const size_t MAX_DEPTH = 64;
+    // A query costs about as much as this many vector components
+    // (for the parallel threshold); batches are scheduled in chunks
+    // of QUERY_GRAIN queries.
+    const size_t QUERY_COST = 256;
+    const size_t QUERY_GRAIN = 64;
+    const double INFINITE = std::numeric_limits<double>::infinity();
+
+    // Component of a + t d, where an infinite t does not move
+    // the components along which the direction is null.
+    double coordinate(double position, double direction, double t)
+    {
+        return std::isinf(t) && direction == 0.0 ? position : position + t * direction;
+    }
+
+    double box_distance_squared(const double* lower, const double* upper, const thmath::Vec3& point)
+    {
+        double result = 0.0;
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            double gap = std::max(std::max(lower[axis] - point[axis], point[axis] - upper[axis]), 0.0);
+            result += gap * gap;
+        }
+        return result;
+    }
+
+    thmath::Vec3 point_of(const thmath::VectorBatch& points, size_t index)
+    {
+        return thmath::Vec3(points.get_x()[index], points.get_y()[index], points.get_z()[index]);
+    }
+
+    void run_queries(size_t count, thmath::execution::Policy policy, const std::function<void(size_t, size_t)>& body)
+    {
+        if (thmath::execution::is_parallel(policy, count * QUERY_COST))
+        {
+            thmath::ThreadPool::get_instance().parallel_for(0, count, QUERY_GRAIN, body);
+        }
+        else
+        {
+            body(0, count);
+        }
+    }
+}
+
+thmath::LineIndex::LineIndex() : built(0)
+{
+
+}
+
+thmath::LineIndex::LineIndex(const std::vector<Line>& lines, LineExtent extent) : built(0)
+{
+    this->lines.reserve(lines.size());
+    this->lower_parameters.reserve(lines.size());
+    this->upper_parameters.reserve(lines.size());
+    for (const Line& line : lines)
+    {
+        add(line, extent);
+    }
+    build();
+}
+
+size_t thmath::LineIndex::add(const Line& line, LineExtent extent)
+{
+    switch (extent)
+    {
+        case LineExtent::SEGMENT:
+            return add(line, 0.0, 1.0);
+        case LineExtent::RAY:
+            return add(line, 0.0, INFINITE);
+        default:
+            return add(line, -INFINITE, INFINITE);
+    }
+}
+
+size_t thmath::LineIndex::add(const Line& line, double lower, double upper)
+{
+    this->lines.push_back(line);
+    this->lower_parameters.push_back(lower);
+    this->upper_parameters.push_back(upper);
+    return this->lines.size() - 1;
+}
+
+void thmath::LineIndex::build()
+{
+    const size_t count = this->lines.size();
+    std::vector<Node> boxes(count);
+    std::vector<Vec3> centroids(count);
+    for (size_t index = 0; index < count; index++)
+    {
+        const Vec3& position = this->lines[index].get_position();
+        const Vec3& direction = this->lines[index].get_direction();
+        double lower = this->lower_parameters[index];
+        double upper = this->upper_parameters[index];
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            double from = coordinate(position[axis], direction[axis], lower);
+            double to = coordinate(position[axis], direction[axis], upper);
+            boxes[index].lower[axis] = std::min(from, to);
+            boxes[index].upper[axis] = std::max(from, to);
+        }
+        // The splits need finite centroids: the middle of a segment,
+        // otherwise its finite end, or the point of the line.
+        if (std::isfinite(lower) && std::isfinite(upper))
+        {
+            centroids[index] = this->lines[index].get_point(0.5 * (lower + upper));
+        }
+        else if (std::isfinite(lower) || std::isfinite(upper))
+        {
+            centroids[index] = this->lines[index].get_point(std::isfinite(lower) ? lower : upper);
+        }
+        else
+        {
+            centroids[index] = position;
+        }
+    }
+
+    this->order.resize(count);
+    for (size_t index = 0; index < count; index++)
+    {
+        this->order[index] = index;
+    }
+    this->nodes.clear();
+    if (count > 0)
+    {
+        this->nodes.reserve(2 * (count / LEAF_SIZE + 1));
+        build_node(0, count, boxes, centroids);
+    }
+    this->built = count;
+}
+
+size_t thmath::LineIndex::build_node(
+    size_t begin, size_t end, const std::vector<Node>& boxes, const std::vector<Vec3>& centroids
+)
+{
+    size_t node_index = this->nodes.size();
+    this->nodes.push_back(Node());
+    Node node;
+    double centroid_lower[3] = {INFINITE, INFINITE, INFINITE};
+    double centroid_upper[3] = {-INFINITE, -INFINITE, -INFINITE};
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        node.lower[axis] = INFINITE;
+        node.upper[axis] = -INFINITE;
+    }
+    for (size_t position = begin; position < end; position++)
+    {
+        size_t index = this->order[position];
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            node.lower[axis] = std::min(node.lower[axis], boxes[index].lower[axis]);
+            node.upper[axis] = std::max(node.upper[axis], boxes[index].upper[axis]);
+            centroid_lower[axis] = std::min(centroid_lower[axis], centroids[index][axis]);
+            centroid_upper[axis] = std::max(centroid_upper[axis], centroids[index][axis]);
+        }
+    }
+
+    size_t axis = 0;
+    for (size_t candidate = 1; candidate < 3; candidate++)
+    {
+        if (centroid_upper[candidate] - centroid_lower[candidate] > centroid_upper[axis] - centroid_lower[axis])
+        {
+            axis = candidate;
+        }
+    }
+    if (end - begin <= LEAF_SIZE || centroid_upper[axis] == centroid_lower[axis])
+    {
+        node.first = begin;
+        node.count = end - begin;
+        this->nodes[node_index] = node;
+        return node_index;
+    }
+
+    size_t middle = begin + (end - begin) / 2;
+    std::nth_element(
+        this->order.begin() + begin, this->order.begin() + middle, this->order.begin() + end,
+        [&centroids, axis](size_t a, size_t b) {
+            return centroids[a][axis] < centroids[b][axis];
+        }
+    );
+    // The left child directly follows its parent.
+    build_node(begin, middle, boxes, centroids);
+    node.first = build_node(middle, end, boxes, centroids);
+    node.count = 0;
+    this->nodes[node_index] = node;
+    return node_index;
+}
+
+void thmath::LineIndex::check_built() const
+{
+    if (this->built != this->lines.size())
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+}
+
+size_t thmath::LineIndex::get_count() const
+{
+    return this->lines.size();
+}
+
+const thmath::Line& thmath::LineIndex::get_line(const size_t index) const
+{
+    if (index >= this->lines.size())
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    return this->lines[index];
+}
+
+double thmath::LineIndex::distance(const size_t index, const Vec3& point) const
+{
+    return get_line(index).distance(point, this->lower_parameters[index], this->upper_parameters[index]);
+}
+
+thmath::LineHit thmath::LineIndex::nearest(const Vec3& point) const
+{
+    check_built();
+    LineHit best{this->lines.size(), INFINITE};
+    if (this->nodes.empty())
+    {
+        return best;
+    }
+    double best_squared = INFINITE;
+    size_t stack[MAX_DEPTH];
+    size_t depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0)
+    {
+        const Node& node = this->nodes[stack[--depth]];
+        if (box_distance_squared(node.lower, node.upper, point) > best_squared)
+        {
+            continue;
+        }
+        if (node.count > 0)
+        {
+            for (size_t position = node.first; position < node.first + node.count; position++)
+            {
+                size_t index = this->order[position];
+                double distance = this->lines[index].distance(
+                    point, this->lower_parameters[index], this->upper_parameters[index]
+                );
+                if (distance < best.distance)
+                {
+                    best = LineHit{index, distance};
+                    best_squared = distance * distance;
+                }
+            }
+            continue;
+        }
+        // Visit the closer child first: it is pushed last.
+        size_t left = &node - this->nodes.data() + 1;
+        size_t right = node.first;
+        double left_distance = box_distance_squared(this->nodes[left].lower, this->nodes[left].upper, point);
+        double right_distance = box_distance_squared(this->nodes[right].lower, this->nodes[right].upper, point);
+        if (left_distance < right_distance)
+        {
+            stack[depth++] = right;
+            stack[depth++] = left;
+        }
+        else
+        {
+            stack[depth++] = left;
+            stack[depth++] = right;
+        }
+    }
+    return best;
+}
+
+void thmath::LineIndex::within(const Vec3& point, double radius, std::vector<LineHit>& result) const
+{
+    check_built();
+    result.clear();
+    if (this->nodes.empty() || radius < 0.0)
+    {
+        return;
+    }
+    double radius_squared = radius * radius;
+    size_t stack[MAX_DEPTH];
+    size_t depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0)
+    {
+        size_t node_index = stack[--depth];
+        const Node& node = this->nodes[node_index];
+        if (box_distance_squared(node.lower, node.upper, point) > radius_squared)
+        {
+            continue;
+        }
+        if (node.count > 0)
+        {
+            for (size_t position = node.first; position < node.first + node.count; position++)
+            {
+                size_t index = this->order[position];
+                double distance = this->lines[index].distance(
+                    point, this->lower_parameters[index], this->upper_parameters[index]
+                );
+                if (distance <= radius)
+                {
+                    result.push_back(LineHit{index, distance});
+                }
+            }
+            continue;
+        }
+        stack[depth++] = node.first;
+        stack[depth++] = node_index + 1;
+    }
+    std::sort(result.begin(), result.end(), [](const LineHit& a, const LineHit& b) {
+        return a.distance < b.distance || (a.distance == b.distance && a.index < b.index);
+    });
+}
+
+void thmath::LineIndex::nearest(const VectorBatch& points, LineHit* result, execution::Policy policy) const
+{
+    check_built();
+    run_queries(points.get_count(), policy, [this, &points, result](size_t begin, size_t end) {
+        for (size_t index = begin; index < end; index++)
+        {
+            result[index] = nearest(point_of(points, index));
+        }
+    });
+}
+
+void thmath::LineIndex::within(
+    const VectorBatch& points, double radius, std::vector<std::vector<LineHit>>& result, execution::Policy policy
+) const
+{
+    check_built();
+    result.resize(points.get_count());
+    run_queries(points.get_count(), policy, [this, &points, radius, &result](size_t begin, size_t end) {
+        for (size_t index = begin; index < end; index++)
+        {
+            within(point_of(points, index), radius, result[index]);
+        }
+    });
+}
@@ -0,0 +1,209 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#ifndef __THMATH_LINE_INDEX_
+#define __THMATH_LINE_INDEX_
+
+#include "execution.h"
+#include "line.h"
+#include "vec.h"
+#include "vector_batch.h"
+#include <vector>
+
+namespace thmath
+{
+    /**
+     * The part of a line which is indexed: the segment between
+     * the two points it was built from, the ray from the first
+     * one through the second one, or the whole line.
+    */
+    enum class LineExtent
+    {
+        SEGMENT,
+        RAY,
+        LINE
+    };
+
+    struct LineHit
+    {
+        size_t index;     /**< The index of the line, in insertion order. */
+        double distance;  /**< The distance from the query point. */
+    };
+
+    /**
+     * Bounding volume hierarchy over segments, rays and lines,
+     * answering nearest-line and radius queries in logarithmic
+     * rather than linear time for spatially spread-out data. The
+     * tree is built top-down, splitting the centroids at the median
+     * of their widest axis, with up to four lines per leaf. The
+     * boxes of rays and lines are unbounded along their direction:
+     * they stay correct, but only prune well when such lines are
+     * few. Line::distance is the exact distance kernel; the tree
+     * only decides which lines it is evaluated on.
+     *
+     * Lines added after the last build are not indexed yet, and
+     * querying before rebuilding throws IllegalAccessException.
+     * Once built, the index may be queried from several threads.
+    */
+    class LineIndex
+    {
+    private:
+        struct Node
+        {
+            double lower[3];
+            double upper[3];
+            size_t first;  /**< First line (leaf) or right child (inner node). */
+            size_t count;  /**< Number of lines, 0 for an inner node. */
+        };
+
+        std::vector<Line> lines;
+        std::vector<double> lower_parameters;
+        std::vector<double> upper_parameters;
+        std::vector<size_t> order;
+        std::vector<Node> nodes;
+        size_t built;
+
+        size_t build_node(size_t begin, size_t end, const std::vector<Node>& boxes, const std::vector<Vec3>& centroids);
+        void check_built() const;
+
+    public:
+        /**
+         * Default constructor for the LineIndex class,
+         * creating an empty index.
+         *
+         * @return A new line index.
+        */
+        LineIndex();
+
+        /**
+         * Constructor for the LineIndex class, indexing
+         * the same extent of every given line.
+         *
+         * @param lines The lines which shall be indexed.
+         * @param extent The part of every line which is indexed.
+         * @return A new, built, line index.
+        */
+        explicit LineIndex(const std::vector<Line>& lines, LineExtent extent = LineExtent::SEGMENT);
+
+        /**
+         * Add a line to the index; it is only indexed by the next build.
+         *
+         * @param line The line.
+         * @param extent The part of the line which is indexed.
+         * @return The index of the line.
+        */
+        size_t add(const Line& line, LineExtent extent = LineExtent::SEGMENT);
+
+        /**
+         * Add the part of a line whose parameters (as in
+         * Line::get_point) lie in [lower, upper] to the index.
+         *
+         * @param line The line.
+         * @param lower The lowest parameter, possibly -infinity.
+         * @param upper The highest parameter, possibly infinity.
+         * @return The index of the line.
+        */
+        size_t add(const Line& line, double lower, double upper);
+
+        /**
+         * (Re)build the tree over all the lines added so far.
+        */
+        void build();
+
+        /**
+         * Return the number of lines in the index.
+         *
+         * @return The number of lines.
+        */
+        size_t get_count() const;
+
+        /**
+         * Obtain the line at the given index.
+         *
+         * @param index The index of the line.
+         * @return The line.
+        */
+        const Line& get_line(const size_t index) const;
+
+        /**
+         * Compute the distance from a point to the indexed
+         * part of the given line.
+         *
+         * @param index The index of the line.
+         * @param point The point.
+         * @return The distance.
+        */
+        double distance(const size_t index, const Vec3& point) const;
+
+        /**
+         * Find the line closest to a point.
+         *
+         * @param point The query point.
+         * @return The closest line and its distance; for an empty
+         * index, the index is get_count() and the distance infinite.
+        */
+        LineHit nearest(const Vec3& point) const;
+
+        /**
+         * Find every line within a radius of a point.
+         *
+         * @param point The query point.
+         * @param radius The radius of the query.
+         * @param result The vector receiving the lines, sorted by
+         * distance; its previous content is discarded.
+        */
+        void within(const Vec3& point, double radius, std::vector<LineHit>& result) const;
+
+        /**
+         * Find the line closest to every point of a batch. Large
+         * batches are split across the library thread pool.
+         *
+         * @param points The query points.
+         * @param result An array of at least points.get_count()
+         * hits, receiving the closest lines.
+         * @param policy The execution policy.
+        */
+        void nearest(const VectorBatch& points, LineHit* result, execution::Policy policy = execution::par) const;
+
+        /**
+         * Find every line within a radius of every point of a batch.
+         *
+         * @param points The query points.
+         * @param radius The radius of the queries.
+         * @param result The vector receiving, for every point, the
+         * lines sorted by distance; it is resized to points.get_count().
+         * @param policy The execution policy.
+        */
+        void within(
+            const VectorBatch& points,
+            double radius,
+            std::vector<std::vector<LineHit>>& result,
+            execution::Policy policy = execution::par
+        ) const;
+    };
+}
+
+#endif
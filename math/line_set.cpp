@@ -0,0 +1,294 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "line_set.h"
+#include "../exception/illegal_access_exception.h"
+#include "../exception/different_size_exception.h"
+#include "../exception/illegal_size_exception.h"
+#include "../exception/messages.h"
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace
+{
+    thmath::Vec3 unit(const thmath::Vec3& direction)
+    {
+        thmath::Vec3 result(direction);
+        if (result.norm_squared() == 0.0)
+        {
+            throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+        }
+        return result.normalized();
+    }
+}
+
+thmath::LineSet::LineSet(const size_t count) : positions(count), directions(count)
+{
+
+}
+
+thmath::LineSet::LineSet(const std::vector<Line>& lines) : LineSet(lines.size())
+{
+    for (size_t index = 0; index < lines.size(); index++)
+    {
+        set(index, lines[index]);
+    }
+}
+
+size_t thmath::LineSet::get_count() const
+{
+    return this->positions.get_count();
+}
+
+void thmath::LineSet::resize(const size_t count)
+{
+    this->positions.resize(count);
+    this->directions.resize(count);
+}
+
+const thmath::VectorBatch& thmath::LineSet::get_positions() const
+{
+    return this->positions;
+}
+
+const thmath::VectorBatch& thmath::LineSet::get_directions() const
+{
+    return this->directions;
+}
+
+thmath::Line thmath::LineSet::get(const size_t index) const
+{
+    if (index >= get_count())
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    Vec3 position(this->positions.get_x()[index], this->positions.get_y()[index], this->positions.get_z()[index]);
+    Vec3 direction(this->directions.get_x()[index], this->directions.get_y()[index], this->directions.get_z()[index]);
+    return Line(position, position + direction);
+}
+
+void thmath::LineSet::set(const size_t index, const Line& line)
+{
+    if (index >= get_count())
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    store(index, line.get_position(), unit(line.get_direction()));
+}
+
+void thmath::LineSet::store(const size_t index, const Vec3& position, const Vec3& direction)
+{
+    this->positions.get_x()[index] = position[0];
+    this->positions.get_y()[index] = position[1];
+    this->positions.get_z()[index] = position[2];
+    this->directions.get_x()[index] = direction[0];
+    this->directions.get_y()[index] = direction[1];
+    this->directions.get_z()[index] = direction[2];
+}
+
+void thmath::LineSet::push_back(const Line& line)
+{
+    // Normalize first, so that a degenerate line leaves the set unchanged.
+    Vec3 direction = unit(line.get_direction());
+    resize(get_count() + 1);
+    store(get_count() - 1, line.get_position(), direction);
+}
+
+void thmath::LineSet::distance(const Vec3& point, double* result) const
+{
+    const double* ax = this->positions.get_x();
+    const double* ay = this->positions.get_y();
+    const double* az = this->positions.get_z();
+    const double* ux = this->directions.get_x();
+    const double* uy = this->directions.get_y();
+    const double* uz = this->directions.get_z();
+    const double px = point[0], py = point[1], pz = point[2];
+    const size_t count = get_count();
+    for (size_t index = 0; index < count; index++)
+    {
+        // |(p - a) x u|, as u is a unit vector.
+        double dx = px - ax[index], dy = py - ay[index], dz = pz - az[index];
+        double cx = dy * uz[index] - dz * uy[index];
+        double cy = dz * ux[index] - dx * uz[index];
+        double cz = dx * uy[index] - dy * ux[index];
+        result[index] = std::sqrt(cx * cx + cy * cy + cz * cz);
+    }
+}
+
+void thmath::LineSet::distance(const VectorBatch& points, double* result) const
+{
+    if (points.get_count() != get_count())
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    const double* ax = this->positions.get_x();
+    const double* ay = this->positions.get_y();
+    const double* az = this->positions.get_z();
+    const double* ux = this->directions.get_x();
+    const double* uy = this->directions.get_y();
+    const double* uz = this->directions.get_z();
+    const double* px = points.get_x();
+    const double* py = points.get_y();
+    const double* pz = points.get_z();
+    const size_t count = get_count();
+    for (size_t index = 0; index < count; index++)
+    {
+        double dx = px[index] - ax[index], dy = py[index] - ay[index], dz = pz[index] - az[index];
+        double cx = dy * uz[index] - dz * uy[index];
+        double cy = dz * ux[index] - dx * uz[index];
+        double cz = dx * uy[index] - dy * ux[index];
+        result[index] = std::sqrt(cx * cx + cy * cy + cz * cz);
+    }
+}
+
+void thmath::LineSet::distance(const Line& line, const VectorBatch& points, double* result)
+{
+    const Vec3& a = line.get_position();
+    const Vec3 u = unit(line.get_direction());
+    const double* px = points.get_x();
+    const double* py = points.get_y();
+    const double* pz = points.get_z();
+    const size_t count = points.get_count();
+    for (size_t index = 0; index < count; index++)
+    {
+        double dx = px[index] - a[0], dy = py[index] - a[1], dz = pz[index] - a[2];
+        double cx = dy * u[2] - dz * u[1];
+        double cy = dz * u[0] - dx * u[2];
+        double cz = dx * u[1] - dy * u[0];
+        result[index] = std::sqrt(cx * cx + cy * cy + cz * cz);
+    }
+}
+
+void thmath::LineSet::distance(const Line& line, double* result) const
+{
+    const double* ax = this->positions.get_x();
+    const double* ay = this->positions.get_y();
+    const double* az = this->positions.get_z();
+    const double* ux = this->directions.get_x();
+    const double* uy = this->directions.get_y();
+    const double* uz = this->directions.get_z();
+    const Vec3& b = line.get_position();
+    const Vec3 v = unit(line.get_direction());
+    const size_t count = get_count();
+    for (size_t index = 0; index < count; index++)
+    {
+        double dx = ax[index] - b[0], dy = ay[index] - b[1], dz = az[index] - b[2];
+        // n = u x v; skew lines are |d . n| / |n| apart, parallel
+        // ones |d x v| (the distance from a point to the line).
+        double nx = uy[index] * v[2] - uz[index] * v[1];
+        double ny = uz[index] * v[0] - ux[index] * v[2];
+        double nz = ux[index] * v[1] - uy[index] * v[0];
+        double n2 = nx * nx + ny * ny + nz * nz;
+        if (n2 != 0.0)
+        {
+            result[index] = std::abs(dx * nx + dy * ny + dz * nz) / std::sqrt(n2);
+        }
+        else
+        {
+            double cx = dy * v[2] - dz * v[1];
+            double cy = dz * v[0] - dx * v[2];
+            double cz = dx * v[1] - dy * v[0];
+            result[index] = std::sqrt(cx * cx + cy * cy + cz * cz);
+        }
+    }
+}
+
+void thmath::LineSet::intersect(const Line& line, VectorBatch& result) const
+{
+    const size_t count = get_count();
+    result.resize(count);
+    const double* ax = this->positions.get_x();
+    const double* ay = this->positions.get_y();
+    const double* az = this->positions.get_z();
+    const double* ux = this->directions.get_x();
+    const double* uy = this->directions.get_y();
+    const double* uz = this->directions.get_z();
+    double* rx = result.get_x();
+    double* ry = result.get_y();
+    double* rz = result.get_z();
+    const Vec3& b = line.get_position();
+    const Vec3 v = unit(line.get_direction());
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (size_t index = 0; index < count; index++)
+    {
+        // a + lambda u, with lambda = ((b - a) x v) . (u x v) / |u x v|^2.
+        double dx = b[0] - ax[index], dy = b[1] - ay[index], dz = b[2] - az[index];
+        double nx = uy[index] * v[2] - uz[index] * v[1];
+        double ny = uz[index] * v[0] - ux[index] * v[2];
+        double nz = ux[index] * v[1] - uy[index] * v[0];
+        double n2 = nx * nx + ny * ny + nz * nz;
+        double cx = dy * v[2] - dz * v[1];
+        double cy = dz * v[0] - dx * v[2];
+        double cz = dx * v[1] - dy * v[0];
+        double lambda = n2 != 0.0 ? (cx * nx + cy * ny + cz * nz) / n2 : nan;
+        rx[index] = ax[index] + lambda * ux[index];
+        ry[index] = ay[index] + lambda * uy[index];
+        rz[index] = az[index] + lambda * uz[index];
+    }
+}
+
+void thmath::LineSet::classify(const Line& line, LineRelation* result, double tolerance) const
+{
+    const double* ux = this->directions.get_x();
+    const double* uy = this->directions.get_y();
+    const double* uz = this->directions.get_z();
+    const Vec3 v = unit(line.get_direction());
+    const double tolerance_squared = tolerance * tolerance;
+    const size_t count = get_count();
+    for (size_t index = 0; index < count; index++)
+    {
+        // For unit vectors, |u x v| and |u . v| are the sine and the cosine.
+        double nx = uy[index] * v[2] - uz[index] * v[1];
+        double ny = uz[index] * v[0] - ux[index] * v[2];
+        double nz = ux[index] * v[1] - uy[index] * v[0];
+        double cosine = ux[index] * v[0] + uy[index] * v[1] + uz[index] * v[2];
+        if (nx * nx + ny * ny + nz * nz <= tolerance_squared)
+        {
+            result[index] = LineRelation::PARALLEL;
+        }
+        else if (std::abs(cosine) <= tolerance)
+        {
+            result[index] = LineRelation::PERPENDICULAR;
+        }
+        else
+        {
+            result[index] = LineRelation::GENERAL;
+        }
+    }
+}
+
+std::string thmath::LineSet::to_string() const
+{
+    std::string s = "LineSet={count=" + std::to_string(get_count()) + ", lines=[";
+    for (size_t index = 0; index < get_count(); index++)
+    {
+        s += get(index).to_string();
+        if (index + 1 < get_count())
+        {
+            s += ", ";
+        }
+    }
+    return s + "]}";
+}
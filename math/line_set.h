@@ -0,0 +1,213 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#ifndef __THMATH_LINE_SET_
+#define __THMATH_LINE_SET_
+
+#include "line.h"
+#include "vec.h"
+#include "vector_batch.h"
+#include <string>
+#include <vector>
+
+namespace thmath
+{
+    enum class LineRelation
+    {
+        GENERAL,
+        PARALLEL,
+        PERPENDICULAR
+    };
+
+    /**
+     * A set of lines, stored as a structure of arrays: one
+     * batch of points and one batch of directions, which are
+     * normalized once, when the lines are stored. The batch
+     * queries then need neither a division nor a square root
+     * per line for the point distances, and write their results
+     * into caller-provided outputs, like VectorBatch does.
+    */
+    class LineSet
+    {
+    private:
+        VectorBatch positions;
+        VectorBatch directions;
+
+        /**
+         * Write a line, whose direction is already a unit
+         * vector, at an existing index.
+         *
+         * @param index The index of the line.
+         * @param position The position vector of the line.
+         * @param direction The unit direction of the line.
+        */
+        void store(const size_t index, const Vec3& position, const Vec3& direction);
+
+    public:
+        /**
+         * Default constructor for the LineSet class. The lines
+         * are all the (degenerate) line through the origin
+         * along the null vector until they are set.
+         *
+         * @param count The number of lines in the set.
+         * @return A new line set.
+        */
+        explicit LineSet(const size_t count = 0);
+
+        /**
+         * Conversion constructor from a list of lines.
+         *
+         * @param lines The lines which shall be stored.
+         * @return A new line set.
+        */
+        explicit LineSet(const std::vector<Line>& lines);
+
+        /**
+         * Return the number of lines in the set.
+         *
+         * @return The number of lines.
+        */
+        size_t get_count() const;
+
+        /**
+         * Change the number of lines in the set.
+         *
+         * @param count The new number of lines.
+        */
+        void resize(const size_t count);
+
+        /**
+         * Obtain the points of the lines.
+         *
+         * @return The batch of points.
+        */
+        const VectorBatch& get_positions() const;
+
+        /**
+         * Obtain the (unit) directions of the lines.
+         *
+         * @return The batch of directions.
+        */
+        const VectorBatch& get_directions() const;
+
+        /**
+         * Obtain the line at the given index. Its direction
+         * is the normalized direction of the line stored.
+         *
+         * @param index The index of the line.
+         * @return The line.
+        */
+        Line get(const size_t index) const;
+
+        /**
+         * Overwrite the line at the given index.
+         *
+         * @param index The index of the line.
+         * @param line The line, whose direction must not be null.
+        */
+        void set(const size_t index, const Line& line);
+
+        /**
+         * Append a line to the set.
+         *
+         * @param line The line, whose direction must not be null.
+        */
+        void push_back(const Line& line);
+
+        /**
+         * Compute the distance from a point to every line.
+         *
+         * @param point The point.
+         * @param result An array of at least get_count()
+         * doubles, receiving the distances.
+        */
+        void distance(const Vec3& point, double* result) const;
+
+        /**
+         * Compute the distance from every point to the
+         * line at the same index.
+         *
+         * @param points A batch of get_count() points.
+         * @param result An array of at least get_count()
+         * doubles, receiving the distances.
+        */
+        void distance(const VectorBatch& points, double* result) const;
+
+        /**
+         * Compute the shortest distance from every line
+         * to a given line.
+         *
+         * @param line The other line.
+         * @param result An array of at least get_count()
+         * doubles, receiving the distances.
+        */
+        void distance(const Line& line, double* result) const;
+
+        /**
+         * Compute the distance from every point to a single line.
+         *
+         * @param line The line.
+         * @param points The batch of points.
+         * @param result An array of at least points.get_count()
+         * doubles, receiving the distances.
+        */
+        static void distance(const Line& line, const VectorBatch& points, double* result);
+
+        /**
+         * Find the point where every line meets a given line
+         * (the point of the set line closest to it, if the two
+         * are skew). Lines parallel to the given one have no
+         * such point, and their result is NaN.
+         *
+         * @param line The other line.
+         * @param result The batch receiving the points; it
+         * is resized if needed.
+        */
+        void intersect(const Line& line, VectorBatch& result) const;
+
+        /**
+         * Classify every line with respect to a given line. The
+         * tolerance bounds the sine (for parallel lines) or the
+         * cosine (for perpendicular lines) of the angle between
+         * the two directions.
+         *
+         * @param line The other line.
+         * @param result An array of at least get_count()
+         * relations, receiving the classification.
+         * @param tolerance The tolerance on the sine or cosine.
+        */
+        void classify(const Line& line, LineRelation* result, double tolerance = 1e-12) const;
+
+        /**
+         * Stringify the line set, for debugging purposes.
+         *
+         * @return The stringified line set.
+        */
+        std::string to_string() const;
+    };
+}
+
+#endif
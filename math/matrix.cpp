@@ -0,0 +1,493 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "matrix.h"
+#include "simd.h"
+#include "../exception/illegal_access_exception.h"
+#include "../exception/different_size_exception.h"
+#include "../exception/illegal_size_exception.h"
+#include "../exception/messages.h"
+#include <algorithm>
+#include <string>
+
+#ifdef THMATH_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // Register tile of the micro-kernel (MR x NR), and cache blocks:
+    // a KC x NR panel of B stays in L1, an MC x KC block of A in L2
+    // and a KC x NC block of B in L3.
+    const size_t MR = 4;
+    const size_t NR = 8;
+    const size_t KC = 256;
+    const size_t MC = 96;
+    const size_t NC = 2048;
+
+    // Below this many multiply-adds, packing costs more than it saves.
+    const size_t BLOCKING_THRESHOLD = 32 * 32 * 32;
+
+    /**
+     * Pack the mc x kc block of A starting at a into panels of MR
+     * rows, each stored column by column (a_panel[k * MR + i]), with
+     * the last panel padded with zeros.
+    */
+    void pack_a(const double* a, size_t lda, size_t mc, size_t kc, double* packed)
+    {
+        for (size_t panel = 0; panel < mc; panel += MR)
+        {
+            size_t rows = std::min(MR, mc - panel);
+            for (size_t k = 0; k < kc; k++)
+            {
+                for (size_t i = 0; i < MR; i++)
+                {
+                    *packed++ = i < rows ? a[(panel + i) * lda + k] : 0.0;
+                }
+            }
+        }
+    }
+
+    /**
+     * Pack the kc x nc block of B starting at b into panels of NR
+     * columns, each stored row by row (b_panel[k * NR + j]), with
+     * the last panel padded with zeros.
+    */
+    void pack_b(const double* b, size_t ldb, size_t kc, size_t nc, double* packed)
+    {
+        for (size_t panel = 0; panel < nc; panel += NR)
+        {
+            size_t cols = std::min(NR, nc - panel);
+            for (size_t k = 0; k < kc; k++)
+            {
+                const double* row = b + k * ldb + panel;
+                for (size_t j = 0; j < NR; j++)
+                {
+                    *packed++ = j < cols ? row[j] : 0.0;
+                }
+            }
+        }
+    }
+
+    /**
+     * C[MR x NR] += A_panel * B_panel, for packed panels of depth kc.
+    */
+    void micro_kernel_scalar(size_t kc, const double* a, const double* b, double* c, size_t ldc)
+    {
+        double accumulator[MR][NR] = {};
+        for (size_t k = 0; k < kc; k++)
+        {
+            for (size_t i = 0; i < MR; i++)
+            {
+                double a_ik = a[k * MR + i];
+                for (size_t j = 0; j < NR; j++)
+                {
+                    accumulator[i][j] += a_ik * b[k * NR + j];
+                }
+            }
+        }
+        for (size_t i = 0; i < MR; i++)
+        {
+            for (size_t j = 0; j < NR; j++)
+            {
+                c[i * ldc + j] += accumulator[i][j];
+            }
+        }
+    }
+
+#ifdef THMATH_SIMD_X86
+    __attribute__((target("avx2,fma")))
+    void micro_kernel_avx2(size_t kc, const double* a, const double* b, double* c, size_t ldc)
+    {
+        __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+        __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+        __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+        __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+        for (size_t k = 0; k < kc; k++)
+        {
+            __m256d b0 = _mm256_loadu_pd(b);
+            __m256d b1 = _mm256_loadu_pd(b + 4);
+            __m256d a0 = _mm256_broadcast_sd(a);
+            __m256d a1 = _mm256_broadcast_sd(a + 1);
+            c00 = _mm256_fmadd_pd(a0, b0, c00);
+            c01 = _mm256_fmadd_pd(a0, b1, c01);
+            c10 = _mm256_fmadd_pd(a1, b0, c10);
+            c11 = _mm256_fmadd_pd(a1, b1, c11);
+            __m256d a2 = _mm256_broadcast_sd(a + 2);
+            __m256d a3 = _mm256_broadcast_sd(a + 3);
+            c20 = _mm256_fmadd_pd(a2, b0, c20);
+            c21 = _mm256_fmadd_pd(a2, b1, c21);
+            c30 = _mm256_fmadd_pd(a3, b0, c30);
+            c31 = _mm256_fmadd_pd(a3, b1, c31);
+            a += MR;
+            b += NR;
+        }
+        _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c00));
+        _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c01));
+        c += ldc;
+        _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c10));
+        _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c11));
+        c += ldc;
+        _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c20));
+        _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c21));
+        c += ldc;
+        _mm256_storeu_pd(c, _mm256_add_pd(_mm256_loadu_pd(c), c30));
+        _mm256_storeu_pd(c + 4, _mm256_add_pd(_mm256_loadu_pd(c + 4), c31));
+    }
+#endif
+
+    using MicroKernel = void (*)(size_t, const double*, const double*, double*, size_t);
+
+    MicroKernel select_micro_kernel()
+    {
+#ifdef THMATH_SIMD_X86
+        thmath::simd::InstructionSet instruction_set = thmath::simd::get_instruction_set();
+        if (instruction_set == thmath::simd::InstructionSet::AVX2 || instruction_set == thmath::simd::InstructionSet::AVX512)
+        {
+            return micro_kernel_avx2;
+        }
+#endif
+        return micro_kernel_scalar;
+    }
+
+    /**
+     * C (m x n, row-major, leading dimension ldc) += A * B, where A
+     * is m x k and B is k x n, both row-major.
+    */
+    void gemm(size_t m, size_t n, size_t k, const double* a, size_t lda, const double* b, size_t ldb, double* c, size_t ldc)
+    {
+        MicroKernel kernel = select_micro_kernel();
+        std::vector<double> packed_a(MC * KC);
+        std::vector<double> packed_b(KC * ((std::min(NC, n) + NR - 1) / NR) * NR);
+        double tile[MR * NR];
+
+        for (size_t jc = 0; jc < n; jc += NC)
+        {
+            size_t nc = std::min(NC, n - jc);
+            for (size_t pc = 0; pc < k; pc += KC)
+            {
+                size_t kc = std::min(KC, k - pc);
+                pack_b(b + pc * ldb + jc, ldb, kc, nc, packed_b.data());
+                for (size_t ic = 0; ic < m; ic += MC)
+                {
+                    size_t mc = std::min(MC, m - ic);
+                    pack_a(a + ic * lda + pc, lda, mc, kc, packed_a.data());
+                    for (size_t jr = 0; jr < nc; jr += NR)
+                    {
+                        size_t cols = std::min(NR, nc - jr);
+                        const double* b_panel = packed_b.data() + jr * kc;
+                        for (size_t ir = 0; ir < mc; ir += MR)
+                        {
+                            size_t rows = std::min(MR, mc - ir);
+                            const double* a_panel = packed_a.data() + ir * kc;
+                            double* c_block = c + (ic + ir) * ldc + jc + jr;
+                            if (rows == MR && cols == NR)
+                            {
+                                kernel(kc, a_panel, b_panel, c_block, ldc);
+                                continue;
+                            }
+                            // Edge tile: compute it in full, keep the valid part.
+                            std::fill(tile, tile + MR * NR, 0.0);
+                            kernel(kc, a_panel, b_panel, tile, NR);
+                            for (size_t i = 0; i < rows; i++)
+                            {
+                                for (size_t j = 0; j < cols; j++)
+                                {
+                                    c_block[i * ldc + j] += tile[i * NR + j];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+thmath::Matrix::Matrix(const size_t rows, const size_t cols, std::pmr::memory_resource* resource)
+    : entries(rows * cols, 0.0, resource), rows(rows), cols(cols)
+{
+    if (rows == 0 || cols == 0)
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+}
+
+thmath::Matrix::Matrix(const size_t rows, const size_t cols, const double* entries, std::pmr::memory_resource* resource)
+    : entries(entries, entries + rows * cols, resource), rows(rows), cols(cols)
+{
+    if (rows == 0 || cols == 0)
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+}
+
+thmath::Matrix::Matrix(std::initializer_list<std::initializer_list<double>> rows)
+    : entries(memory::get_default_resource()), rows(rows.size()), cols(rows.size() > 0 ? rows.begin()->size() : 0)
+{
+    if (this->rows == 0 || this->cols == 0)
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+    this->entries.reserve(this->rows * this->cols);
+    for (const std::initializer_list<double>& row : rows)
+    {
+        if (row.size() != this->cols)
+        {
+            throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+        }
+        this->entries.insert(this->entries.end(), row.begin(), row.end());
+    }
+}
+
+thmath::Matrix::Matrix(const Matrix& other)
+    : entries(other.entries, memory::get_default_resource()), rows(other.rows), cols(other.cols)
+{
+
+}
+
+thmath::Matrix::Matrix(Matrix&& other) noexcept
+    : entries(std::move(other.entries)), rows(other.rows), cols(other.cols)
+{
+    other.entries.clear();
+    other.rows = 0;
+    other.cols = 0;
+}
+
+thmath::Matrix& thmath::Matrix::operator=(Matrix&& other)
+{
+    if (this != &other)
+    {
+        this->entries = std::move(other.entries);
+        this->rows = other.rows;
+        this->cols = other.cols;
+        other.entries.clear();
+        other.rows = 0;
+        other.cols = 0;
+    }
+    return *this;
+}
+
+thmath::Matrix thmath::Matrix::identity(const size_t size)
+{
+    Matrix result(size, size);
+    for (size_t index = 0; index < size; index++)
+    {
+        result(index, index) = 1.0;
+    }
+    return result;
+}
+
+size_t thmath::Matrix::get_rows() const
+{
+    return this->rows;
+}
+
+size_t thmath::Matrix::get_cols() const
+{
+    return this->cols;
+}
+
+double thmath::Matrix::get_component(const size_t row, const size_t col) const
+{
+    if (row >= this->rows || col >= this->cols)
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    return (*this)(row, col);
+}
+
+void thmath::Matrix::set_component(const size_t row, const size_t col, double value)
+{
+    if (row >= this->rows || col >= this->cols)
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    (*this)(row, col) = value;
+}
+
+double* thmath::Matrix::get_entries()
+{
+    return this->entries.data();
+}
+
+const double* thmath::Matrix::get_entries() const
+{
+    return this->entries.data();
+}
+
+thmath::VectorView thmath::Matrix::row(const size_t row) const
+{
+    if (row >= this->rows)
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    return VectorView(this->entries.data() + row * this->cols, this->cols);
+}
+
+thmath::VectorView thmath::Matrix::column(const size_t col) const
+{
+    if (col >= this->cols)
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    return VectorView(this->entries.data() + col, this->rows, this->cols);
+}
+
+thmath::Matrix thmath::Matrix::transpose() const
+{
+    Matrix result(this->cols, this->rows);
+    for (size_t row = 0; row < this->rows; row++)
+    {
+        for (size_t col = 0; col < this->cols; col++)
+        {
+            result(col, row) = (*this)(row, col);
+        }
+    }
+    return result;
+}
+
+thmath::Vector thmath::Matrix::operator*(const Vector& vec) const
+{
+    if (vec.get_size() != this->cols)
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+    Vector result(this->rows);
+    double* entries = result.mutable_entries();
+    for (size_t row = 0; row < this->rows; row++)
+    {
+        entries[row] = simd::dot(this->entries.data() + row * this->cols, vec.get_entries(), this->cols);
+    }
+    return result;
+}
+
+thmath::Matrix thmath::Matrix::operator*(const Matrix& matrix) const
+{
+    Matrix result(this->rows, matrix.cols);
+    multiply(*this, matrix, result);
+    return result;
+}
+
+thmath::Matrix thmath::Matrix::operator*(double lambda) const
+{
+    Matrix result(*this);
+    return result *= lambda;
+}
+
+thmath::Matrix& thmath::Matrix::operator*=(double lambda)
+{
+    simd::scale(this->entries.data(), lambda, this->entries.size());
+    return *this;
+}
+
+thmath::Matrix thmath::Matrix::operator+(const Matrix& matrix) const
+{
+    Matrix result(*this);
+    return result += matrix;
+}
+
+thmath::Matrix& thmath::Matrix::operator+=(const Matrix& matrix)
+{
+    if (this->rows != matrix.rows || this->cols != matrix.cols)
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    simd::add(this->entries.data(), matrix.entries.data(), this->entries.size());
+    return *this;
+}
+
+thmath::Matrix thmath::Matrix::operator-(const Matrix& matrix) const
+{
+    Matrix result(*this);
+    return result -= matrix;
+}
+
+thmath::Matrix& thmath::Matrix::operator-=(const Matrix& matrix)
+{
+    if (this->rows != matrix.rows || this->cols != matrix.cols)
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    simd::subtract(this->entries.data(), matrix.entries.data(), this->entries.size());
+    return *this;
+}
+
+bool thmath::Matrix::operator==(const Matrix& matrix) const
+{
+    return this->rows == matrix.rows && this->cols == matrix.cols && this->entries == matrix.entries;
+}
+
+std::string thmath::Matrix::to_string() const
+{
+    std::string s = "Matrix={rows=" + std::to_string(this->rows) + ", cols=" + std::to_string(this->cols) + ", elements=[";
+    for (size_t row = 0; row < this->rows; row++)
+    {
+        s += row > 0 ? ", [" : "[";
+        for (size_t col = 0; col < this->cols; col++)
+        {
+            s += (col > 0 ? ", " : "") + std::to_string((*this)(row, col));
+        }
+        s += "]";
+    }
+    s += "]}";
+    return s;
+}
+
+void thmath::multiply(const Matrix& a, const Matrix& b, Matrix& c)
+{
+    if (a.get_cols() != b.get_rows() || c.get_rows() != a.get_rows() || c.get_cols() != b.get_cols())
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+    size_t m = a.get_rows();
+    size_t n = b.get_cols();
+    size_t k = a.get_cols();
+    if (m * n * k < BLOCKING_THRESHOLD)
+    {
+        multiply_naive(a, b, c);
+        return;
+    }
+    std::fill(c.get_entries(), c.get_entries() + m * n, 0.0);
+    gemm(m, n, k, a.get_entries(), k, b.get_entries(), n, c.get_entries(), n);
+}
+
+void thmath::multiply_naive(const Matrix& a, const Matrix& b, Matrix& c)
+{
+    if (a.get_cols() != b.get_rows() || c.get_rows() != a.get_rows() || c.get_cols() != b.get_cols())
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+    for (size_t i = 0; i < a.get_rows(); i++)
+    {
+        for (size_t j = 0; j < b.get_cols(); j++)
+        {
+            double sum = 0.0;
+            for (size_t p = 0; p < a.get_cols(); p++)
+            {
+                sum += a(i, p) * b(p, j);
+            }
+            c(i, j) = sum;
+        }
+    }
+}
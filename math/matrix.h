@@ -0,0 +1,270 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __THMATH_MATRIX_
+#define __THMATH_MATRIX_
+
+#include "vector.h"
+#include "vector_view.h"
+#include "memory.h"
+#include <initializer_list>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace thmath
+{
+    /**
+     * Dense matrix of doubles, stored in row-major order:
+     * the component (i, j) is found at entries[i * cols + j].
+     * Like Vector, the storage comes from a memory resource.
+    */
+    class Matrix
+    {
+    private:
+        std::pmr::vector<double> entries;
+        size_t rows;
+        size_t cols;
+
+    public:
+        /**
+         * Default constructor for the Matrix class, creating
+         * the null matrix of the given dimensions.
+         *
+         * @param rows The number of rows.
+         * @param cols The number of columns.
+         * @param resource The memory resource providing the storage.
+         * @return A new matrix object.
+        */
+        Matrix(
+            const size_t rows,
+            const size_t cols,
+            std::pmr::memory_resource* resource = memory::get_default_resource()
+        );
+
+        /**
+         * Constructor for the Matrix class, copying the
+         * components from a row-major array.
+         *
+         * @param rows The number of rows.
+         * @param cols The number of columns.
+         * @param entries The rows * cols components, row by row.
+         * @param resource The memory resource providing the storage.
+         * @return A new matrix object.
+        */
+        Matrix(
+            const size_t rows,
+            const size_t cols,
+            const double* entries,
+            std::pmr::memory_resource* resource = memory::get_default_resource()
+        );
+
+        /**
+         * Initializer list constructor for the Matrix class,
+         * taking the rows of the matrix, which must all have
+         * the same size.
+         *
+         * @param rows The rows of the matrix.
+         * @return A new matrix object.
+        */
+        Matrix(std::initializer_list<std::initializer_list<double>> rows);
+
+        /**
+         * Copy constructor for the matrix class. As for Vector,
+         * the copy uses the default memory resource.
+         *
+         * @param other The matrix which shall be copied.
+         * @return A new matrix object.
+        */
+        Matrix(const Matrix& other);
+
+        /**
+         * Move constructor for the Matrix class. The other
+         * matrix is left empty, with 0 rows and 0 columns.
+         *
+         * @param other The matrix which shall be moved.
+         * @return A new matrix object.
+        */
+        Matrix(Matrix&& other) noexcept;
+
+        Matrix& operator=(const Matrix& other) = default;
+
+        /**
+         * Move assignment operator overloading. As for the move
+         * constructor, the other matrix is left with 0 rows and
+         * 0 columns (if the memory resources differ, the entries
+         * are copied rather than taken over).
+         *
+         * @param other The matrix which shall be moved.
+         * @return The modified matrix.
+        */
+        Matrix& operator=(Matrix&& other);
+
+        /**
+         * Create the identity matrix of the given size.
+         *
+         * @param size The number of rows (and columns).
+         * @return The identity matrix.
+        */
+        static Matrix identity(const size_t size);
+
+        /**
+         * Return the number of rows of the matrix.
+         *
+         * @return The number of rows.
+        */
+        size_t get_rows() const;
+
+        /**
+         * Return the number of columns of the matrix.
+         *
+         * @return The number of columns.
+        */
+        size_t get_cols() const;
+
+        /**
+         * Obtain the component at the given row and column.
+         *
+         * @param row The row of the component.
+         * @param col The column of the component.
+         * @return The component.
+        */
+        double get_component(const size_t row, const size_t col) const;
+
+        /**
+         * Overwrite the component at the given row and column.
+         *
+         * @param row The row of the component.
+         * @param col The column of the component.
+         * @param value The new value of the component.
+        */
+        void set_component(const size_t row, const size_t col, double value);
+
+        /**
+         * Unchecked access to the component (row, col).
+         *
+         * @param row The row of the component.
+         * @param col The column of the component.
+         * @return A reference to the component.
+        */
+        double& operator()(const size_t row, const size_t col)
+        {
+            return this->entries[row * this->cols + col];
+        }
+
+        double operator()(const size_t row, const size_t col) const
+        {
+            return this->entries[row * this->cols + col];
+        }
+
+        /**
+         * Obtain the row-major array of components.
+         *
+         * @return The components of the matrix.
+        */
+        double* get_entries();
+        const double* get_entries() const;
+
+        /**
+         * Obtain a (contiguous) view of the given row.
+         *
+         * @param row The index of the row.
+         * @return A view of the row.
+        */
+        VectorView row(const size_t row) const;
+
+        /**
+         * Obtain a (strided) view of the given column.
+         *
+         * @param col The index of the column.
+         * @return A view of the column.
+        */
+        VectorView column(const size_t col) const;
+
+        /**
+         * Return the transpose of this matrix.
+         *
+         * @return A new, transposed, matrix.
+        */
+        Matrix transpose() const;
+
+        /**
+         * Matrix-vector product.
+         *
+         * @param vec A vector with get_cols() components.
+         * @return A new vector with get_rows() components.
+        */
+        Vector operator*(const Vector& vec) const;
+
+        /**
+         * Matrix-matrix product. Large products run a cache
+         * blocked GEMM: the operands are packed into panels
+         * sized for the L2 (A) and L1 (B) caches, and a register
+         * tiled micro-kernel (AVX2/FMA when available) computes
+         * 4x8 blocks of the result.
+         *
+         * @param matrix A matrix with get_cols() rows.
+         * @return The product of the two matrices.
+        */
+        Matrix operator*(const Matrix& matrix) const;
+
+        Matrix operator*(double lambda) const;
+        Matrix& operator*=(double lambda);
+        Matrix operator+(const Matrix& matrix) const;
+        Matrix& operator+=(const Matrix& matrix);
+        Matrix operator-(const Matrix& matrix) const;
+        Matrix& operator-=(const Matrix& matrix);
+        bool operator==(const Matrix& matrix) const;
+
+        /**
+         * Stringify the matrix object, for debugging purposes.
+         *
+         * @return The stringified version of the matrix.
+        */
+        std::string to_string() const;
+    };
+
+    /**
+     * Compute c = a * b with the cache blocked GEMM, writing
+     * into an existing matrix of the right dimensions.
+     *
+     * @param a The left operand (m x k).
+     * @param b The right operand (k x n).
+     * @param c The result (m x n), which must not alias a or b.
+    */
+    void multiply(const Matrix& a, const Matrix& b, Matrix& c);
+
+    /**
+     * Compute c = a * b with the plain triple loop (kept as
+     * a reference for the blocked implementation).
+     *
+     * @param a The left operand (m x k).
+     * @param b The right operand (k x n).
+     * @param c The result (m x n), which must not alias a or b.
+    */
+    void multiply_naive(const Matrix& a, const Matrix& b, Matrix& c);
+}
+
+#endif
@@ -0,0 +1,235 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "memory.h"
+#include <cstdint>
+#include <new>
+
+namespace
+{
+    thread_local std::pmr::memory_resource* thread_default_resource = nullptr;
+
+    const size_t MINIMUM_CLASS_SIZE = 16;
+    const size_t CLASS_COUNT = 13;
+    const size_t MAXIMUM_CLASS_SIZE = MINIMUM_CLASS_SIZE << (CLASS_COUNT - 1);
+    const size_t CACHED_BLOCKS_PER_CLASS = 64;
+    const size_t POOL_ALIGNMENT = alignof(std::max_align_t);
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    // Set once the cache of this thread has been destroyed, so that
+    // late deallocations (e.g. from static objects) bypass it.
+    thread_local bool pool_cache_destroyed = false;
+
+    /**
+     * Per-thread free lists of the size-class pool. The cached
+     * blocks are returned to operator new when the thread exits.
+    */
+    struct PoolCache
+    {
+        FreeBlock* heads[CLASS_COUNT] = {};
+        size_t counts[CLASS_COUNT] = {};
+
+        ~PoolCache()
+        {
+            pool_cache_destroyed = true;
+            for (size_t size_class = 0; size_class < CLASS_COUNT; size_class++)
+            {
+                while (heads[size_class] != nullptr)
+                {
+                    FreeBlock* block = heads[size_class];
+                    heads[size_class] = block->next;
+                    ::operator delete(block);
+                }
+            }
+        }
+    };
+
+    thread_local PoolCache pool_cache;
+
+    size_t size_class_of(size_t bytes)
+    {
+        size_t size_class = 0;
+        size_t class_size = MINIMUM_CLASS_SIZE;
+        while (class_size < bytes)
+        {
+            class_size <<= 1;
+            size_class++;
+        }
+        return size_class;
+    }
+
+    size_t align_up(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+std::pmr::memory_resource* thmath::memory::get_default_resource()
+{
+    return thread_default_resource != nullptr ? thread_default_resource : std::pmr::get_default_resource();
+}
+
+std::pmr::memory_resource* thmath::memory::set_default_resource(std::pmr::memory_resource* resource)
+{
+    std::pmr::memory_resource* previous = get_default_resource();
+    thread_default_resource = resource;
+    return previous;
+}
+
+std::pmr::memory_resource* thmath::memory::pool_resource()
+{
+    static PoolResource pool;
+    return &pool;
+}
+
+thmath::memory::ScopedResource::ScopedResource(std::pmr::memory_resource* resource)
+    : previous(thread_default_resource)
+{
+    thread_default_resource = resource;
+}
+
+thmath::memory::ScopedResource::~ScopedResource()
+{
+    thread_default_resource = this->previous;
+}
+
+void* thmath::memory::PoolResource::do_allocate(size_t bytes, size_t alignment)
+{
+    if (bytes > MAXIMUM_CLASS_SIZE || alignment > POOL_ALIGNMENT)
+    {
+        return ::operator new(bytes, std::align_val_t(alignment));
+    }
+    size_t size_class = size_class_of(bytes);
+    if (pool_cache_destroyed)
+    {
+        return ::operator new(MINIMUM_CLASS_SIZE << size_class);
+    }
+    FreeBlock* block = pool_cache.heads[size_class];
+    if (block != nullptr)
+    {
+        pool_cache.heads[size_class] = block->next;
+        pool_cache.counts[size_class]--;
+        return block;
+    }
+    return ::operator new(MINIMUM_CLASS_SIZE << size_class);
+}
+
+void thmath::memory::PoolResource::do_deallocate(void* pointer, size_t bytes, size_t alignment)
+{
+    if (bytes > MAXIMUM_CLASS_SIZE || alignment > POOL_ALIGNMENT)
+    {
+        ::operator delete(pointer, std::align_val_t(alignment));
+        return;
+    }
+    size_t size_class = size_class_of(bytes);
+    if (pool_cache_destroyed || pool_cache.counts[size_class] >= CACHED_BLOCKS_PER_CLASS)
+    {
+        ::operator delete(pointer);
+        return;
+    }
+    FreeBlock* block = static_cast<FreeBlock*>(pointer);
+    block->next = pool_cache.heads[size_class];
+    pool_cache.heads[size_class] = block;
+    pool_cache.counts[size_class]++;
+}
+
+bool thmath::memory::PoolResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return dynamic_cast<const PoolResource*>(&other) != nullptr;
+}
+
+thmath::memory::ArenaResource::ArenaResource(size_t chunk_size, std::pmr::memory_resource* upstream)
+    : upstream(upstream), chunk_size(chunk_size), chunks(nullptr), cursor(nullptr), end(nullptr)
+{
+
+}
+
+thmath::memory::ArenaResource::~ArenaResource()
+{
+    while (this->chunks != nullptr)
+    {
+        Chunk* chunk = this->chunks;
+        this->chunks = chunk->next;
+        this->upstream->deallocate(chunk, chunk->size, alignof(std::max_align_t));
+    }
+}
+
+void thmath::memory::ArenaResource::add_chunk(size_t minimum_bytes)
+{
+    size_t header = align_up(sizeof(Chunk), alignof(std::max_align_t));
+    size_t size = header + minimum_bytes;
+    if (size < this->chunk_size)
+    {
+        size = this->chunk_size;
+    }
+    Chunk* chunk = static_cast<Chunk*>(this->upstream->allocate(size, alignof(std::max_align_t)));
+    chunk->next = this->chunks;
+    chunk->size = size;
+    this->chunks = chunk;
+    this->cursor = reinterpret_cast<char*>(chunk) + header;
+    this->end = reinterpret_cast<char*>(chunk) + size;
+}
+
+void* thmath::memory::ArenaResource::do_allocate(size_t bytes, size_t alignment)
+{
+    uintptr_t aligned = align_up(reinterpret_cast<uintptr_t>(this->cursor), alignment);
+    if (this->cursor == nullptr || aligned + bytes > reinterpret_cast<uintptr_t>(this->end))
+    {
+        add_chunk(bytes + alignment);
+        aligned = align_up(reinterpret_cast<uintptr_t>(this->cursor), alignment);
+    }
+    this->cursor = reinterpret_cast<char*>(aligned + bytes);
+    return reinterpret_cast<void*>(aligned);
+}
+
+void thmath::memory::ArenaResource::do_deallocate(void* /* pointer */, size_t /* bytes */, size_t /* alignment */)
+{
+    // Arena blocks are only released all at once, by release().
+}
+
+bool thmath::memory::ArenaResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+void thmath::memory::ArenaResource::release()
+{
+    if (this->chunks == nullptr)
+    {
+        return;
+    }
+    // Keep the most recent chunk, so that the next request does
+    // not have to go upstream again.
+    Chunk* kept = this->chunks;
+    while (kept->next != nullptr)
+    {
+        Chunk* chunk = kept->next;
+        kept->next = chunk->next;
+        this->upstream->deallocate(chunk, chunk->size, alignof(std::max_align_t));
+    }
+    this->cursor = reinterpret_cast<char*>(kept) + align_up(sizeof(Chunk), alignof(std::max_align_t));
+}
@@ -0,0 +1,158 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __THMATH_MEMORY_
+#define __THMATH_MEMORY_
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace thmath
+{
+    namespace memory
+    {
+        /**
+         * Return the memory resource used by the current thread
+         * for the storage of new containers (e.g. the result of
+         * a + b). Unless changed with set_default_resource, this
+         * is std::pmr::get_default_resource().
+         *
+         * @return The default memory resource of this thread.
+        */
+        std::pmr::memory_resource* get_default_resource();
+
+        /**
+         * Change the memory resource used by the current thread
+         * for the storage of new containers.
+         *
+         * @param resource The new default resource, or nullptr
+         * to fall back to std::pmr::get_default_resource().
+         * @return The previous default resource of this thread.
+        */
+        std::pmr::memory_resource* set_default_resource(std::pmr::memory_resource* resource);
+
+        /**
+         * Return the process-wide size-class pool.
+         *
+         * @return The pool resource.
+        */
+        std::pmr::memory_resource* pool_resource();
+
+        /**
+         * Scope guard installing a default memory resource for
+         * the current thread, and restoring the previous one
+         * once it goes out of scope.
+        */
+        class ScopedResource
+        {
+        private:
+            std::pmr::memory_resource* previous;
+
+        public:
+            explicit ScopedResource(std::pmr::memory_resource* resource);
+            ~ScopedResource();
+
+            ScopedResource(const ScopedResource&) = delete;
+            ScopedResource& operator=(const ScopedResource&) = delete;
+        };
+
+        /**
+         * Size-class pool with thread-local free lists. Requests
+         * are rounded up to a power of two (16 bytes to 64 KiB),
+         * and freed blocks are kept in a small per-thread cache
+         * for the next request of the same class, so the steady
+         * state of allocating and freeing temporaries never takes
+         * a lock. Larger requests go straight to operator new.
+         *
+         * All instances share the same thread-local caches, hence
+         * compare equal; memory may be freed on any thread.
+        */
+        class PoolResource : public std::pmr::memory_resource
+        {
+        protected:
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+        };
+
+        /**
+         * Bump (monotonic) arena. Allocation only moves a pointer
+         * forward within the current chunk, and deallocation is a
+         * no-op; everything allocated is released at once by
+         * release(), which keeps the current chunk for reuse.
+         * Meant for the temporaries of a single request, on a
+         * single thread (it is not thread-safe).
+        */
+        class ArenaResource : public std::pmr::memory_resource
+        {
+        private:
+            struct Chunk
+            {
+                Chunk* next;
+                size_t size;
+            };
+
+            std::pmr::memory_resource* upstream;
+            size_t chunk_size;
+            Chunk* chunks;
+            char* cursor;
+            char* end;
+
+            void add_chunk(size_t minimum_bytes);
+
+        protected:
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+        public:
+            /**
+             * Constructor for the ArenaResource class.
+             *
+             * @param chunk_size The size of the chunks which are
+             * requested from the upstream resource.
+             * @param upstream The resource providing the chunks.
+             * @return A new, empty arena.
+            */
+            explicit ArenaResource(
+                size_t chunk_size = 64 * 1024,
+                std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()
+            );
+
+            ~ArenaResource();
+
+            ArenaResource(const ArenaResource&) = delete;
+            ArenaResource& operator=(const ArenaResource&) = delete;
+
+            /**
+             * Release everything allocated from the arena. The
+             * containers using it must not be touched afterwards.
+            */
+            void release();
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,229 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "norm.h"
+#include "simd.h"
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    // Blue's constants for IEEE double precision (see LAPACK's dnrm2):
+    // squares of values in [T_SMALL, T_BIG] neither overflow nor lose
+    // precision to underflow, values outside are scaled by S_SMALL/S_BIG.
+    const double T_SMALL = 0x1p-511;
+    const double T_BIG = 0x1p486;
+    const double S_SMALL = 0x1p537;
+    const double S_BIG = 0x1p-538;
+
+    // Smallest sum of squares for which the unscaled fast path is
+    // accurate, per element: below it, squares of tiny components
+    // might have been flushed to (or rounded within) the subnormals.
+    const double SAFE_SUM_PER_ELEMENT = std::numeric_limits<double>::min() / std::numeric_limits<double>::epsilon();
+
+    double blue_l2(const double* entries, size_t size, size_t stride)
+    {
+        bool not_big = true;
+        double a_small = 0.0;
+        double a_medium = 0.0;
+        double a_big = 0.0;
+        for (size_t index = 0; index < size; index++)
+        {
+            double ax = std::abs(entries[index * stride]);
+            if (ax > T_BIG)
+            {
+                ax *= S_BIG;
+                a_big += ax * ax;
+                not_big = false;
+            }
+            else if (ax < T_SMALL)
+            {
+                if (not_big)
+                {
+                    ax *= S_SMALL;
+                    a_small += ax * ax;
+                }
+            }
+            else
+            {
+                a_medium += ax * ax;
+            }
+        }
+
+        double scale = 1.0;
+        double sum = a_medium;
+        if (a_big > 0.0)
+        {
+            if (a_medium > 0.0 || std::isnan(a_medium))
+            {
+                a_big += (a_medium * S_BIG) * S_BIG;
+            }
+            scale = 1.0 / S_BIG;
+            sum = a_big;
+        }
+        else if (a_small > 0.0)
+        {
+            if (a_medium > 0.0 || std::isnan(a_medium))
+            {
+                double y_medium = std::sqrt(a_medium);
+                double y_small = std::sqrt(a_small) / S_SMALL;
+                double y_min = std::min(y_medium, y_small);
+                double y_max = std::max(y_medium, y_small);
+                sum = y_max * y_max * (1.0 + (y_min / y_max) * (y_min / y_max));
+            }
+            else
+            {
+                scale = 1.0 / S_SMALL;
+                sum = a_small;
+            }
+        }
+        return scale * std::sqrt(sum);
+    }
+
+    double integer_power(double x, unsigned int p)
+    {
+        double result = 1.0;
+        while (p > 0)
+        {
+            if (p & 1u)
+            {
+                result *= x;
+            }
+            x *= x;
+            p >>= 1;
+        }
+        return result;
+    }
+
+    /**
+     * Single pass accumulation of sum((|x_i| / scale)^p), where scale
+     * is the largest |x_i| seen so far; every time a larger component
+     * is met, the running sum is rescaled. This never overflows, and
+     * needs no preliminary pass to find the maximum.
+    */
+    template <typename Power>
+    double scaled_lp(const double* entries, size_t size, double p, size_t stride, Power power)
+    {
+        double scale = 0.0;
+        double sum = 1.0;
+        for (size_t index = 0; index < size; index++)
+        {
+            double ax = std::abs(entries[index * stride]);
+            if (std::isnan(ax))
+            {
+                return ax;
+            }
+            if (ax == 0.0)
+            {
+                continue;
+            }
+            if (scale < ax)
+            {
+                sum = 1.0 + sum * power(scale / ax);
+                scale = ax;
+            }
+            else
+            {
+                sum += power(ax / scale);
+            }
+        }
+        if (scale == 0.0 || std::isinf(scale))
+        {
+            return scale;
+        }
+        return scale * std::pow(sum, 1.0 / p);
+    }
+}
+
+double thmath::norms::l1(const double* entries, size_t size, size_t stride)
+{
+    double result = 0.0;
+    for (size_t index = 0; index < size; index++)
+    {
+        result += std::abs(entries[index * stride]);
+    }
+    return result;
+}
+
+double thmath::norms::l2(const double* entries, size_t size, size_t stride)
+{
+    if (stride == 1)
+    {
+        return l2_from_squares(entries, size, simd::dot(entries, entries, size));
+    }
+    return blue_l2(entries, size, stride);
+}
+
+double thmath::norms::l2_from_squares(const double* entries, size_t size, double sum_of_squares)
+{
+    if (sum_of_squares <= std::numeric_limits<double>::max() && sum_of_squares >= SAFE_SUM_PER_ELEMENT * size)
+    {
+        return std::sqrt(sum_of_squares);
+    }
+    return blue_l2(entries, size, 1);
+}
+
+double thmath::norms::infinity(const double* entries, size_t size, size_t stride)
+{
+    double result = 0.0;
+    for (size_t index = 0; index < size; index++)
+    {
+        double ax = std::abs(entries[index * stride]);
+        if (std::isnan(ax))
+        {
+            return ax;
+        }
+        result = ax > result ? ax : result;
+    }
+    return result;
+}
+
+double thmath::norms::integer(const double* entries, size_t size, unsigned int p, size_t stride)
+{
+    switch (p)
+    {
+        case 1:
+            return l1(entries, size, stride);
+        case 2:
+            return l2(entries, size, stride);
+        default:
+            return scaled_lp(entries, size, p, stride, [p](double x) {
+                return integer_power(x, p);
+            });
+    }
+}
+
+double thmath::norms::lp(const double* entries, size_t size, double p, size_t stride)
+{
+    if (std::isinf(p) && p > 0)
+    {
+        return infinity(entries, size, stride);
+    }
+    if (p >= 1 && p <= std::numeric_limits<unsigned int>::max() && p == std::floor(p))
+    {
+        return integer(entries, size, static_cast<unsigned int>(p), stride);
+    }
+    return scaled_lp(entries, size, p, stride, [p](double x) {
+        return std::pow(x, p);
+    });
+}
@@ -0,0 +1,118 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __THMATH_NORM_
+#define __THMATH_NORM_
+
+#include <cstddef>
+
+namespace thmath
+{
+    /**
+     * Norm kernels over arrays of doubles (with an optional
+     * stride, in the style of BLAS). None of them allocates,
+     * and all of them are safe against intermediate overflow
+     * and underflow: the result only overflows if the norm
+     * itself is not representable.
+    */
+    namespace norms
+    {
+        /**
+         * Compute the L1 norm, i.e. sum(|x_i|).
+         *
+         * @param entries The array.
+         * @param size The number of elements.
+         * @param stride The distance between two consecutive elements.
+         * @return The L1 norm.
+        */
+        double l1(const double* entries, size_t size, size_t stride = 1);
+
+        /**
+         * Compute the Euclidian (L2) norm. The sum of squares is
+         * first accumulated with the SIMD dot kernel; only when it
+         * overflows or underflows is the norm recomputed with Blue's
+         * scaled single-pass algorithm (as in LAPACK's dnrm2), which
+         * keeps three accumulators for small, medium and big values.
+         *
+         * @param entries The array.
+         * @param size The number of elements.
+         * @param stride The distance between two consecutive elements.
+         * @return The L2 norm.
+        */
+        double l2(const double* entries, size_t size, size_t stride = 1);
+
+        /**
+         * Finish the L2 norm of a contiguous array from its sum of
+         * squares, as accumulated by simd::dot (or simd::dot_norms),
+         * so that fused kernels return exactly what l2 would. If the
+         * sum overflowed or underflowed, the norm is recomputed.
+         *
+         * @param entries The array.
+         * @param size The number of elements.
+         * @param sum_of_squares The sum of squares of the elements.
+         * @return The L2 norm.
+        */
+        double l2_from_squares(const double* entries, size_t size, double sum_of_squares);
+
+        /**
+         * Compute the infinity norm, i.e. max(|x_i|).
+         *
+         * @param entries The array.
+         * @param size The number of elements.
+         * @param stride The distance between two consecutive elements.
+         * @return The infinity norm.
+        */
+        double infinity(const double* entries, size_t size, size_t stride = 1);
+
+        /**
+         * Compute the Lp norm for a positive integer p, raising
+         * the (scaled) components to the p-th power by repeated
+         * multiplication rather than through std::pow.
+         *
+         * @param entries The array.
+         * @param size The number of elements.
+         * @param p The (integer) order of the norm.
+         * @param stride The distance between two consecutive elements.
+         * @return The Lp norm.
+        */
+        double integer(const double* entries, size_t size, unsigned int p, size_t stride = 1);
+
+        /**
+         * Compute the Lp norm for a real p, picking the dedicated
+         * kernel when p is 1, 2, infinity or an integer. The general
+         * case runs a single pass which rescales the running sum
+         * whenever a larger component is met.
+         *
+         * @param entries The array.
+         * @param size The number of elements.
+         * @param p The order of the norm.
+         * @param stride The distance between two consecutive elements.
+         * @return The Lp norm.
+        */
+        double lp(const double* entries, size_t size, double p, size_t stride = 1);
+    }
+}
+
+#endif
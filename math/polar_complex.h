@@ -0,0 +1,178 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#ifndef __THMATH_POLAR_COMPLEX_
+#define __THMATH_POLAR_COMPLEX_
+
+#include "complex.h"
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace thmath
+{
+    /**
+     * Complex number in polar form, r * e^(i theta). The modulus
+     * and argument are computed once (one hypot and one atan2) when
+     * converting from a Complex, after which products, quotients,
+     * powers and roots are plain real arithmetic; only to_complex()
+     * needs a sincos. Meant for a base raised to many exponents,
+     * or for computing roots.
+    */
+    class PolarComplex
+    {
+    private:
+        double modulus;
+        double argument;
+
+    public:
+        /**
+         * Default constructor for the PolarComplex class.
+         * 
+         * @param modulus The modulus r, non-negative.
+         * @param argument The argument theta, in radians. It is
+         * kept as given, i.e. not reduced to (-pi, pi].
+         * @return A new complex number in polar form.
+        */
+        constexpr PolarComplex(double modulus, double argument) : modulus(modulus), argument(argument)
+        {
+
+        }
+
+        /**
+         * Conversion constructor from a complex number, with
+         * the argument in (-pi, pi].
+         * 
+         * @param complex The complex number.
+         * @return A new complex number in polar form.
+        */
+        explicit PolarComplex(const Complex& complex)
+            : modulus(std::hypot(complex.get_real(), complex.get_imaginary())), argument(complex.argument())
+        {
+
+        }
+
+        constexpr double get_modulus() const
+        {
+            return this->modulus;
+        }
+
+        constexpr double get_argument() const
+        {
+            return this->argument;
+        }
+
+        /**
+         * Convert back to the cartesian form.
+         * 
+         * @return The complex number.
+        */
+        Complex to_complex() const
+        {
+            return Complex(this->modulus * std::cos(this->argument), this->modulus * std::sin(this->argument));
+        }
+
+        constexpr PolarComplex operator*(const PolarComplex& other) const
+        {
+            return PolarComplex(this->modulus * other.modulus, this->argument + other.argument);
+        }
+
+        constexpr PolarComplex operator/(const PolarComplex& other) const
+        {
+            return PolarComplex(this->modulus / other.modulus, this->argument - other.argument);
+        }
+
+        constexpr PolarComplex conjugate() const
+        {
+            return PolarComplex(this->modulus, -this->argument);
+        }
+
+        /**
+         * Raise the number to a real power: r^p e^(i p theta).
+         * 
+         * @param exponent The real exponent.
+         * @return The power, in polar form.
+        */
+        PolarComplex pow(double exponent) const
+        {
+            return PolarComplex(std::pow(this->modulus, exponent), this->argument * exponent);
+        }
+
+        /**
+         * Compute the k-th of the n-th roots of the number,
+         * r^(1/n) e^(i (theta + 2 pi k) / n); k = 0 gives the
+         * principal root when the argument is in (-pi, pi].
+         * 
+         * @param n The degree of the root, at least 1.
+         * @param k The index of the root, in [0, n).
+         * @return The root, in polar form.
+        */
+        PolarComplex root(unsigned int n, unsigned int k = 0) const
+        {
+            if (n == 0)
+            {
+                throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+            }
+            const double two_pi = 6.283185307179586477;
+            return PolarComplex(
+                std::pow(this->modulus, 1.0 / n),
+                (this->argument + two_pi * (k % n)) / n
+            );
+        }
+
+        /**
+         * Compute all the n-th roots of the number.
+         * 
+         * @param n The degree of the roots, at least 1.
+         * @return The n roots, in cartesian form.
+        */
+        std::vector<Complex> roots(unsigned int n) const
+        {
+            std::vector<Complex> result;
+            result.reserve(n);
+            for (unsigned int k = 0; k < n; k++)
+            {
+                result.push_back(root(n, k).to_complex());
+            }
+            return result;
+        }
+
+        /**
+         * Stringify the complex number, for debugging purposes.
+         * 
+         * @return The stringified version of the complex number.
+        */
+        std::string to_string() const
+        {
+            std::ostringstream stream;
+            stream << "PolarComplex={modulus=" << this->modulus << ", argument=" << this->argument << "}";
+            return stream.str();
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,426 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "predicates.h"
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    // Half the distance between 1 and the next double.
+    const double EPSILON = 0x1p-53;
+    // Error bounds of the floating point filters (Shewchuk).
+    const double ORIENT2D_BOUND = (3.0 + 16.0 * EPSILON) * EPSILON;
+    const double ORIENT3D_BOUND = (7.0 + 56.0 * EPSILON) * EPSILON;
+
+    // a + b = x + y exactly, with x = fl(a + b).
+    inline void two_sum(double a, double b, double& x, double& y)
+    {
+        x = a + b;
+        double virtual_b = x - a;
+        double virtual_a = x - virtual_b;
+        y = (a - virtual_a) + (b - virtual_b);
+    }
+
+    // a - b = x + y exactly, with x = fl(a - b).
+    inline void two_diff(double a, double b, double& x, double& y)
+    {
+        x = a - b;
+        double virtual_b = a - x;
+        double virtual_a = x + virtual_b;
+        y = (a - virtual_a) + (virtual_b - b);
+    }
+
+    // a * b = x + y exactly, with x = fl(a * b).
+    inline void two_product(double a, double b, double& x, double& y)
+    {
+        x = a * b;
+        y = std::fma(a, b, -x);
+    }
+
+    // Expansions are stored from the smallest component to the
+    // largest, without zeros; the sign of an expansion is the sign
+    // of its largest component.
+
+    // h = e + b; h may be e.
+    size_t grow_expansion(const double* e, size_t e_size, double b, double* h)
+    {
+        double q = b;
+        size_t size = 0;
+        for (size_t index = 0; index < e_size; index++)
+        {
+            double sum, error;
+            two_sum(q, e[index], sum, error);
+            q = sum;
+            if (error != 0.0)
+            {
+                h[size++] = error;
+            }
+        }
+        if (q != 0.0 || size == 0)
+        {
+            h[size++] = q;
+        }
+        return size;
+    }
+
+    // h = e + f; h must not be f, but may be e.
+    size_t expansion_sum(const double* e, size_t e_size, const double* f, size_t f_size, double* h)
+    {
+        size_t size = e_size;
+        for (size_t index = 0; index < e_size; index++)
+        {
+            h[index] = e[index];
+        }
+        for (size_t index = 0; index < f_size; index++)
+        {
+            size = grow_expansion(h, size, f[index], h);
+        }
+        return size;
+    }
+
+    // h = b * e; h must not be e.
+    size_t scale_expansion(const double* e, size_t e_size, double b, double* h)
+    {
+        size_t size = 0;
+        double q, error;
+        two_product(e[0], b, q, error);
+        if (error != 0.0)
+        {
+            h[size++] = error;
+        }
+        for (size_t index = 1; index < e_size; index++)
+        {
+            double product, product_error, sum;
+            two_product(e[index], b, product, product_error);
+            two_sum(q, product_error, sum, error);
+            if (error != 0.0)
+            {
+                h[size++] = error;
+            }
+            two_sum(product, sum, q, error);
+            if (error != 0.0)
+            {
+                h[size++] = error;
+            }
+        }
+        if (q != 0.0 || size == 0)
+        {
+            h[size++] = q;
+        }
+        return size;
+    }
+
+    // h = e * f, with scratch room for e_size * f_size * 2 terms.
+    size_t expansion_product(const double* e, size_t e_size, const double* f, size_t f_size, double* h, double* scratch)
+    {
+        size_t size = 0;
+        for (size_t index = 0; index < f_size; index++)
+        {
+            size_t scaled = scale_expansion(e, e_size, f[index], scratch);
+            size = index == 0 ? expansion_sum(scratch, scaled, nullptr, 0, h) : expansion_sum(h, size, scratch, scaled, h);
+        }
+        return size;
+    }
+
+    double estimate(const double* e, size_t size)
+    {
+        double result = 0.0;
+        for (size_t index = 0; index < size; index++)
+        {
+            result += e[index];
+        }
+        return result;
+    }
+
+    // The exact difference a - b, as an expansion of (at most) two terms.
+    size_t difference(double a, double b, double* h)
+    {
+        double x, y;
+        two_diff(a, b, x, y);
+        h[0] = y;
+        h[1] = x;
+        return y != 0.0 ? 2 : (h[0] = x, 1);
+    }
+
+    // (bx - ax) (dy - cy) - (by - ay) (dx - cx), exactly: the cross
+    // product of the differences b - a and d - c, in the plane.
+    double cross_exact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy)
+    {
+        double bax[2], bay[2], dcx[2], dcy[2];
+        size_t bax_size = difference(bx, ax, bax);
+        size_t bay_size = difference(by, ay, bay);
+        size_t dcx_size = difference(dx, cx, dcx);
+        size_t dcy_size = difference(dy, cy, dcy);
+        double left[8], right[8], scratch[8], result[16];
+        size_t left_size = expansion_product(bax, bax_size, dcy, dcy_size, left, scratch);
+        size_t right_size = expansion_product(bay, bay_size, dcx, dcx_size, right, scratch);
+        for (size_t index = 0; index < right_size; index++)
+        {
+            right[index] = -right[index];
+        }
+        size_t size = expansion_sum(left, left_size, right, right_size, result);
+        return estimate(result, size);
+    }
+
+    // The same cross product, filtered: both differences are rounded
+    // once and both products once, exactly as in orient2d.
+    double cross(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy)
+    {
+        double left = (bx - ax) * (dy - cy);
+        double right = (by - ay) * (dx - cx);
+        double determinant = left - right;
+        double bound = ORIENT2D_BOUND * (std::abs(left) + std::abs(right));
+        if (std::abs(determinant) > bound || (left == 0.0 && right == 0.0))
+        {
+            return determinant;
+        }
+        return cross_exact(ax, ay, bx, by, cx, cy, dx, dy);
+    }
+
+    // (a - c) x (b - c), i.e. the cross product of c -> a and c -> b.
+    double orient2d(double ax, double ay, double bx, double by, double cx, double cy)
+    {
+        return cross(cx, cy, ax, ay, cx, cy, bx, by);
+    }
+
+    double orient3d_exact(const thmath::Vec3& a, const thmath::Vec3& b, const thmath::Vec3& c, const thmath::Vec3& d)
+    {
+        // det [a - d; b - d; c - d], expanded along the first row.
+        double ad[3][2], bd[3][2], cd[3][2];
+        size_t ad_size[3], bd_size[3], cd_size[3];
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            ad_size[axis] = difference(a[axis], d[axis], ad[axis]);
+            bd_size[axis] = difference(b[axis], d[axis], bd[axis]);
+            cd_size[axis] = difference(c[axis], d[axis], cd[axis]);
+        }
+        double scratch[32];
+        double result[192];
+        size_t result_size = 0;
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            size_t next = (axis + 1) % 3;
+            size_t last = (axis + 2) % 3;
+            // minor = bd[next] cd[last] - bd[last] cd[next]
+            double left[8], right[8], minor[16], term[64];
+            size_t left_size = expansion_product(bd[next], bd_size[next], cd[last], cd_size[last], left, scratch);
+            size_t right_size = expansion_product(bd[last], bd_size[last], cd[next], cd_size[next], right, scratch);
+            for (size_t index = 0; index < right_size; index++)
+            {
+                right[index] = -right[index];
+            }
+            size_t minor_size = expansion_sum(left, left_size, right, right_size, minor);
+            size_t term_size = expansion_product(minor, minor_size, ad[axis], ad_size[axis], term, scratch);
+            result_size = expansion_sum(result, result_size, term, term_size, result);
+        }
+        return estimate(result, result_size);
+    }
+}
+
+double thmath::predicates::orient2d(const Vec2& a, const Vec2& b, const Vec2& c)
+{
+    return ::orient2d(a[0], a[1], b[0], b[1], c[0], c[1]);
+}
+
+double thmath::predicates::orient3d(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& d)
+{
+    double adx = a[0] - d[0], ady = a[1] - d[1], adz = a[2] - d[2];
+    double bdx = b[0] - d[0], bdy = b[1] - d[1], bdz = b[2] - d[2];
+    double cdx = c[0] - d[0], cdy = c[1] - d[1], cdz = c[2] - d[2];
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+    double determinant = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+    double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * std::abs(adz)
+        + (std::abs(cdxady) + std::abs(adxcdy)) * std::abs(bdz)
+        + (std::abs(adxbdy) + std::abs(bdxady)) * std::abs(cdz);
+    if (std::abs(determinant) > ORIENT3D_BOUND * permanent || permanent == 0.0)
+    {
+        return determinant;
+    }
+    return orient3d_exact(a, b, c, d);
+}
+
+bool thmath::predicates::collinear(const Vec3& a, const Vec3& b, const Vec3& c)
+{
+    // Collinear in space if and only if collinear in the three
+    // coordinate planes (the three components of (b - a) x (c - a)).
+    return ::orient2d(a[0], a[1], b[0], b[1], c[0], c[1]) == 0.0
+        && ::orient2d(a[1], a[2], b[1], b[2], c[1], c[2]) == 0.0
+        && ::orient2d(a[2], a[0], b[2], b[0], c[2], c[0]) == 0.0;
+}
+
+bool thmath::predicates::on_line(const Vec3& origin, const Vec3& direction, const Vec3& point)
+{
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        size_t next = (axis + 1) % 3;
+        size_t last = (axis + 2) % 3;
+        // Component of (point - origin) x direction.
+        double left = (point[next] - origin[next]) * direction[last];
+        double right = (point[last] - origin[last]) * direction[next];
+        double bound = ORIENT2D_BOUND * (std::abs(left) + std::abs(right));
+        if (std::abs(left - right) > bound)
+        {
+            return false;
+        }
+        if (left == 0.0 && right == 0.0)
+        {
+            continue;
+        }
+        double next_difference[2], last_difference[2];
+        size_t next_size = difference(point[next], origin[next], next_difference);
+        size_t last_size = difference(point[last], origin[last], last_difference);
+        double exact_left[4], exact_right[4], result[8];
+        size_t left_size = scale_expansion(next_difference, next_size, direction[last], exact_left);
+        size_t right_size = scale_expansion(last_difference, last_size, -direction[next], exact_right);
+        size_t size = expansion_sum(exact_left, left_size, exact_right, right_size, result);
+        if (result[size - 1] != 0.0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool thmath::predicates::parallel(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& d)
+{
+    // The three components of (b - a) x (d - c).
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        size_t next = (axis + 1) % 3;
+        size_t last = (axis + 2) % 3;
+        if (::cross(a[next], a[last], b[next], b[last], c[next], c[last], d[next], d[last]) != 0.0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool thmath::predicates::parallel(const double* u, const double* v, size_t size, size_t u_stride, size_t v_stride)
+{
+    // With u[k] != 0, u and v are parallel if and only if
+    // u[k] v[i] == u[i] v[k] for every i (then v = v[k] / u[k] u).
+    // Two exact products are equal if and only if their rounded
+    // values and their rounding errors both are.
+    size_t pivot = 0;
+    for (size_t index = 1; index < size; index++)
+    {
+        if (std::abs(u[index * u_stride]) > std::abs(u[pivot * u_stride]))
+        {
+            pivot = index;
+        }
+    }
+    if (size == 0 || u[pivot * u_stride] == 0.0)
+    {
+        return true;
+    }
+    for (size_t index = 0; index < size; index++)
+    {
+        if (index == pivot)
+        {
+            continue;
+        }
+        // Different rounded products already mean different products,
+        // so the rounding errors are only needed to break ties.
+        double u_pivot = u[pivot * u_stride];
+        double u_index = u[index * u_stride];
+        double v_pivot = v[pivot * v_stride];
+        double v_index = v[index * v_stride];
+        double left = u_pivot * v_index;
+        double right = u_index * v_pivot;
+        if (left != right)
+        {
+            return false;
+        }
+        double left_error, right_error;
+        two_product(u_pivot, v_index, left, left_error);
+        two_product(u_index, v_pivot, right, right_error);
+        if (left_error != right_error)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int thmath::predicates::dot_sign(const double* u, const double* v, size_t size, size_t u_stride, size_t v_stride)
+{
+    double sum = 0.0;
+    double magnitude = 0.0;
+    for (size_t index = 0; index < size; index++)
+    {
+        double product = u[index * u_stride] * v[index * v_stride];
+        sum += product;
+        magnitude += std::abs(product);
+    }
+    // Recursive summation of n rounded products is off by at most
+    // about n eps sum(|u_i v_i|).
+    double bound = 2.0 * static_cast<double>(size + 1) * EPSILON * magnitude;
+    if (std::abs(sum) > bound)
+    {
+        return sum > 0.0 ? 1 : -1;
+    }
+    if (magnitude == 0.0)
+    {
+        return 0;
+    }
+    std::vector<double> expansion(2 * size + 1);
+    size_t expansion_size = 0;
+    for (size_t index = 0; index < size; index++)
+    {
+        double product, error;
+        two_product(u[index * u_stride], v[index * v_stride], product, error);
+        expansion_size = grow_expansion(expansion.data(), expansion_size, error, expansion.data());
+        expansion_size = grow_expansion(expansion.data(), expansion_size, product, expansion.data());
+    }
+    double largest = expansion[expansion_size - 1];
+    return largest > 0.0 ? 1 : (largest < 0.0 ? -1 : 0);
+}
+
+bool thmath::predicates::perpendicular(const double* u, const double* v, size_t size, size_t u_stride, size_t v_stride)
+{
+    return dot_sign(u, v, size, u_stride, v_stride) == 0;
+}
+
+bool thmath::predicates::perpendicular(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& d)
+{
+    // Every difference is the exact sum x + y of two doubles, so
+    // (b - a) . (d - c) is the sum of the four cross terms per axis.
+    double u[12], v[12];
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        double u_terms[2], v_terms[2];
+        two_diff(b[axis], a[axis], u_terms[0], u_terms[1]);
+        two_diff(d[axis], c[axis], v_terms[0], v_terms[1]);
+        for (size_t term = 0; term < 4; term++)
+        {
+            u[4 * axis + term] = u_terms[term / 2];
+            v[4 * axis + term] = v_terms[term % 2];
+        }
+    }
+    return dot_sign(u, v, 12) == 0;
+}
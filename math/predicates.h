@@ -0,0 +1,164 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#ifndef __THMATH_PREDICATES_
+#define __THMATH_PREDICATES_
+
+#include "vec.h"
+#include <cstddef>
+
+namespace thmath
+{
+    /**
+     * Robust geometric predicates, after Shewchuk's adaptive
+     * precision arithmetic. Every predicate first evaluates its
+     * expression in plain floating point along with a bound on the
+     * rounding error; only when the result is too close to zero to
+     * be trusted is it recomputed exactly, as an expansion (a sum
+     * of non-overlapping doubles, built from error-free sums and
+     * products). The answers are therefore exact for every finite
+     * input, while the common case costs a few extra operations.
+     * Exactness assumes that no intermediate product underflows.
+    */
+    namespace predicates
+    {
+        /**
+         * Orientation of three points of the plane.
+         *
+         * @param a The first point.
+         * @param b The second point.
+         * @param c The third point.
+         * @return A value which is positive if a, b and c turn
+         * counterclockwise, negative if they turn clockwise, and
+         * zero if they are collinear; it approximates twice the
+         * signed area of the triangle, and its sign is exact.
+        */
+        double orient2d(const Vec2& a, const Vec2& b, const Vec2& c);
+
+        /**
+         * Orientation of four points of space.
+         *
+         * @param a The first point.
+         * @param b The second point.
+         * @param c The third point.
+         * @param d The fourth point.
+         * @return A value which is positive if d lies below the
+         * plane through a, b and c (which turn counterclockwise
+         * seen from above), negative if above, and zero if the four
+         * points are coplanar; it approximates six times the signed
+         * volume of the tetrahedron, and its sign is exact.
+        */
+        double orient3d(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& d);
+
+        /**
+         * Check whether three points of space are collinear.
+         *
+         * @param a The first point.
+         * @param b The second point.
+         * @param c The third point.
+         * @return Whether the three points lie on a common line.
+        */
+        bool collinear(const Vec3& a, const Vec3& b, const Vec3& c);
+
+        /**
+         * Check whether a point lies on the line through an
+         * origin along a direction, i.e. whether
+         * (point - origin) x direction is exactly null.
+         *
+         * @param origin A point of the line.
+         * @param direction The direction of the line.
+         * @param point The point to check.
+         * @return Whether the point lies on the line.
+        */
+        bool on_line(const Vec3& origin, const Vec3& direction, const Vec3& point);
+
+        /**
+         * Check whether two vectors are parallel, i.e. whether
+         * one of them is a multiple of the other. The null vector
+         * is parallel to every vector.
+         *
+         * @param u The first vector.
+         * @param v The second vector.
+         * @param size The number of components of each vector.
+         * @param u_stride The distance between two components of u.
+         * @param v_stride The distance between two components of v.
+         * @return Whether the two vectors are parallel.
+        */
+        bool parallel(const double* u, const double* v, size_t size, size_t u_stride = 1, size_t v_stride = 1);
+
+        /**
+         * Check whether the differences b - a and d - c are
+         * parallel, without rounding the differences first, e.g.
+         * for two lines given by two points each.
+         *
+         * @param a The start of the first difference.
+         * @param b The end of the first difference.
+         * @param c The start of the second difference.
+         * @param d The end of the second difference.
+         * @return Whether (b - a) x (d - c) is exactly null.
+        */
+        bool parallel(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& d);
+
+        /**
+         * Return the exact sign of the scalar product of two vectors.
+         *
+         * @param u The first vector.
+         * @param v The second vector.
+         * @param size The number of components of each vector.
+         * @param u_stride The distance between two components of u.
+         * @param v_stride The distance between two components of v.
+         * @return -1, 0 or 1.
+        */
+        int dot_sign(const double* u, const double* v, size_t size, size_t u_stride = 1, size_t v_stride = 1);
+
+        /**
+         * Check whether two vectors are perpendicular, i.e.
+         * whether their scalar product is exactly null.
+         *
+         * @param u The first vector.
+         * @param v The second vector.
+         * @param size The number of components of each vector.
+         * @param u_stride The distance between two components of u.
+         * @param v_stride The distance between two components of v.
+         * @return Whether the two vectors are perpendicular.
+        */
+        bool perpendicular(const double* u, const double* v, size_t size, size_t u_stride = 1, size_t v_stride = 1);
+
+        /**
+         * Check whether the differences b - a and d - c are
+         * perpendicular, without rounding the differences first.
+         *
+         * @param a The start of the first difference.
+         * @param b The end of the first difference.
+         * @param c The start of the second difference.
+         * @param d The end of the second difference.
+         * @return Whether (b - a) . (d - c) is exactly null.
+        */
+        bool perpendicular(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& d);
+    }
+}
+
+#endif
@@ -0,0 +1,833 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "simd.h"
+#include <atomic>
+
+#ifdef THMATH_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    using thmath::simd::InstructionSet;
+
+    struct KernelTable
+    {
+        InstructionSet instruction_set;
+        double (*dot)(const double*, const double*, size_t);
+        void (*scale)(double*, double, size_t);
+        void (*add)(double*, const double*, size_t);
+        void (*subtract)(double*, const double*, size_t);
+        void (*axpby)(double*, double, const double*, double, size_t);
+        void (*dot_norms)(const double*, const double*, size_t, double*);
+        void (*multi_dot)(const double*, const double* const*, size_t, size_t, double*);
+    };
+
+    double dot_scalar(const double* a, const double* b, size_t size)
+    {
+        double result = 0.0;
+        for (size_t index = 0; index < size; index++)
+        {
+            result += a[index] * b[index];
+        }
+        return result;
+    }
+
+    void scale_scalar(double* a, double lambda, size_t size)
+    {
+        for (size_t index = 0; index < size; index++)
+        {
+            a[index] *= lambda;
+        }
+    }
+
+    void add_scalar(double* a, const double* b, size_t size)
+    {
+        for (size_t index = 0; index < size; index++)
+        {
+            a[index] += b[index];
+        }
+    }
+
+    void subtract_scalar(double* a, const double* b, size_t size)
+    {
+        for (size_t index = 0; index < size; index++)
+        {
+            a[index] -= b[index];
+        }
+    }
+
+    void axpby_scalar(double* y, double alpha, const double* x, double beta, size_t size)
+    {
+        for (size_t index = 0; index < size; index++)
+        {
+            y[index] = alpha * x[index] + beta * y[index];
+        }
+    }
+
+    void dot_norms_scalar(const double* a, const double* b, size_t size, double* results)
+    {
+        double dot = 0.0;
+        double a_squares = 0.0;
+        double b_squares = 0.0;
+        for (size_t index = 0; index < size; index++)
+        {
+            dot += a[index] * b[index];
+            a_squares += a[index] * a[index];
+            b_squares += b[index] * b[index];
+        }
+        results[0] = dot;
+        results[1] = a_squares;
+        results[2] = b_squares;
+    }
+
+    void multi_dot_scalar(const double* a, const double* const* others, size_t count, size_t size, double* results)
+    {
+        size_t other = 0;
+        for (; other + 4 <= count; other += 4)
+        {
+            const double* b0 = others[other];
+            const double* b1 = others[other + 1];
+            const double* b2 = others[other + 2];
+            const double* b3 = others[other + 3];
+            double sum0 = 0.0;
+            double sum1 = 0.0;
+            double sum2 = 0.0;
+            double sum3 = 0.0;
+            for (size_t index = 0; index < size; index++)
+            {
+                sum0 += a[index] * b0[index];
+                sum1 += a[index] * b1[index];
+                sum2 += a[index] * b2[index];
+                sum3 += a[index] * b3[index];
+            }
+            results[other] = sum0;
+            results[other + 1] = sum1;
+            results[other + 2] = sum2;
+            results[other + 3] = sum3;
+        }
+        for (; other < count; other++)
+        {
+            results[other] = dot_scalar(a, others[other], size);
+        }
+    }
+
+    const KernelTable SCALAR_KERNELS = {
+        InstructionSet::SCALAR, dot_scalar, scale_scalar, add_scalar, subtract_scalar,
+        axpby_scalar, dot_norms_scalar, multi_dot_scalar
+    };
+
+#ifdef THMATH_SIMD_X86
+    __attribute__((target("sse2")))
+    double dot_sse2(const double* a, const double* b, size_t size)
+    {
+        __m128d sum0 = _mm_setzero_pd();
+        __m128d sum1 = _mm_setzero_pd();
+        size_t index = 0;
+        for (; index + 4 <= size; index += 4)
+        {
+            sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(a + index), _mm_loadu_pd(b + index)));
+            sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_loadu_pd(a + index + 2), _mm_loadu_pd(b + index + 2)));
+        }
+        double lanes[2];
+        _mm_storeu_pd(lanes, _mm_add_pd(sum0, sum1));
+        double result = lanes[0] + lanes[1];
+        for (; index < size; index++)
+        {
+            result += a[index] * b[index];
+        }
+        return result;
+    }
+
+    __attribute__((target("sse2")))
+    void scale_sse2(double* a, double lambda, size_t size)
+    {
+        __m128d factor = _mm_set1_pd(lambda);
+        size_t index = 0;
+        for (; index + 2 <= size; index += 2)
+        {
+            _mm_storeu_pd(a + index, _mm_mul_pd(_mm_loadu_pd(a + index), factor));
+        }
+        for (; index < size; index++)
+        {
+            a[index] *= lambda;
+        }
+    }
+
+    __attribute__((target("sse2")))
+    void add_sse2(double* a, const double* b, size_t size)
+    {
+        size_t index = 0;
+        for (; index + 2 <= size; index += 2)
+        {
+            _mm_storeu_pd(a + index, _mm_add_pd(_mm_loadu_pd(a + index), _mm_loadu_pd(b + index)));
+        }
+        for (; index < size; index++)
+        {
+            a[index] += b[index];
+        }
+    }
+
+    __attribute__((target("sse2")))
+    void subtract_sse2(double* a, const double* b, size_t size)
+    {
+        size_t index = 0;
+        for (; index + 2 <= size; index += 2)
+        {
+            _mm_storeu_pd(a + index, _mm_sub_pd(_mm_loadu_pd(a + index), _mm_loadu_pd(b + index)));
+        }
+        for (; index < size; index++)
+        {
+            a[index] -= b[index];
+        }
+    }
+
+    __attribute__((target("sse2")))
+    void axpby_sse2(double* y, double alpha, const double* x, double beta, size_t size)
+    {
+        __m128d x_factor = _mm_set1_pd(alpha);
+        __m128d y_factor = _mm_set1_pd(beta);
+        size_t index = 0;
+        for (; index + 2 <= size; index += 2)
+        {
+            _mm_storeu_pd(y + index, _mm_add_pd(
+                _mm_mul_pd(x_factor, _mm_loadu_pd(x + index)), _mm_mul_pd(y_factor, _mm_loadu_pd(y + index))
+            ));
+        }
+        for (; index < size; index++)
+        {
+            y[index] = alpha * x[index] + beta * y[index];
+        }
+    }
+
+    __attribute__((target("sse2")))
+    double reduce_sse2(__m128d sum0, __m128d sum1)
+    {
+        double lanes[2];
+        _mm_storeu_pd(lanes, _mm_add_pd(sum0, sum1));
+        return lanes[0] + lanes[1];
+    }
+
+    __attribute__((target("sse2")))
+    void dot_norms_sse2(const double* a, const double* b, size_t size, double* results)
+    {
+        __m128d dot0 = _mm_setzero_pd();
+        __m128d dot1 = _mm_setzero_pd();
+        __m128d a_squares0 = _mm_setzero_pd();
+        __m128d a_squares1 = _mm_setzero_pd();
+        __m128d b_squares0 = _mm_setzero_pd();
+        __m128d b_squares1 = _mm_setzero_pd();
+        size_t index = 0;
+        for (; index + 4 <= size; index += 4)
+        {
+            __m128d a0 = _mm_loadu_pd(a + index);
+            __m128d a1 = _mm_loadu_pd(a + index + 2);
+            __m128d b0 = _mm_loadu_pd(b + index);
+            __m128d b1 = _mm_loadu_pd(b + index + 2);
+            dot0 = _mm_add_pd(dot0, _mm_mul_pd(a0, b0));
+            dot1 = _mm_add_pd(dot1, _mm_mul_pd(a1, b1));
+            a_squares0 = _mm_add_pd(a_squares0, _mm_mul_pd(a0, a0));
+            a_squares1 = _mm_add_pd(a_squares1, _mm_mul_pd(a1, a1));
+            b_squares0 = _mm_add_pd(b_squares0, _mm_mul_pd(b0, b0));
+            b_squares1 = _mm_add_pd(b_squares1, _mm_mul_pd(b1, b1));
+        }
+        double dot = reduce_sse2(dot0, dot1);
+        double a_squares = reduce_sse2(a_squares0, a_squares1);
+        double b_squares = reduce_sse2(b_squares0, b_squares1);
+        for (; index < size; index++)
+        {
+            dot += a[index] * b[index];
+            a_squares += a[index] * a[index];
+            b_squares += b[index] * b[index];
+        }
+        results[0] = dot;
+        results[1] = a_squares;
+        results[2] = b_squares;
+    }
+
+    void multi_dot_sse2(const double* a, const double* const* others, size_t count, size_t size, double* results)
+    {
+        for (size_t other = 0; other < count; other++)
+        {
+            results[other] = dot_sse2(a, others[other], size);
+        }
+    }
+
+    __attribute__((target("avx2,fma")))
+    double reduce_avx2(__m256d sum0, __m256d sum1, __m256d sum2, __m256d sum3)
+    {
+        __m256d sum = _mm256_add_pd(_mm256_add_pd(sum0, sum1), _mm256_add_pd(sum2, sum3));
+        __m128d half = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+    }
+
+    __attribute__((target("avx2,fma")))
+    double dot_avx2(const double* a, const double* b, size_t size)
+    {
+        __m256d sum0 = _mm256_setzero_pd();
+        __m256d sum1 = _mm256_setzero_pd();
+        __m256d sum2 = _mm256_setzero_pd();
+        __m256d sum3 = _mm256_setzero_pd();
+        size_t index = 0;
+        for (; index + 16 <= size; index += 16)
+        {
+            sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + index), _mm256_loadu_pd(b + index), sum0);
+            sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + index + 4), _mm256_loadu_pd(b + index + 4), sum1);
+            sum2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + index + 8), _mm256_loadu_pd(b + index + 8), sum2);
+            sum3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + index + 12), _mm256_loadu_pd(b + index + 12), sum3);
+        }
+        for (; index + 4 <= size; index += 4)
+        {
+            sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + index), _mm256_loadu_pd(b + index), sum0);
+        }
+        double result = reduce_avx2(sum0, sum1, sum2, sum3);
+        for (; index < size; index++)
+        {
+            result += a[index] * b[index];
+        }
+        return result;
+    }
+
+    __attribute__((target("avx2")))
+    void scale_avx2(double* a, double lambda, size_t size)
+    {
+        __m256d factor = _mm256_set1_pd(lambda);
+        size_t index = 0;
+        for (; index + 4 <= size; index += 4)
+        {
+            _mm256_storeu_pd(a + index, _mm256_mul_pd(_mm256_loadu_pd(a + index), factor));
+        }
+        for (; index < size; index++)
+        {
+            a[index] *= lambda;
+        }
+    }
+
+    __attribute__((target("avx2")))
+    void add_avx2(double* a, const double* b, size_t size)
+    {
+        size_t index = 0;
+        for (; index + 4 <= size; index += 4)
+        {
+            _mm256_storeu_pd(a + index, _mm256_add_pd(_mm256_loadu_pd(a + index), _mm256_loadu_pd(b + index)));
+        }
+        for (; index < size; index++)
+        {
+            a[index] += b[index];
+        }
+    }
+
+    __attribute__((target("avx2")))
+    void subtract_avx2(double* a, const double* b, size_t size)
+    {
+        size_t index = 0;
+        for (; index + 4 <= size; index += 4)
+        {
+            _mm256_storeu_pd(a + index, _mm256_sub_pd(_mm256_loadu_pd(a + index), _mm256_loadu_pd(b + index)));
+        }
+        for (; index < size; index++)
+        {
+            a[index] -= b[index];
+        }
+    }
+
+    __attribute__((target("avx2,fma")))
+    void axpby_avx2(double* y, double alpha, const double* x, double beta, size_t size)
+    {
+        __m256d x_factor = _mm256_set1_pd(alpha);
+        __m256d y_factor = _mm256_set1_pd(beta);
+        size_t index = 0;
+        for (; index + 4 <= size; index += 4)
+        {
+            _mm256_storeu_pd(y + index, _mm256_fmadd_pd(
+                x_factor, _mm256_loadu_pd(x + index), _mm256_mul_pd(y_factor, _mm256_loadu_pd(y + index))
+            ));
+        }
+        for (; index < size; index++)
+        {
+            y[index] = __builtin_fma(alpha, x[index], beta * y[index]);
+        }
+    }
+
+    __attribute__((target("avx2,fma")))
+    void dot_norms_avx2(const double* a, const double* b, size_t size, double* results)
+    {
+        // Four accumulators per sum, laid out as in dot_avx2.
+        __m256d dot[4];
+        __m256d a_squares[4];
+        __m256d b_squares[4];
+        for (size_t lane = 0; lane < 4; lane++)
+        {
+            dot[lane] = _mm256_setzero_pd();
+            a_squares[lane] = _mm256_setzero_pd();
+            b_squares[lane] = _mm256_setzero_pd();
+        }
+        size_t index = 0;
+        for (; index + 16 <= size; index += 16)
+        {
+            for (size_t lane = 0; lane < 4; lane++)
+            {
+                __m256d va = _mm256_loadu_pd(a + index + 4 * lane);
+                __m256d vb = _mm256_loadu_pd(b + index + 4 * lane);
+                dot[lane] = _mm256_fmadd_pd(va, vb, dot[lane]);
+                a_squares[lane] = _mm256_fmadd_pd(va, va, a_squares[lane]);
+                b_squares[lane] = _mm256_fmadd_pd(vb, vb, b_squares[lane]);
+            }
+        }
+        for (; index + 4 <= size; index += 4)
+        {
+            __m256d va = _mm256_loadu_pd(a + index);
+            __m256d vb = _mm256_loadu_pd(b + index);
+            dot[0] = _mm256_fmadd_pd(va, vb, dot[0]);
+            a_squares[0] = _mm256_fmadd_pd(va, va, a_squares[0]);
+            b_squares[0] = _mm256_fmadd_pd(vb, vb, b_squares[0]);
+        }
+        double dot_sum = reduce_avx2(dot[0], dot[1], dot[2], dot[3]);
+        double a_sum = reduce_avx2(a_squares[0], a_squares[1], a_squares[2], a_squares[3]);
+        double b_sum = reduce_avx2(b_squares[0], b_squares[1], b_squares[2], b_squares[3]);
+        for (; index < size; index++)
+        {
+            dot_sum += a[index] * b[index];
+            a_sum += a[index] * a[index];
+            b_sum += b[index] * b[index];
+        }
+        results[0] = dot_sum;
+        results[1] = a_sum;
+        results[2] = b_sum;
+    }
+
+    /**
+     * The scalar products of a with BLOCK other arrays, each
+     * accumulated as in dot_avx2. Three arrays keep the twelve
+     * accumulators (and the loads) within the 16 registers.
+    */
+    template <size_t BLOCK>
+    __attribute__((target("avx2,fma")))
+    void dot_block_avx2(const double* a, const double* const* others, size_t size, double* results)
+    {
+        __m256d sums[BLOCK][4];
+        for (size_t other = 0; other < BLOCK; other++)
+        {
+            for (size_t lane = 0; lane < 4; lane++)
+            {
+                sums[other][lane] = _mm256_setzero_pd();
+            }
+        }
+        size_t index = 0;
+        for (; index + 16 <= size; index += 16)
+        {
+            for (size_t lane = 0; lane < 4; lane++)
+            {
+                __m256d va = _mm256_loadu_pd(a + index + 4 * lane);
+                for (size_t other = 0; other < BLOCK; other++)
+                {
+                    sums[other][lane] = _mm256_fmadd_pd(va, _mm256_loadu_pd(others[other] + index + 4 * lane), sums[other][lane]);
+                }
+            }
+        }
+        for (; index + 4 <= size; index += 4)
+        {
+            __m256d va = _mm256_loadu_pd(a + index);
+            for (size_t other = 0; other < BLOCK; other++)
+            {
+                sums[other][0] = _mm256_fmadd_pd(va, _mm256_loadu_pd(others[other] + index), sums[other][0]);
+            }
+        }
+        for (size_t other = 0; other < BLOCK; other++)
+        {
+            double result = reduce_avx2(sums[other][0], sums[other][1], sums[other][2], sums[other][3]);
+            for (size_t tail = index; tail < size; tail++)
+            {
+                result += a[tail] * others[other][tail];
+            }
+            results[other] = result;
+        }
+    }
+
+    void multi_dot_avx2(const double* a, const double* const* others, size_t count, size_t size, double* results)
+    {
+        size_t other = 0;
+        for (; other + 3 <= count; other += 3)
+        {
+            dot_block_avx2<3>(a, others + other, size, results + other);
+        }
+        if (count - other == 2)
+        {
+            dot_block_avx2<2>(a, others + other, size, results + other);
+        }
+        else if (count - other == 1)
+        {
+            results[other] = dot_avx2(a, others[other], size);
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    double reduce_avx512(__m512d sum0, __m512d sum1, __m512d sum2, __m512d sum3)
+    {
+        double lanes[8];
+        _mm512_storeu_pd(lanes, _mm512_add_pd(_mm512_add_pd(sum0, sum1), _mm512_add_pd(sum2, sum3)));
+        return ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) + ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+    }
+
+    __attribute__((target("avx512f")))
+    double dot_avx512(const double* a, const double* b, size_t size)
+    {
+        __m512d sum0 = _mm512_setzero_pd();
+        __m512d sum1 = _mm512_setzero_pd();
+        __m512d sum2 = _mm512_setzero_pd();
+        __m512d sum3 = _mm512_setzero_pd();
+        size_t index = 0;
+        for (; index + 32 <= size; index += 32)
+        {
+            sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + index), _mm512_loadu_pd(b + index), sum0);
+            sum1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + index + 8), _mm512_loadu_pd(b + index + 8), sum1);
+            sum2 = _mm512_fmadd_pd(_mm512_loadu_pd(a + index + 16), _mm512_loadu_pd(b + index + 16), sum2);
+            sum3 = _mm512_fmadd_pd(_mm512_loadu_pd(a + index + 24), _mm512_loadu_pd(b + index + 24), sum3);
+        }
+        for (; index + 8 <= size; index += 8)
+        {
+            sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + index), _mm512_loadu_pd(b + index), sum0);
+        }
+        if (index < size)
+        {
+            __mmask8 mask = static_cast<__mmask8>((1u << (size - index)) - 1);
+            sum1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a + index), _mm512_maskz_loadu_pd(mask, b + index), sum1);
+        }
+        return reduce_avx512(sum0, sum1, sum2, sum3);
+    }
+
+    __attribute__((target("avx512f")))
+    void scale_avx512(double* a, double lambda, size_t size)
+    {
+        __m512d factor = _mm512_set1_pd(lambda);
+        size_t index = 0;
+        for (; index + 8 <= size; index += 8)
+        {
+            _mm512_storeu_pd(a + index, _mm512_mul_pd(_mm512_loadu_pd(a + index), factor));
+        }
+        if (index < size)
+        {
+            __mmask8 mask = static_cast<__mmask8>((1u << (size - index)) - 1);
+            _mm512_mask_storeu_pd(a + index, mask, _mm512_mul_pd(_mm512_maskz_loadu_pd(mask, a + index), factor));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void add_avx512(double* a, const double* b, size_t size)
+    {
+        size_t index = 0;
+        for (; index + 8 <= size; index += 8)
+        {
+            _mm512_storeu_pd(a + index, _mm512_add_pd(_mm512_loadu_pd(a + index), _mm512_loadu_pd(b + index)));
+        }
+        if (index < size)
+        {
+            __mmask8 mask = static_cast<__mmask8>((1u << (size - index)) - 1);
+            _mm512_mask_storeu_pd(a + index, mask, _mm512_add_pd(
+                _mm512_maskz_loadu_pd(mask, a + index), _mm512_maskz_loadu_pd(mask, b + index)
+            ));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void subtract_avx512(double* a, const double* b, size_t size)
+    {
+        size_t index = 0;
+        for (; index + 8 <= size; index += 8)
+        {
+            _mm512_storeu_pd(a + index, _mm512_sub_pd(_mm512_loadu_pd(a + index), _mm512_loadu_pd(b + index)));
+        }
+        if (index < size)
+        {
+            __mmask8 mask = static_cast<__mmask8>((1u << (size - index)) - 1);
+            _mm512_mask_storeu_pd(a + index, mask, _mm512_sub_pd(
+                _mm512_maskz_loadu_pd(mask, a + index), _mm512_maskz_loadu_pd(mask, b + index)
+            ));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void axpby_avx512(double* y, double alpha, const double* x, double beta, size_t size)
+    {
+        __m512d x_factor = _mm512_set1_pd(alpha);
+        __m512d y_factor = _mm512_set1_pd(beta);
+        size_t index = 0;
+        for (; index + 8 <= size; index += 8)
+        {
+            _mm512_storeu_pd(y + index, _mm512_fmadd_pd(
+                x_factor, _mm512_loadu_pd(x + index), _mm512_mul_pd(y_factor, _mm512_loadu_pd(y + index))
+            ));
+        }
+        if (index < size)
+        {
+            __mmask8 mask = static_cast<__mmask8>((1u << (size - index)) - 1);
+            _mm512_mask_storeu_pd(y + index, mask, _mm512_fmadd_pd(
+                x_factor, _mm512_maskz_loadu_pd(mask, x + index), _mm512_mul_pd(y_factor, _mm512_maskz_loadu_pd(mask, y + index))
+            ));
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void dot_norms_avx512(const double* a, const double* b, size_t size, double* results)
+    {
+        // Four accumulators per sum, laid out as in dot_avx512.
+        __m512d dot[4];
+        __m512d a_squares[4];
+        __m512d b_squares[4];
+        for (size_t lane = 0; lane < 4; lane++)
+        {
+            dot[lane] = _mm512_setzero_pd();
+            a_squares[lane] = _mm512_setzero_pd();
+            b_squares[lane] = _mm512_setzero_pd();
+        }
+        size_t index = 0;
+        for (; index + 32 <= size; index += 32)
+        {
+            for (size_t lane = 0; lane < 4; lane++)
+            {
+                __m512d va = _mm512_loadu_pd(a + index + 8 * lane);
+                __m512d vb = _mm512_loadu_pd(b + index + 8 * lane);
+                dot[lane] = _mm512_fmadd_pd(va, vb, dot[lane]);
+                a_squares[lane] = _mm512_fmadd_pd(va, va, a_squares[lane]);
+                b_squares[lane] = _mm512_fmadd_pd(vb, vb, b_squares[lane]);
+            }
+        }
+        for (; index + 8 <= size; index += 8)
+        {
+            __m512d va = _mm512_loadu_pd(a + index);
+            __m512d vb = _mm512_loadu_pd(b + index);
+            dot[0] = _mm512_fmadd_pd(va, vb, dot[0]);
+            a_squares[0] = _mm512_fmadd_pd(va, va, a_squares[0]);
+            b_squares[0] = _mm512_fmadd_pd(vb, vb, b_squares[0]);
+        }
+        if (index < size)
+        {
+            __mmask8 mask = static_cast<__mmask8>((1u << (size - index)) - 1);
+            __m512d va = _mm512_maskz_loadu_pd(mask, a + index);
+            __m512d vb = _mm512_maskz_loadu_pd(mask, b + index);
+            dot[1] = _mm512_fmadd_pd(va, vb, dot[1]);
+            a_squares[1] = _mm512_fmadd_pd(va, va, a_squares[1]);
+            b_squares[1] = _mm512_fmadd_pd(vb, vb, b_squares[1]);
+        }
+        results[0] = reduce_avx512(dot[0], dot[1], dot[2], dot[3]);
+        results[1] = reduce_avx512(a_squares[0], a_squares[1], a_squares[2], a_squares[3]);
+        results[2] = reduce_avx512(b_squares[0], b_squares[1], b_squares[2], b_squares[3]);
+    }
+
+    /**
+     * The scalar products of a with BLOCK other arrays, each
+     * accumulated as in dot_avx512.
+    */
+    template <size_t BLOCK>
+    __attribute__((target("avx512f")))
+    void dot_block_avx512(const double* a, const double* const* others, size_t size, double* results)
+    {
+        __m512d sums[BLOCK][4];
+        for (size_t other = 0; other < BLOCK; other++)
+        {
+            for (size_t lane = 0; lane < 4; lane++)
+            {
+                sums[other][lane] = _mm512_setzero_pd();
+            }
+        }
+        size_t index = 0;
+        for (; index + 32 <= size; index += 32)
+        {
+            for (size_t lane = 0; lane < 4; lane++)
+            {
+                __m512d va = _mm512_loadu_pd(a + index + 8 * lane);
+                for (size_t other = 0; other < BLOCK; other++)
+                {
+                    sums[other][lane] = _mm512_fmadd_pd(va, _mm512_loadu_pd(others[other] + index + 8 * lane), sums[other][lane]);
+                }
+            }
+        }
+        for (; index + 8 <= size; index += 8)
+        {
+            __m512d va = _mm512_loadu_pd(a + index);
+            for (size_t other = 0; other < BLOCK; other++)
+            {
+                sums[other][0] = _mm512_fmadd_pd(va, _mm512_loadu_pd(others[other] + index), sums[other][0]);
+            }
+        }
+        if (index < size)
+        {
+            __mmask8 mask = static_cast<__mmask8>((1u << (size - index)) - 1);
+            __m512d va = _mm512_maskz_loadu_pd(mask, a + index);
+            for (size_t other = 0; other < BLOCK; other++)
+            {
+                sums[other][1] = _mm512_fmadd_pd(va, _mm512_maskz_loadu_pd(mask, others[other] + index), sums[other][1]);
+            }
+        }
+        for (size_t other = 0; other < BLOCK; other++)
+        {
+            results[other] = reduce_avx512(sums[other][0], sums[other][1], sums[other][2], sums[other][3]);
+        }
+    }
+
+    void multi_dot_avx512(const double* a, const double* const* others, size_t count, size_t size, double* results)
+    {
+        size_t other = 0;
+        for (; other + 4 <= count; other += 4)
+        {
+            dot_block_avx512<4>(a, others + other, size, results + other);
+        }
+        for (; other < count; other++)
+        {
+            results[other] = dot_avx512(a, others[other], size);
+        }
+    }
+
+    const KernelTable SSE2_KERNELS = {
+        InstructionSet::SSE2, dot_sse2, scale_sse2, add_sse2, subtract_sse2,
+        axpby_sse2, dot_norms_sse2, multi_dot_sse2
+    };
+
+    const KernelTable AVX2_KERNELS = {
+        InstructionSet::AVX2, dot_avx2, scale_avx2, add_avx2, subtract_avx2,
+        axpby_avx2, dot_norms_avx2, multi_dot_avx2
+    };
+
+    const KernelTable AVX512_KERNELS = {
+        InstructionSet::AVX512, dot_avx512, scale_avx512, add_avx512, subtract_avx512,
+        axpby_avx512, dot_norms_avx512, multi_dot_avx512
+    };
+#endif
+
+    const KernelTable* table_for(InstructionSet instruction_set)
+    {
+        switch (instruction_set)
+        {
+#ifdef THMATH_SIMD_X86
+            case InstructionSet::AVX512:
+                return &AVX512_KERNELS;
+            case InstructionSet::AVX2:
+                return &AVX2_KERNELS;
+            case InstructionSet::SSE2:
+                return &SSE2_KERNELS;
+#endif
+            default:
+                return &SCALAR_KERNELS;
+        }
+    }
+
+    std::atomic<const KernelTable*> active_kernels{nullptr};
+
+    const KernelTable& kernels()
+    {
+        const KernelTable* table = active_kernels.load(std::memory_order_acquire);
+        if (table == nullptr)
+        {
+            table = table_for(thmath::simd::get_supported_instruction_set());
+            active_kernels.store(table, std::memory_order_release);
+        }
+        return *table;
+    }
+}
+
+thmath::simd::InstructionSet thmath::simd::get_supported_instruction_set()
+{
+#ifdef THMATH_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return InstructionSet::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        return InstructionSet::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return InstructionSet::SSE2;
+    }
+#endif
+    return InstructionSet::SCALAR;
+}
+
+thmath::simd::InstructionSet thmath::simd::get_instruction_set()
+{
+    return kernels().instruction_set;
+}
+
+thmath::simd::InstructionSet thmath::simd::set_instruction_set(InstructionSet instruction_set)
+{
+    InstructionSet supported = get_supported_instruction_set();
+    if (static_cast<int>(instruction_set) > static_cast<int>(supported))
+    {
+        instruction_set = supported;
+    }
+    active_kernels.store(table_for(instruction_set), std::memory_order_release);
+    return instruction_set;
+}
+
+const char* thmath::simd::to_string(InstructionSet instruction_set)
+{
+    switch (instruction_set)
+    {
+        case InstructionSet::SSE2:
+            return "SSE2";
+        case InstructionSet::AVX2:
+            return "AVX2";
+        case InstructionSet::AVX512:
+            return "AVX-512";
+        default:
+            return "scalar";
+    }
+}
+
+double thmath::simd::dot(const double* a, const double* b, size_t size)
+{
+    return kernels().dot(a, b, size);
+}
+
+void thmath::simd::scale(double* a, double lambda, size_t size)
+{
+    kernels().scale(a, lambda, size);
+}
+
+void thmath::simd::add(double* a, const double* b, size_t size)
+{
+    kernels().add(a, b, size);
+}
+
+void thmath::simd::subtract(double* a, const double* b, size_t size)
+{
+    kernels().subtract(a, b, size);
+}
+
+void thmath::simd::axpby(double* y, double alpha, const double* x, double beta, size_t size)
+{
+    kernels().axpby(y, alpha, x, beta, size);
+}
+
+void thmath::simd::dot_norms(const double* a, const double* b, size_t size, double* results)
+{
+    kernels().dot_norms(a, b, size, results);
+}
+
+void thmath::simd::multi_dot(const double* a, const double* const* others, size_t count, size_t size, double* results)
+{
+    kernels().multi_dot(a, others, count, size, results);
+}
@@ -0,0 +1,183 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __THMATH_SIMD_
+#define __THMATH_SIMD_
+
+#include <cstddef>
+
+// Set when the x86 SIMD kernels can be built, i.e. on x86 with a
+// compiler supporting per-function target attributes.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define THMATH_SIMD_X86 1
+#endif
+
+namespace thmath
+{
+    /**
+     * Hand-written SIMD kernels for the dense vector operations.
+     * The widest instruction set supported by the CPU is detected
+     * (via cpuid) the first time a kernel runs, and every call is
+     * then dispatched to it; a portable scalar implementation is
+     * used on other architectures and compilers.
+     *
+     * Accuracy with respect to the scalar kernels:
+     *  - scale, add and subtract perform exactly one IEEE operation
+     *    per component, so they are bit-identical (0 ULP).
+     *  - dot accumulates in several lanes (and uses fused multiply-add
+     *    where available), i.e. it sums in a different order. Both
+     *    results are within n * eps * sum(|a_i * b_i|) of the exact
+     *    value, hence within 2 * n * eps * sum(|a_i * b_i|) of each
+     *    other; when all the products have the same sign, this is at
+     *    most 2n ULP of the result.
+     *  - dot_norms and multi_dot accumulate every one of their sums
+     *    exactly as dot does, so they match it bit for bit.
+     *  - axpby rounds beta * y_i, then adds alpha * x_i with a fused
+     *    multiply-add where available (scalar and SSE2 round the
+     *    product too), i.e. the kernels differ by one rounding of
+     *    alpha * x_i and are within 2 * eps * (|alpha * x_i| +
+     *    |beta * y_i|) of each other. This is a few ULP of the
+     *    result at most, unless the two terms cancel.
+    */
+    namespace simd
+    {
+        enum class InstructionSet
+        {
+            SCALAR,
+            SSE2,
+            AVX2,
+            AVX512
+        };
+
+        /**
+         * Return the instruction set whose kernels
+         * are currently in use.
+         *
+         * @return The active instruction set.
+        */
+        InstructionSet get_instruction_set();
+
+        /**
+         * Return the widest instruction set supported
+         * by the CPU (and by this build).
+         *
+         * @return The widest supported instruction set.
+        */
+        InstructionSet get_supported_instruction_set();
+
+        /**
+         * Force the kernels of a given instruction set, e.g.
+         * to compare against the scalar path. Requests for an
+         * unsupported instruction set fall back to the widest
+         * supported one.
+         *
+         * @param instruction_set The requested instruction set.
+         * @return The instruction set which is now active.
+        */
+        InstructionSet set_instruction_set(InstructionSet instruction_set);
+
+        /**
+         * Stringify an instruction set.
+         *
+         * @param instruction_set The instruction set.
+         * @return Its name.
+        */
+        const char* to_string(InstructionSet instruction_set);
+
+        /**
+         * Compute the scalar product of two arrays.
+         *
+         * @param a The first array.
+         * @param b The second array.
+         * @param size The number of elements in each array.
+         * @return sum(a_i * b_i).
+        */
+        double dot(const double* a, const double* b, size_t size);
+
+        /**
+         * Multiply every element of an array by lambda, in place.
+         *
+         * @param a The array.
+         * @param lambda The scale factor.
+         * @param size The number of elements.
+        */
+        void scale(double* a, double lambda, size_t size);
+
+        /**
+         * Add the second array onto the first one, in place.
+         *
+         * @param a The array which is modified.
+         * @param b The array which is added.
+         * @param size The number of elements in each array.
+        */
+        void add(double* a, const double* b, size_t size);
+
+        /**
+         * Subtract the second array from the first one, in place.
+         *
+         * @param a The array which is modified.
+         * @param b The array which is subtracted.
+         * @param size The number of elements in each array.
+        */
+        void subtract(double* a, const double* b, size_t size);
+
+        /**
+         * Compute y = alpha * x + beta * y, in place, in one pass.
+         *
+         * @param y The array which is modified.
+         * @param alpha The factor of x.
+         * @param x The array which is added.
+         * @param beta The factor of y.
+         * @param size The number of elements in each array.
+        */
+        void axpby(double* y, double alpha, const double* x, double beta, size_t size);
+
+        /**
+         * Compute the scalar product of two arrays together
+         * with the sums of squares of both, in one pass.
+         *
+         * @param a The first array.
+         * @param b The second array.
+         * @param size The number of elements in each array.
+         * @param results Receives sum(a_i * b_i), sum(a_i^2)
+         * and sum(b_i^2), in this order.
+        */
+        void dot_norms(const double* a, const double* b, size_t size, double* results);
+
+        /**
+         * Compute the scalar products of one array with several
+         * others, reading the first array once per block of them.
+         *
+         * @param a The array shared by all the products.
+         * @param others The count other arrays.
+         * @param count The number of other arrays.
+         * @param size The number of elements in each array.
+         * @param results Receives the count scalar products.
+        */
+        void multi_dot(const double* a, const double* const* others, size_t count, size_t size, double* results);
+    }
+}
+
+#endif
@@ -0,0 +1,251 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#ifndef __THMATH_SIMD_MATH_
+#define __THMATH_SIMD_MATH_
+
+#include "simd.h"
+
+#ifdef THMATH_SIMD_X86
+#include <immintrin.h>
+
+namespace thmath
+{
+    namespace simd
+    {
+        /**
+         * AVX2/FMA elementary functions over four lanes, shared by
+         * the vectorized complex kernels. They are inline, and only
+         * meant to be called from functions compiled for avx2,fma
+         * after checking simd::get_instruction_set(). The rational
+         * and polynomial approximations are the ones of Cephes; the
+         * callers keep non-finite (and out of range) lanes away from
+         * them, as noted for every function.
+        */
+        namespace avx2
+        {
+            inline __attribute__((target("avx2,fma")))
+            __m256d polynomial(__m256d x, const double* coefficients, int degree)
+            {
+                __m256d result = _mm256_set1_pd(coefficients[0]);
+                for (int index = 1; index <= degree; index++)
+                {
+                    result = _mm256_fmadd_pd(result, x, _mm256_set1_pd(coefficients[index]));
+                }
+                return result;
+            }
+
+            /**
+             * atan2 of four lanes. The ratio min(|x|, |y|) / max(|x|, |y|)
+             * in [0, 1] is reduced to |t| <= 0.66 (around pi/4 when needed),
+             * where atan is the rational approximation of Cephes' atan.c,
+             * and the octant is then restored from the signs and the swap.
+             * Lanes holding infinities or NaNs are left to std::atan2.
+            */
+            inline __attribute__((target("avx2,fma")))
+            __m256d atan2(__m256d y, __m256d x)
+            {
+                const __m256d sign_mask = _mm256_set1_pd(-0.0);
+                const __m256d pi = _mm256_set1_pd(3.141592653589793238);
+                const __m256d half_pi = _mm256_set1_pd(1.570796326794896619);
+                const __m256d quarter_pi = _mm256_set1_pd(0.7853981633974483096);
+                const __m256d one = _mm256_set1_pd(1.0);
+
+                __m256d ax = _mm256_andnot_pd(sign_mask, x);
+                __m256d ay = _mm256_andnot_pd(sign_mask, y);
+                __m256d swap = _mm256_cmp_pd(ay, ax, _CMP_GT_OQ);
+                __m256d numerator = _mm256_min_pd(ax, ay);
+                __m256d denominator = _mm256_max_pd(ax, ay);
+                __m256d zero = _mm256_cmp_pd(denominator, _mm256_setzero_pd(), _CMP_EQ_OQ);
+                __m256d t = _mm256_div_pd(numerator, _mm256_blendv_pd(denominator, one, zero));
+
+                __m256d reduce = _mm256_cmp_pd(t, _mm256_set1_pd(0.66), _CMP_GT_OQ);
+                __m256d base = _mm256_and_pd(reduce, quarter_pi);
+                t = _mm256_blendv_pd(t, _mm256_div_pd(_mm256_sub_pd(t, one), _mm256_add_pd(t, one)), reduce);
+
+                __m256d z = _mm256_mul_pd(t, t);
+                __m256d p = _mm256_set1_pd(-8.750608600031904122785e-1);
+                p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-1.615753718733365076637e1));
+                p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-7.500855792314704667340e1));
+                p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-1.228866684490136173410e2));
+                p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(-6.485021904942025371773e1));
+                __m256d q = _mm256_add_pd(z, _mm256_set1_pd(2.485846490142306297962e1));
+                q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(1.650270098316988542046e2));
+                q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(4.328810604912902668951e2));
+                q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(4.853903996359136964868e2));
+                q = _mm256_fmadd_pd(q, z, _mm256_set1_pd(1.945506571482613964425e2));
+                __m256d angle = _mm256_fmadd_pd(_mm256_mul_pd(t, z), _mm256_div_pd(p, q), t);
+                angle = _mm256_add_pd(base, angle);
+
+                angle = _mm256_blendv_pd(angle, _mm256_sub_pd(half_pi, angle), swap);
+                // x < 0 (including -0): reflect into the left half-plane.
+                angle = _mm256_blendv_pd(angle, _mm256_sub_pd(pi, angle), x);
+                return _mm256_or_pd(angle, _mm256_and_pd(sign_mask, y));
+            }
+
+            /**
+             * e^x of four lanes, for |x| <= 708 (within 1 ULP there).
+             * x = n ln2 + r with |r| <= ln2 / 2, e^r from Cephes' Pade
+             * form 1 + 2 r P(r^2) / (Q(r^2) - r P(r^2)), then 2^n is
+             * put directly into the exponent bits.
+            */
+            inline __attribute__((target("avx2,fma")))
+            __m256d exp(__m256d x)
+            {
+                static const double P[] = {
+                    1.26177193074810590878e-4, 3.02994407707441961300e-2, 9.99999999999999999910e-1
+                };
+                static const double Q[] = {
+                    3.00198505138664455042e-6, 2.52448340349684104192e-3, 2.27265548208155028766e-1,
+                    2.00000000000000000009e0
+                };
+                __m256d n = _mm256_round_pd(
+                    _mm256_mul_pd(x, _mm256_set1_pd(1.4426950408889634073599)),
+                    _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC
+                );
+                __m256d r = _mm256_fnmadd_pd(n, _mm256_set1_pd(6.93145751953125e-1), x);
+                r = _mm256_fnmadd_pd(n, _mm256_set1_pd(1.42860682030941723212e-6), r);
+                __m256d rr = _mm256_mul_pd(r, r);
+                __m256d px = _mm256_mul_pd(r, polynomial(rr, P, 2));
+                __m256d qx = polynomial(rr, Q, 3);
+                __m256d e = _mm256_fmadd_pd(
+                    _mm256_set1_pd(2.0), _mm256_div_pd(px, _mm256_sub_pd(qx, px)), _mm256_set1_pd(1.0)
+                );
+                // n + 1.5 * 2^52 holds n in its low mantissa bits; the
+                // shift by 52 drops the (zero) low bits of the magic.
+                __m256i bits = _mm256_castpd_si256(_mm256_add_pd(n, _mm256_set1_pd(6755399441055744.0)));
+                bits = _mm256_slli_epi64(_mm256_add_epi64(bits, _mm256_set1_epi64x(1023)), 52);
+                return _mm256_mul_pd(e, _mm256_castsi256_pd(bits));
+            }
+
+            /**
+             * log(1 + t) + e ln2 of four lanes, for t in [sqrt(2)/2 - 1,
+             * sqrt(2) - 1], from Cephes' t - t^2 / 2 + t^3 P(t) / Q(t),
+             * with ln2 added in two parts.
+            */
+            inline __attribute__((target("avx2,fma")))
+            __m256d log1p_reduced(__m256d t, __m256d e)
+            {
+                static const double P[] = {
+                    1.01875663804580931796e-4, 4.97494994976747001425e-1, 4.70579119878881725854e0,
+                    1.44989225341610930846e1, 1.79368678507819816313e1, 7.70838733755885391666e0
+                };
+                static const double Q[] = {
+                    1.0, 1.12873587189167450590e1, 4.52279145837532221105e1, 8.29875266912776603211e1,
+                    7.11544750618563894466e1, 2.31251620126765340583e1
+                };
+                __m256d z = _mm256_mul_pd(t, t);
+                __m256d y = _mm256_mul_pd(
+                    _mm256_mul_pd(t, z), _mm256_div_pd(polynomial(t, P, 5), polynomial(t, Q, 5))
+                );
+                y = _mm256_fmadd_pd(e, _mm256_set1_pd(-2.121944400546905827679e-4), y);
+                y = _mm256_fnmadd_pd(_mm256_set1_pd(0.5), z, y);
+                __m256d result = _mm256_add_pd(t, y);
+                return _mm256_fmadd_pd(e, _mm256_set1_pd(0.693359375), result);
+            }
+
+            /**
+             * Natural logarithm of four lanes, for positive normal
+             * numbers (within 1 ULP). x = m 2^e with m in [sqrt(2)/2,
+             * sqrt(2)), and log(x) = log1p(m - 1) + e ln2.
+            */
+            inline __attribute__((target("avx2,fma")))
+            __m256d log(__m256d x)
+            {
+                const __m256d one = _mm256_set1_pd(1.0);
+                __m256i bits = _mm256_castpd_si256(x);
+                __m256d m = _mm256_castsi256_pd(_mm256_or_si256(
+                    _mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFll)),
+                    _mm256_set1_epi64x(0x3FE0000000000000ll)
+                ));
+                // The biased exponent, read back as 2^52 + k - 2^52.
+                __m256d e = _mm256_sub_pd(
+                    _mm256_castsi256_pd(_mm256_or_si256(
+                        _mm256_srli_epi64(bits, 52), _mm256_set1_epi64x(0x4330000000000000ll)
+                    )),
+                    _mm256_set1_pd(4503599627370496.0 + 1022.0)
+                );
+                __m256d small = _mm256_cmp_pd(m, _mm256_set1_pd(0.70710678118654752440), _CMP_LT_OQ);
+                e = _mm256_sub_pd(e, _mm256_and_pd(small, one));
+                __m256d t = _mm256_sub_pd(_mm256_add_pd(m, _mm256_and_pd(small, m)), one);
+                return log1p_reduced(t, e);
+            }
+
+            /**
+             * Sine and cosine of four lanes, for |x| < 2^30 (within
+             * 1 ULP away from the zeros). x is reduced modulo pi / 4
+             * with pi split in three parts, and the octant selects
+             * between Cephes' sine and cosine polynomials.
+            */
+            inline __attribute__((target("avx2,fma")))
+            void sincos(__m256d x, __m256d& sine, __m256d& cosine)
+            {
+                static const double SINE[] = {
+                    1.58962301576546568060e-10, -2.50507477628578072866e-8, 2.75573136213857245213e-6,
+                    -1.98412698295895385996e-4, 8.33333333332211858878e-3, -1.66666666666666307295e-1
+                };
+                static const double COSINE[] = {
+                    -1.13585365213876817300e-11, 2.08757008419747316778e-9, -2.75573141792967388112e-7,
+                    2.48015872888517045348e-5, -1.38888888888730564116e-3, 4.16666666666665929218e-2
+                };
+                const __m256d sign_mask = _mm256_set1_pd(-0.0);
+                const __m256d one = _mm256_set1_pd(1.0);
+                __m256d sign = _mm256_and_pd(sign_mask, x);
+                __m256d ax = _mm256_andnot_pd(sign_mask, x);
+
+                // Octant j (made even) and its value modulo 8.
+                __m256d y = _mm256_floor_pd(_mm256_mul_pd(ax, _mm256_set1_pd(1.27323954473516268615)));
+                __m256d odd = _mm256_sub_pd(y, _mm256_mul_pd(_mm256_set1_pd(2.0), _mm256_floor_pd(_mm256_mul_pd(y, _mm256_set1_pd(0.5)))));
+                y = _mm256_add_pd(y, odd);
+                __m256d j = _mm256_sub_pd(y, _mm256_mul_pd(_mm256_set1_pd(8.0), _mm256_floor_pd(_mm256_mul_pd(y, _mm256_set1_pd(0.125)))));
+
+                __m256d z = _mm256_fnmadd_pd(y, _mm256_set1_pd(7.85398125648498535156e-1), ax);
+                z = _mm256_fnmadd_pd(y, _mm256_set1_pd(3.77489470793079817668e-8), z);
+                z = _mm256_fnmadd_pd(y, _mm256_set1_pd(2.69515142907905952645e-15), z);
+                __m256d zz = _mm256_mul_pd(z, z);
+                __m256d s = _mm256_fmadd_pd(_mm256_mul_pd(z, zz), polynomial(zz, SINE, 5), z);
+                __m256d c = _mm256_fmadd_pd(
+                    _mm256_mul_pd(zz, zz), polynomial(zz, COSINE, 5), _mm256_fnmadd_pd(_mm256_set1_pd(0.5), zz, one)
+                );
+
+                __m256d octant_2 = _mm256_cmp_pd(j, _mm256_set1_pd(2.0), _CMP_EQ_OQ);
+                __m256d octant_4 = _mm256_cmp_pd(j, _mm256_set1_pd(4.0), _CMP_EQ_OQ);
+                __m256d octant_6 = _mm256_cmp_pd(j, _mm256_set1_pd(6.0), _CMP_EQ_OQ);
+                __m256d swap = _mm256_or_pd(octant_2, octant_6);
+                __m256d negate_sine = _mm256_or_pd(octant_4, octant_6);
+                __m256d negate_cosine = _mm256_or_pd(octant_2, octant_4);
+                sine = _mm256_blendv_pd(s, c, swap);
+                cosine = _mm256_blendv_pd(c, s, swap);
+                sine = _mm256_xor_pd(_mm256_xor_pd(sine, _mm256_and_pd(negate_sine, sign_mask)), sign);
+                cosine = _mm256_xor_pd(cosine, _mm256_and_pd(negate_cosine, sign_mask));
+            }
+        }
+    }
+}
+
+#endif
+
+#endif
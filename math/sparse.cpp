@@ -0,0 +1,523 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "sparse.h"
+#include "norm.h"
+#include "thread_pool.h"
+#include "../exception/illegal_access_exception.h"
+#include "../exception/different_size_exception.h"
+#include "../exception/illegal_size_exception.h"
+#include "../exception/messages.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
+
+namespace
+{
+    // The parallel product hands every task at least this many
+    // non-zeros, so that each one amortizes its scheduling.
+    const size_t MIN_CHUNK_NON_ZEROS = 1 << 14;
+}
+
+thmath::SparseVector::SparseVector(size_t size) : size(size)
+{
+
+}
+
+thmath::SparseVector::SparseVector(size_t size, const std::vector<size_t>& indices, const std::vector<double>& values)
+    : size(size)
+{
+    if (indices.size() != values.size())
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    std::vector<size_t> order(indices.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&indices](size_t a, size_t b) {
+        return indices[a] < indices[b];
+    });
+    this->indices.reserve(indices.size());
+    this->values.reserve(values.size());
+    for (size_t position : order)
+    {
+        if (indices[position] >= size)
+        {
+            throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+        }
+        if (!this->indices.empty() && this->indices.back() == indices[position])
+        {
+            this->values.back() += values[position];
+        }
+        else
+        {
+            this->indices.push_back(indices[position]);
+            this->values.push_back(values[position]);
+        }
+    }
+}
+
+thmath::SparseVector::SparseVector(const Vector& vec) : size(vec.get_size())
+{
+    const double* entries = vec.get_entries();
+    for (size_t index = 0; index < this->size; index++)
+    {
+        if (entries[index] != 0.0)
+        {
+            this->indices.push_back(index);
+            this->values.push_back(entries[index]);
+        }
+    }
+}
+
+size_t thmath::SparseVector::get_size() const
+{
+    return this->size;
+}
+
+size_t thmath::SparseVector::get_non_zeros() const
+{
+    return this->indices.size();
+}
+
+const std::vector<size_t>& thmath::SparseVector::get_indices() const
+{
+    return this->indices;
+}
+
+const std::vector<double>& thmath::SparseVector::get_values() const
+{
+    return this->values;
+}
+
+double thmath::SparseVector::get_component(size_t index) const
+{
+    if (index >= this->size)
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    auto position = std::lower_bound(this->indices.begin(), this->indices.end(), index);
+    if (position == this->indices.end() || *position != index)
+    {
+        return 0.0;
+    }
+    return this->values[position - this->indices.begin()];
+}
+
+void thmath::SparseVector::set_component(size_t index, double value)
+{
+    if (index >= this->size)
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    auto position = std::lower_bound(this->indices.begin(), this->indices.end(), index);
+    size_t offset = position - this->indices.begin();
+    if (position != this->indices.end() && *position == index)
+    {
+        this->values[offset] = value;
+        return;
+    }
+    this->indices.insert(position, index);
+    this->values.insert(this->values.begin() + offset, value);
+}
+
+double thmath::SparseVector::dot_product(const SparseVector& vec) const
+{
+    if (this->size != vec.size)
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    double sum = 0.0;
+    size_t a = 0;
+    size_t b = 0;
+    while (a < this->indices.size() && b < vec.indices.size())
+    {
+        if (this->indices[a] < vec.indices[b])
+        {
+            a++;
+        }
+        else if (vec.indices[b] < this->indices[a])
+        {
+            b++;
+        }
+        else
+        {
+            sum += this->values[a++] * vec.values[b++];
+        }
+    }
+    return sum;
+}
+
+double thmath::SparseVector::dot_product(const Vector& vec) const
+{
+    if (this->size != vec.get_size())
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    const double* entries = vec.get_entries();
+    double sum = 0.0;
+    for (size_t position = 0; position < this->indices.size(); position++)
+    {
+        sum += this->values[position] * entries[this->indices[position]];
+    }
+    return sum;
+}
+
+void thmath::SparseVector::axpy(double alpha, Vector& vec) const
+{
+    if (this->size != vec.get_size())
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    double* entries = vec.mutable_entries();
+    for (size_t position = 0; position < this->indices.size(); position++)
+    {
+        entries[this->indices[position]] += alpha * this->values[position];
+    }
+}
+
+double thmath::SparseVector::norm() const
+{
+    return norms::l2(this->values.data(), this->values.size());
+}
+
+thmath::Vector thmath::SparseVector::to_vector() const
+{
+    std::vector<double> result(this->size, 0.0);
+    for (size_t position = 0; position < this->indices.size(); position++)
+    {
+        result[this->indices[position]] = this->values[position];
+    }
+    return Vector(this->size, result.data());
+}
+
+std::string thmath::SparseVector::to_string() const
+{
+    std::string s = "SparseVector={size=" + std::to_string(this->size) + ", elements=[";
+    for (size_t position = 0; position < this->indices.size(); position++)
+    {
+        if (position > 0)
+        {
+            s += ", ";
+        }
+        s += std::to_string(this->indices[position]) + ": " + std::to_string(this->values[position]);
+    }
+    return s + "]}";
+}
+
+thmath::CooMatrix::CooMatrix(size_t rows, size_t cols) : rows(rows), cols(cols)
+{
+
+}
+
+size_t thmath::CooMatrix::get_rows() const
+{
+    return this->rows;
+}
+
+size_t thmath::CooMatrix::get_cols() const
+{
+    return this->cols;
+}
+
+size_t thmath::CooMatrix::get_non_zeros() const
+{
+    return this->triplets.size();
+}
+
+const std::vector<thmath::Triplet>& thmath::CooMatrix::get_triplets() const
+{
+    return this->triplets;
+}
+
+void thmath::CooMatrix::add(size_t row, size_t col, double value)
+{
+    if (row >= this->rows || col >= this->cols)
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    this->triplets.push_back(Triplet{row, col, value});
+}
+
+void thmath::CooMatrix::reserve(size_t count)
+{
+    this->triplets.reserve(count);
+}
+
+thmath::CsrMatrix::CsrMatrix(size_t rows, size_t cols) : rows(rows), cols(cols), row_offsets(rows + 1, 0)
+{
+
+}
+
+thmath::CsrMatrix::CsrMatrix(size_t rows, size_t cols, const std::vector<Triplet>& triplets)
+    : rows(rows), cols(cols), row_offsets(rows + 1, 0)
+{
+    // Counting sort of the triplets by row...
+    for (const Triplet& triplet : triplets)
+    {
+        if (triplet.row >= rows || triplet.col >= cols)
+        {
+            throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+        }
+        this->row_offsets[triplet.row + 1]++;
+    }
+    std::partial_sum(this->row_offsets.begin(), this->row_offsets.end(), this->row_offsets.begin());
+    std::vector<size_t> next(this->row_offsets.begin(), this->row_offsets.end() - 1);
+    std::vector<size_t> col_indices(triplets.size());
+    std::vector<double> values(triplets.size());
+    for (const Triplet& triplet : triplets)
+    {
+        size_t position = next[triplet.row]++;
+        col_indices[position] = triplet.col;
+        values[position] = triplet.value;
+    }
+
+    // ...then sort every row by column, summing the duplicates.
+    this->col_indices.reserve(triplets.size());
+    this->values.reserve(triplets.size());
+    std::vector<size_t> order;
+    size_t begin = 0;
+    for (size_t row = 0; row < rows; row++)
+    {
+        size_t end = this->row_offsets[row + 1];
+        order.resize(end - begin);
+        std::iota(order.begin(), order.end(), begin);
+        std::sort(order.begin(), order.end(), [&col_indices](size_t a, size_t b) {
+            return col_indices[a] < col_indices[b];
+        });
+        size_t row_begin = this->col_indices.size();
+        for (size_t position : order)
+        {
+            if (this->col_indices.size() > row_begin && this->col_indices.back() == col_indices[position])
+            {
+                this->values.back() += values[position];
+            }
+            else
+            {
+                this->col_indices.push_back(col_indices[position]);
+                this->values.push_back(values[position]);
+            }
+        }
+        this->row_offsets[row] = row_begin;
+        begin = end;
+    }
+    this->row_offsets[rows] = this->col_indices.size();
+}
+
+thmath::CsrMatrix::CsrMatrix(const CooMatrix& matrix)
+    : CsrMatrix(matrix.get_rows(), matrix.get_cols(), matrix.get_triplets())
+{
+
+}
+
+thmath::CsrMatrix::CsrMatrix(const Matrix& matrix)
+    : rows(matrix.get_rows()), cols(matrix.get_cols()), row_offsets(matrix.get_rows() + 1, 0)
+{
+    for (size_t row = 0; row < this->rows; row++)
+    {
+        for (size_t col = 0; col < this->cols; col++)
+        {
+            if (matrix(row, col) != 0.0)
+            {
+                this->col_indices.push_back(col);
+                this->values.push_back(matrix(row, col));
+            }
+        }
+        this->row_offsets[row + 1] = this->col_indices.size();
+    }
+}
+
+size_t thmath::CsrMatrix::get_rows() const
+{
+    return this->rows;
+}
+
+size_t thmath::CsrMatrix::get_cols() const
+{
+    return this->cols;
+}
+
+size_t thmath::CsrMatrix::get_non_zeros() const
+{
+    return this->values.size();
+}
+
+const std::vector<size_t>& thmath::CsrMatrix::get_row_offsets() const
+{
+    return this->row_offsets;
+}
+
+const std::vector<size_t>& thmath::CsrMatrix::get_col_indices() const
+{
+    return this->col_indices;
+}
+
+const std::vector<double>& thmath::CsrMatrix::get_values() const
+{
+    return this->values;
+}
+
+double thmath::CsrMatrix::get_component(size_t row, size_t col) const
+{
+    if (row >= this->rows || col >= this->cols)
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    auto begin = this->col_indices.begin() + this->row_offsets[row];
+    auto end = this->col_indices.begin() + this->row_offsets[row + 1];
+    auto position = std::lower_bound(begin, end, col);
+    if (position == end || *position != col)
+    {
+        return 0.0;
+    }
+    return this->values[position - this->col_indices.begin()];
+}
+
+thmath::SparseVector thmath::CsrMatrix::row(size_t row) const
+{
+    if (row >= this->rows)
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    size_t begin = this->row_offsets[row];
+    size_t end = this->row_offsets[row + 1];
+    return SparseVector(
+        this->cols,
+        std::vector<size_t>(this->col_indices.begin() + begin, this->col_indices.begin() + end),
+        std::vector<double>(this->values.begin() + begin, this->values.begin() + end)
+    );
+}
+
+thmath::Vector thmath::CsrMatrix::operator*(const Vector& vec) const
+{
+    Vector result(this->rows);
+    multiply(vec, result);
+    return result;
+}
+
+void thmath::CsrMatrix::multiply(const Vector& vec, Vector& result, execution::Policy policy) const
+{
+    if (vec.get_size() != this->cols || result.get_size() != this->rows)
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+    const size_t* offsets = this->row_offsets.data();
+    const size_t* indices = this->col_indices.data();
+    const double* values = this->values.data();
+    const double* x = vec.get_entries();
+    double* y = result.mutable_entries();
+    auto rows = [offsets, indices, values, x, y](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; row++)
+        {
+            double sum = 0.0;
+            for (size_t position = offsets[row]; position < offsets[row + 1]; position++)
+            {
+                sum += values[position] * x[indices[position]];
+            }
+            y[row] = sum;
+        }
+    };
+    const size_t non_zeros = this->values.size();
+    if (execution::is_parallel(policy, non_zeros))
+    {
+        // Split by non-zeros rather than by rows: the work is in the
+        // non-zeros, and rows may hold very different numbers of them.
+        ThreadPool& pool = ThreadPool::get_instance();
+        size_t chunks = 4 * pool.get_thread_count();
+        size_t per_chunk = std::max((non_zeros + chunks - 1) / chunks, MIN_CHUNK_NON_ZEROS);
+        chunks = (non_zeros + per_chunk - 1) / per_chunk;
+        std::vector<size_t> bounds(chunks + 1, this->rows);
+        bounds[0] = 0;
+        for (size_t chunk = 1; chunk < chunks; chunk++)
+        {
+            bounds[chunk] = std::lower_bound(offsets, offsets + this->rows, chunk * per_chunk) - offsets;
+        }
+        pool.parallel_for(0, chunks, 1, [&bounds, &rows](size_t begin, size_t end) {
+            for (size_t chunk = begin; chunk < end; chunk++)
+            {
+                rows(bounds[chunk], bounds[chunk + 1]);
+            }
+        });
+    }
+    else
+    {
+        rows(0, this->rows);
+    }
+}
+
+thmath::CsrMatrix thmath::CsrMatrix::transpose() const
+{
+    CsrMatrix result(this->cols, this->rows);
+    result.col_indices.resize(this->values.size());
+    result.values.resize(this->values.size());
+    for (size_t col : this->col_indices)
+    {
+        result.row_offsets[col + 1]++;
+    }
+    std::partial_sum(result.row_offsets.begin(), result.row_offsets.end(), result.row_offsets.begin());
+    // Walking the rows in order keeps the columns of the result sorted.
+    std::vector<size_t> next(result.row_offsets.begin(), result.row_offsets.end() - 1);
+    for (size_t row = 0; row < this->rows; row++)
+    {
+        for (size_t position = this->row_offsets[row]; position < this->row_offsets[row + 1]; position++)
+        {
+            size_t target = next[this->col_indices[position]]++;
+            result.col_indices[target] = row;
+            result.values[target] = this->values[position];
+        }
+    }
+    return result;
+}
+
+thmath::Matrix thmath::CsrMatrix::to_matrix() const
+{
+    Matrix result(this->rows, this->cols);
+    for (size_t row = 0; row < this->rows; row++)
+    {
+        for (size_t position = this->row_offsets[row]; position < this->row_offsets[row + 1]; position++)
+        {
+            result(row, this->col_indices[position]) = this->values[position];
+        }
+    }
+    return result;
+}
+
+std::string thmath::CsrMatrix::to_string() const
+{
+    std::string s = "CsrMatrix={rows=" + std::to_string(this->rows) + ", cols=" + std::to_string(this->cols)
+        + ", non_zeros=" + std::to_string(this->values.size()) + ", elements=[";
+    for (size_t row = 0; row < this->rows; row++)
+    {
+        for (size_t position = this->row_offsets[row]; position < this->row_offsets[row + 1]; position++)
+        {
+            if (position > 0)
+            {
+                s += ", ";
+            }
+            s += "(" + std::to_string(row) + ", " + std::to_string(this->col_indices[position]) + "): "
+                + std::to_string(this->values[position]);
+        }
+    }
+    return s + "]}";
+}
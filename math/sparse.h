@@ -0,0 +1,363 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#ifndef __THMATH_SPARSE_
+#define __THMATH_SPARSE_
+
+#include "vector.h"
+#include "matrix.h"
+#include "execution.h"
+#include <string>
+#include <vector>
+
+namespace thmath
+{
+    /**
+     * Sparse vector, storing only its non-zero components as
+     * (index, value) pairs sorted by index. Memory is linear in
+     * the number of non-zeros instead of in the size.
+    */
+    class SparseVector
+    {
+    private:
+        size_t size;
+        std::vector<size_t> indices;
+        std::vector<double> values;
+
+    public:
+        /**
+         * Default constructor for the SparseVector class,
+         * creating the null vector of the given size.
+         *
+         * @param size The size of the vector.
+         * @return A new sparse vector object.
+        */
+        explicit SparseVector(const size_t size);
+
+        /**
+         * Constructor for the SparseVector class, taking the
+         * non-zero components as (index, value) pairs in any
+         * order. Values given for the same index are summed.
+         *
+         * @param size The size of the vector.
+         * @param indices The indices of the components.
+         * @param values The values of the components.
+         * @return A new sparse vector object.
+        */
+        SparseVector(const size_t size, const std::vector<size_t>& indices, const std::vector<double>& values);
+
+        /**
+         * Constructor for the SparseVector class, keeping
+         * the non-zero components of a dense vector.
+         *
+         * @param vec The dense vector.
+         * @return A new sparse vector object.
+        */
+        explicit SparseVector(const Vector& vec);
+
+        /**
+         * Return the size of the vector.
+         *
+         * @return The size of the vector.
+        */
+        size_t get_size() const;
+
+        /**
+         * Return the number of stored (non-zero) components.
+         *
+         * @return The number of non-zeros.
+        */
+        size_t get_non_zeros() const;
+
+        const std::vector<size_t>& get_indices() const;
+        const std::vector<double>& get_values() const;
+
+        /**
+         * Obtain the component at the given index, which
+         * is looked up by binary search.
+         *
+         * @param index The index of the component.
+         * @return The component (0 if it is not stored).
+        */
+        double get_component(const size_t index) const;
+
+        /**
+         * Overwrite the component at the given index,
+         * inserting it if it is not stored yet.
+         *
+         * @param index The index of the component.
+         * @param value The new value of the component.
+        */
+        void set_component(const size_t index, double value);
+
+        /**
+         * Scalar product with another sparse vector, merging
+         * the two index lists in a single pass.
+         *
+         * @param vec The other sparse vector.
+         * @return The scalar product.
+        */
+        double dot_product(const SparseVector& vec) const;
+
+        /**
+         * Scalar product with a dense vector, gathering
+         * only the components stored in this vector.
+         *
+         * @param vec The dense vector.
+         * @return The scalar product.
+        */
+        double dot_product(const Vector& vec) const;
+
+        /**
+         * Sparse-dense axpy: vec += alpha * this, touching
+         * only the stored components.
+         *
+         * @param alpha The scale factor.
+         * @param vec The dense vector which is updated.
+        */
+        void axpy(double alpha, Vector& vec) const;
+
+        /**
+         * Return the Euclidian (L2) norm of the vector.
+         *
+         * @return The L2 norm.
+        */
+        double norm() const;
+
+        /**
+         * Expand the vector into dense storage.
+         *
+         * @return A new dense vector.
+        */
+        Vector to_vector() const;
+
+        /**
+         * Stringify the sparse vector, for debugging purposes.
+         *
+         * @return The stringified version of the vector.
+        */
+        std::string to_string() const;
+    };
+
+    /**
+     * A (row, col, value) entry of a sparse matrix.
+    */
+    struct Triplet
+    {
+        size_t row;
+        size_t col;
+        double value;
+    };
+
+    /**
+     * Sparse matrix in coordinate (COO) format, i.e. an unordered
+     * list of triplets. Cheap to build incrementally; convert it
+     * to a CsrMatrix for arithmetic.
+    */
+    class CooMatrix
+    {
+    private:
+        size_t rows;
+        size_t cols;
+        std::vector<Triplet> triplets;
+
+    public:
+        /**
+         * Default constructor for the CooMatrix class,
+         * creating an empty matrix of the given dimensions.
+         *
+         * @param rows The number of rows.
+         * @param cols The number of columns.
+         * @return A new sparse matrix object.
+        */
+        CooMatrix(const size_t rows, const size_t cols);
+
+        size_t get_rows() const;
+        size_t get_cols() const;
+
+        /**
+         * Return the number of stored triplets, duplicates
+         * included.
+         *
+         * @return The number of triplets.
+        */
+        size_t get_non_zeros() const;
+
+        const std::vector<Triplet>& get_triplets() const;
+
+        /**
+         * Append an entry; entries added more than once
+         * for the same position are summed.
+         *
+         * @param row The row of the entry.
+         * @param col The column of the entry.
+         * @param value The value of the entry.
+        */
+        void add(const size_t row, const size_t col, double value);
+
+        /**
+         * Reserve room for the given number of triplets.
+         *
+         * @param count The expected number of triplets.
+        */
+        void reserve(const size_t count);
+    };
+
+    /**
+     * Sparse matrix in compressed sparse row (CSR) format: the
+     * column indices and values of row i are found at positions
+     * [row_offsets[i], row_offsets[i + 1]) of col_indices and
+     * values, sorted by column.
+    */
+    class CsrMatrix
+    {
+    private:
+        size_t rows;
+        size_t cols;
+        std::vector<size_t> row_offsets;
+        std::vector<size_t> col_indices;
+        std::vector<double> values;
+
+    public:
+        /**
+         * Default constructor for the CsrMatrix class,
+         * creating the null matrix of the given dimensions.
+         *
+         * @param rows The number of rows.
+         * @param cols The number of columns.
+         * @return A new sparse matrix object.
+        */
+        CsrMatrix(const size_t rows, const size_t cols);
+
+        /**
+         * Constructor for the CsrMatrix class, building the
+         * matrix from triplets in any order. Triplets for the
+         * same position are summed.
+         *
+         * @param rows The number of rows.
+         * @param cols The number of columns.
+         * @param triplets The entries of the matrix.
+         * @return A new sparse matrix object.
+        */
+        CsrMatrix(const size_t rows, const size_t cols, const std::vector<Triplet>& triplets);
+
+        /**
+         * Constructor for the CsrMatrix class, compressing
+         * a matrix in coordinate format.
+         *
+         * @param matrix The matrix in coordinate format.
+         * @return A new sparse matrix object.
+        */
+        explicit CsrMatrix(const CooMatrix& matrix);
+
+        /**
+         * Constructor for the CsrMatrix class, keeping
+         * the non-zero components of a dense matrix.
+         *
+         * @param matrix The dense matrix.
+         * @return A new sparse matrix object.
+        */
+        explicit CsrMatrix(const Matrix& matrix);
+
+        size_t get_rows() const;
+        size_t get_cols() const;
+
+        /**
+         * Return the number of stored (non-zero) components.
+         *
+         * @return The number of non-zeros.
+        */
+        size_t get_non_zeros() const;
+
+        const std::vector<size_t>& get_row_offsets() const;
+        const std::vector<size_t>& get_col_indices() const;
+        const std::vector<double>& get_values() const;
+
+        /**
+         * Obtain the component (row, col), which is looked
+         * up by binary search within the row.
+         *
+         * @param row The row of the component.
+         * @param col The column of the component.
+         * @return The component (0 if it is not stored).
+        */
+        double get_component(const size_t row, const size_t col) const;
+
+        /**
+         * Extract the given row as a sparse vector.
+         *
+         * @param row The index of the row.
+         * @return The row.
+        */
+        SparseVector row(const size_t row) const;
+
+        /**
+         * Sparse matrix-vector product (SpMV).
+         *
+         * @param vec A vector with get_cols() components.
+         * @return A new vector with get_rows() components.
+        */
+        Vector operator*(const Vector& vec) const;
+
+        /**
+         * Sparse matrix-vector product, written into an existing
+         * vector. Under a parallel policy, the rows are split
+         * across the library thread pool into ranges holding about
+         * the same number of non-zeros; every row is written by a
+         * single thread, so no synchronization is needed.
+         *
+         * @param vec A vector with get_cols() components.
+         * @param result A vector with get_rows() components,
+         * which must not alias vec.
+         * @param policy The execution policy; the parallel
+         * threshold applies to the number of non-zeros.
+        */
+        void multiply(const Vector& vec, Vector& result, execution::Policy policy = execution::par) const;
+
+        /**
+         * Return the transpose of this matrix.
+         *
+         * @return A new, transposed, matrix.
+        */
+        CsrMatrix transpose() const;
+
+        /**
+         * Expand the matrix into dense storage.
+         *
+         * @return A new dense matrix.
+        */
+        Matrix to_matrix() const;
+
+        /**
+         * Stringify the sparse matrix, for debugging purposes.
+         *
+         * @return The stringified version of the matrix.
+        */
+        std::string to_string() const;
+    };
+}
+
+#endif
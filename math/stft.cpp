@@ -0,0 +1,318 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "stft.h"
+#include "../exception/illegal_size_exception.h"
+#include "../exception/messages.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+
+#ifdef THMATH_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    using thmath::simd::InstructionSet;
+
+    constexpr double PI = 3.14159265358979323846;
+
+    bool use_avx2()
+    {
+#ifdef THMATH_SIMD_X86
+        InstructionSet instruction_set = thmath::simd::get_instruction_set();
+        return instruction_set == InstructionSet::AVX2 || instruction_set == InstructionSet::AVX512;
+#else
+        return false;
+#endif
+    }
+
+    // X[k] = (X[k] + delta) * (cosine[k] + i sine[k]), for k < size.
+    void slide_scalar(
+        double* re, double* im, const double* cosine, const double* sine,
+        double delta_real, double delta_imaginary, size_t size
+    )
+    {
+        for (size_t k = 0; k < size; k++)
+        {
+            double real = re[k] + delta_real;
+            double imaginary = im[k] + delta_imaginary;
+            re[k] = real * cosine[k] - imaginary * sine[k];
+            im[k] = real * sine[k] + imaginary * cosine[k];
+        }
+    }
+
+#ifdef THMATH_SIMD_X86
+    __attribute__((target("avx2,fma")))
+    void slide_avx2(
+        double* re, double* im, const double* cosine, const double* sine,
+        double delta_real, double delta_imaginary, size_t size
+    )
+    {
+        __m256d shift_real = _mm256_set1_pd(delta_real);
+        __m256d shift_imaginary = _mm256_set1_pd(delta_imaginary);
+        size_t k = 0;
+        for (; k + 4 <= size; k += 4)
+        {
+            __m256d real = _mm256_add_pd(_mm256_loadu_pd(re + k), shift_real);
+            __m256d imaginary = _mm256_add_pd(_mm256_loadu_pd(im + k), shift_imaginary);
+            __m256d c = _mm256_loadu_pd(cosine + k);
+            __m256d s = _mm256_loadu_pd(sine + k);
+            _mm256_storeu_pd(re + k, _mm256_fmsub_pd(real, c, _mm256_mul_pd(imaginary, s)));
+            _mm256_storeu_pd(im + k, _mm256_fmadd_pd(real, s, _mm256_mul_pd(imaginary, c)));
+        }
+        slide_scalar(re + k, im + k, cosine + k, sine + k, delta_real, delta_imaginary, size - k);
+    }
+#endif
+
+    thmath::Complex scaled(const thmath::Complex& value, double lambda)
+    {
+        return thmath::Complex(lambda * value.get_real(), lambda * value.get_imaginary());
+    }
+}
+
+thmath::Stft::Stft(size_t frame_size, size_t hop_size, StftWindow window, StftMethod method)
+    : frame_size(frame_size), hop_size(hop_size), method(method), head(0), filled(0), since_hop(0), since_sync(0), ready(false)
+{
+    if (frame_size == 0 || hop_size == 0)
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+    switch (window)
+    {
+        case StftWindow::RECTANGULAR:
+            this->coefficients[0] = 1.0, this->coefficients[1] = 0.0, this->coefficients[2] = 0.0;
+            break;
+        case StftWindow::HANN:
+            this->coefficients[0] = 0.5, this->coefficients[1] = 0.5, this->coefficients[2] = 0.0;
+            break;
+        case StftWindow::HAMMING:
+            this->coefficients[0] = 0.54, this->coefficients[1] = 0.46, this->coefficients[2] = 0.0;
+            break;
+        case StftWindow::BLACKMAN:
+            this->coefficients[0] = 0.42, this->coefficients[1] = 0.5, this->coefficients[2] = 0.08;
+            break;
+    }
+    if (method == StftMethod::AUTOMATIC)
+    {
+        // Measured with AVX2: one power of two transform costs about as
+        // much as 1.5 log2(N) sliding updates (and windows), a Bluestein
+        // transform about five times more.
+        double log_size = std::log2(static_cast<double>(frame_size));
+        double crossover = ((frame_size & (frame_size - 1)) == 0 ? 1.5 : 7.5) * log_size;
+        this->method = static_cast<double>(hop_size) <= crossover ? StftMethod::SLIDING : StftMethod::FFT;
+    }
+
+    this->window.resize(frame_size);
+    for (size_t j = 0; j < frame_size; j++)
+    {
+        double angle = 2.0 * PI * static_cast<double>(j) / static_cast<double>(frame_size);
+        this->window[j] = this->coefficients[0] - this->coefficients[1] * std::cos(angle)
+            + this->coefficients[2] * std::cos(2.0 * angle);
+    }
+    this->plan = FftPlan::get(frame_size);
+    this->ring.assign(frame_size, Complex());
+    this->frame.assign(frame_size, Complex());
+    this->spectrum.assign(frame_size, Complex());
+    if (this->method == StftMethod::SLIDING)
+    {
+        this->running_real.assign(frame_size, 0.0);
+        this->running_imaginary.assign(frame_size, 0.0);
+        this->twiddle_real.resize(frame_size);
+        this->twiddle_imaginary.resize(frame_size);
+        for (size_t k = 0; k < frame_size; k++)
+        {
+            double angle = 2.0 * PI * static_cast<double>(k) / static_cast<double>(frame_size);
+            this->twiddle_real[k] = std::cos(angle);
+            this->twiddle_imaginary[k] = std::sin(angle);
+        }
+    }
+    this->plan->reserve(this->workspace);
+}
+
+size_t thmath::Stft::get_frame_size() const
+{
+    return this->frame_size;
+}
+
+size_t thmath::Stft::get_hop_size() const
+{
+    return this->hop_size;
+}
+
+thmath::StftMethod thmath::Stft::get_method() const
+{
+    return this->method;
+}
+
+const std::vector<double>& thmath::Stft::get_window() const
+{
+    return this->window;
+}
+
+void thmath::Stft::synchronize()
+{
+    for (size_t j = 0; j < this->frame_size; j++)
+    {
+        this->frame[j] = this->ring[(this->head + j) % this->frame_size];
+    }
+    this->plan->forward(this->frame.data(), this->frame.data(), this->workspace);
+    for (size_t k = 0; k < this->frame_size; k++)
+    {
+        this->running_real[k] = this->frame[k].get_real();
+        this->running_imaginary[k] = this->frame[k].get_imaginary();
+    }
+    this->since_sync = 0;
+}
+
+void thmath::Stft::compute_spectrum()
+{
+    const size_t n = this->frame_size;
+    if (this->method == StftMethod::FFT)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            this->frame[j] = scaled(this->ring[(this->head + j) % n], this->window[j]);
+        }
+        this->plan->forward(this->frame.data(), this->spectrum.data(), this->workspace);
+        return;
+    }
+
+    // Multiplying by cos(2 pi j / N) averages the neighbouring bins, so
+    // the window is Y[k] = a0 X[k] - a1/2 (X[k-1] + X[k+1]) + a2/2 (X[k-2] + X[k+2]).
+    const double* re = this->running_real.data();
+    const double* im = this->running_imaginary.data();
+    double a0 = this->coefficients[0];
+    double a1 = -0.5 * this->coefficients[1];
+    double a2 = 0.5 * this->coefficients[2];
+    auto bin = [&](size_t k, size_t previous, size_t next, size_t before, size_t after) {
+        double real = a0 * re[k] + a1 * (re[previous] + re[next]) + a2 * (re[before] + re[after]);
+        double imaginary = a0 * im[k] + a1 * (im[previous] + im[next]) + a2 * (im[before] + im[after]);
+        this->spectrum[k] = Complex(real, imaginary);
+    };
+    for (size_t k = 0; k < n; k++)
+    {
+        if (k >= 2 && k + 2 < n)
+        {
+            // The interior bins need no wrap-around.
+            for (; k + 2 < n; k++)
+            {
+                bin(k, k - 1, k + 1, k - 2, k + 2);
+            }
+            k--;
+            continue;
+        }
+        bin(k, (k + n - 1) % n, (k + 1) % n, (k + 2 * n - 2) % n, (k + 2) % n);
+    }
+}
+
+bool thmath::Stft::push(const Complex& sample)
+{
+    const size_t n = this->frame_size;
+    Complex oldest = this->ring[this->head];
+    this->ring[this->head] = sample;
+    this->head = this->head + 1 == n ? 0 : this->head + 1;
+
+    if (this->method == StftMethod::SLIDING)
+    {
+        if (++this->since_sync == n)
+        {
+            synchronize();
+        }
+        else
+        {
+            // X'[k] = (X[k] - oldest + sample) e^(2 pi i k / N)
+            double delta_real = sample.get_real() - oldest.get_real();
+            double delta_imaginary = sample.get_imaginary() - oldest.get_imaginary();
+            double* re = this->running_real.data();
+            double* im = this->running_imaginary.data();
+            const double* cosine = this->twiddle_real.data();
+            const double* sine = this->twiddle_imaginary.data();
+#ifdef THMATH_SIMD_X86
+            if (use_avx2())
+            {
+                slide_avx2(re, im, cosine, sine, delta_real, delta_imaginary, n);
+            }
+            else
+            {
+                slide_scalar(re, im, cosine, sine, delta_real, delta_imaginary, n);
+            }
+#else
+            slide_scalar(re, im, cosine, sine, delta_real, delta_imaginary, n);
+#endif
+        }
+    }
+
+    this->ready = false;
+    if (this->filled < n)
+    {
+        if (++this->filled < n)
+        {
+            return false;
+        }
+    }
+    else if (++this->since_hop < this->hop_size)
+    {
+        return false;
+    }
+    this->since_hop = 0;
+    compute_spectrum();
+    this->ready = true;
+    return true;
+}
+
+size_t thmath::Stft::push(const Complex* samples, size_t count)
+{
+    for (size_t index = 0; index < count; index++)
+    {
+        if (push(samples[index]))
+        {
+            return index + 1;
+        }
+    }
+    return count;
+}
+
+bool thmath::Stft::is_ready() const
+{
+    return this->ready;
+}
+
+const thmath::Complex* thmath::Stft::get_spectrum() const
+{
+    return this->spectrum.data();
+}
+
+void thmath::Stft::reset()
+{
+    std::fill(this->ring.begin(), this->ring.end(), Complex());
+    std::fill(this->running_real.begin(), this->running_real.end(), 0.0);
+    std::fill(this->running_imaginary.begin(), this->running_imaginary.end(), 0.0);
+    this->head = 0;
+    this->filled = 0;
+    this->since_hop = 0;
+    this->since_sync = 0;
+    this->ready = false;
+}
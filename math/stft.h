@@ -0,0 +1,180 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#ifndef __THMATH_STFT_
+#define __THMATH_STFT_
+
+#include "complex.h"
+#include "fft.h"
+#include <memory>
+#include <vector>
+
+namespace thmath
+{
+    /**
+     * The (periodic) cosine-sum windows,
+     * w[j] = a0 - a1 cos(2 pi j / N) + a2 cos(4 pi j / N).
+    */
+    enum class StftWindow
+    {
+        RECTANGULAR,
+        HANN,
+        HAMMING,
+        BLACKMAN
+    };
+
+    enum class StftMethod
+    {
+        AUTOMATIC,
+        FFT,
+        SLIDING
+    };
+
+    /**
+     * Streaming short-time Fourier transform of complex samples.
+     * The samples are pushed one at a time (or in batches) into
+     * a ring buffer holding the last frame_size of them; once the
+     * buffer is full, and then every hop_size samples, the spectrum
+     * of the windowed frame (oldest sample first) is computed.
+     *
+     * The FFT method windows and transforms the whole frame at every
+     * hop, i.e. O(N log N) per hop. The sliding method updates the
+     * spectrum of the raw frame at every sample (O(N) per sample) and
+     * applies the window at every hop as a 3 or 5 tap convolution of
+     * the spectrum, which is exact for cosine-sum windows; it is the
+     * faster one for small hops. The sliding spectrum is recomputed
+     * from scratch every frame_size samples, so that the rounding
+     * errors of the recurrence cannot build up.
+     *
+     * Every buffer, the workspace of the transforms included, is
+     * owned by the object and sized in the constructor: pushing
+     * samples never allocates, from whichever thread it is done.
+    */
+    class Stft
+    {
+    private:
+        size_t frame_size;
+        size_t hop_size;
+        StftMethod method;
+        double coefficients[3];
+        std::shared_ptr<const FftPlan> plan;
+        FftWorkspace workspace;
+        std::vector<double> window;
+        std::vector<Complex> ring;
+        std::vector<Complex> frame;
+        // Sliding method: the spectrum of the raw frame and the
+        // twiddles e^(2 pi i k / N), split into real and imaginary
+        // parts so that the per-sample update vectorizes.
+        std::vector<double> running_real;
+        std::vector<double> running_imaginary;
+        std::vector<double> twiddle_real;
+        std::vector<double> twiddle_imaginary;
+        std::vector<Complex> spectrum;
+        size_t head;
+        size_t filled;
+        size_t since_hop;
+        size_t since_sync;
+        bool ready;
+
+        void compute_spectrum();
+        void synchronize();
+
+    public:
+        /**
+         * Constructor for the Stft class.
+         *
+         * @param frame_size The number of samples per frame (and of
+         * frequency bins per spectrum).
+         * @param hop_size The number of samples between two spectra.
+         * @param window The window applied to every frame.
+         * @param method The method, or AUTOMATIC to pick the faster one.
+         * @return A new STFT stage, with an empty buffer.
+        */
+        Stft(
+            const size_t frame_size,
+            const size_t hop_size,
+            StftWindow window = StftWindow::HANN,
+            StftMethod method = StftMethod::AUTOMATIC
+        );
+
+        size_t get_frame_size() const;
+        size_t get_hop_size() const;
+
+        /**
+         * Return the method in use (never AUTOMATIC).
+         *
+         * @return FFT or SLIDING.
+        */
+        StftMethod get_method() const;
+
+        /**
+         * Obtain the window, sampled over a frame.
+         *
+         * @return The frame_size window coefficients.
+        */
+        const std::vector<double>& get_window() const;
+
+        /**
+         * Push one sample.
+         *
+         * @param sample The next sample of the stream.
+         * @return Whether a new spectrum is ready.
+        */
+        bool push(const Complex& sample);
+
+        /**
+         * Push samples until the next spectrum is ready, or
+         * until all of them are consumed.
+         *
+         * @param samples The next samples of the stream.
+         * @param count The number of samples.
+         * @return The number of samples consumed; is_ready()
+         * tells whether it stopped on a new spectrum.
+        */
+        size_t push(const Complex* samples, size_t count);
+
+        /**
+         * Check whether the last sample pushed completed a spectrum.
+         *
+         * @return Whether get_spectrum() holds a new spectrum.
+        */
+        bool is_ready() const;
+
+        /**
+         * Obtain the last spectrum computed.
+         *
+         * @return The frame_size frequency bins, DC first.
+        */
+        const Complex* get_spectrum() const;
+
+        /**
+         * Forget every sample pushed so far.
+        */
+        void reset();
+    };
+}
+
+#endif
@@ -0,0 +1,208 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "thread_pool.h"
+#include <exception>
+
+namespace
+{
+    // The pool (and queue) of the worker running on this thread, if any.
+    thread_local const thmath::ThreadPool* worker_pool = nullptr;
+    thread_local size_t worker_index = 0;
+}
+
+thmath::ThreadPool::ThreadPool(size_t thread_count) : pending(0), next_queue(0), stopping(false)
+{
+    if (thread_count == 0)
+    {
+        thread_count = 1;
+    }
+    for (size_t index = 0; index < thread_count; index++)
+    {
+        this->queues.push_back(std::make_unique<TaskQueue>());
+    }
+    for (size_t index = 0; index < thread_count; index++)
+    {
+        this->workers.emplace_back(&ThreadPool::worker_loop, this, index);
+    }
+}
+
+thmath::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->sleep_mutex);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+    for (std::thread& worker : this->workers)
+    {
+        worker.join();
+    }
+}
+
+thmath::ThreadPool& thmath::ThreadPool::get_instance()
+{
+    static ThreadPool pool(std::thread::hardware_concurrency());
+    return pool;
+}
+
+size_t thmath::ThreadPool::get_thread_count() const
+{
+    return this->workers.size();
+}
+
+size_t thmath::ThreadPool::current_queue()
+{
+    if (worker_pool == this)
+    {
+        return worker_index;
+    }
+    return this->next_queue.fetch_add(1, std::memory_order_relaxed) % this->queues.size();
+}
+
+void thmath::ThreadPool::submit(std::function<void()> task)
+{
+    TaskQueue& queue = *this->queues[current_queue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    this->pending.fetch_add(1, std::memory_order_release);
+    {
+        // Taking the lock orders the increment with a worker about to sleep.
+        std::lock_guard<std::mutex> lock(this->sleep_mutex);
+    }
+    this->wake.notify_one();
+}
+
+bool thmath::ThreadPool::run_one(size_t home)
+{
+    std::function<void()> task;
+    {
+        TaskQueue& queue = *this->queues[home];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+    }
+    for (size_t offset = 1; !task && offset < this->queues.size(); offset++)
+    {
+        TaskQueue& victim = *this->queues[(home + offset) % this->queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+    }
+    if (!task)
+    {
+        return false;
+    }
+    this->pending.fetch_sub(1, std::memory_order_relaxed);
+    task();
+    return true;
+}
+
+void thmath::ThreadPool::worker_loop(size_t index)
+{
+    worker_pool = this;
+    worker_index = index;
+    while (true)
+    {
+        if (run_one(index))
+        {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(this->sleep_mutex);
+        this->wake.wait(lock, [this] {
+            return this->stopping || this->pending.load(std::memory_order_acquire) > 0;
+        });
+        if (this->stopping && this->pending.load(std::memory_order_acquire) == 0)
+        {
+            return;
+        }
+    }
+}
+
+void thmath::ThreadPool::parallel_for(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& body)
+{
+    if (end <= begin)
+    {
+        return;
+    }
+    if (grain == 0)
+    {
+        grain = 1;
+    }
+    size_t chunks = (end - begin + grain - 1) / grain;
+    if (chunks == 1)
+    {
+        body(begin, end);
+        return;
+    }
+
+    std::atomic<size_t> remaining(chunks);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto run_chunk = [&](size_t chunk) {
+        size_t chunk_begin = begin + chunk * grain;
+        size_t chunk_end = chunk_begin + grain < end ? chunk_begin + grain : end;
+        try
+        {
+            body(chunk_begin, chunk_end);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+        }
+        remaining.fetch_sub(1, std::memory_order_acq_rel);
+    };
+
+    for (size_t chunk = 1; chunk < chunks; chunk++)
+    {
+        submit([&run_chunk, chunk] {
+            run_chunk(chunk);
+        });
+    }
+    run_chunk(0);
+
+    size_t home = current_queue();
+    while (remaining.load(std::memory_order_acquire) > 0)
+    {
+        if (!run_one(home))
+        {
+            std::this_thread::yield();
+        }
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
@@ -0,0 +1,136 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __THMATH_THREAD_POOL_
+#define __THMATH_THREAD_POOL_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace thmath
+{
+    /**
+     * Work-stealing thread pool. Every worker owns a task queue:
+     * it runs its own tasks last-in first-out (which keeps the
+     * data it just touched in cache), and, once it runs dry,
+     * steals the oldest tasks of the other workers. A thread
+     * waiting in parallel_for does not block either; it keeps
+     * running (or stealing) tasks until its loop is done, so
+     * nested parallel loops cannot deadlock the pool.
+    */
+    class ThreadPool
+    {
+    private:
+        struct TaskQueue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<TaskQueue>> queues;
+        std::vector<std::thread> workers;
+        std::mutex sleep_mutex;
+        std::condition_variable wake;
+        std::atomic<size_t> pending;
+        std::atomic<size_t> next_queue;
+        bool stopping;
+
+        /**
+         * Run a single task, taken from the given queue
+         * or, failing that, stolen from another one.
+         *
+         * @param home The queue which is looked at first.
+         * @return Whether a task was run.
+        */
+        bool run_one(size_t home);
+
+        void worker_loop(size_t index);
+
+        size_t current_queue();
+
+    public:
+        /**
+         * Constructor for the ThreadPool class.
+         *
+         * @param thread_count The number of worker threads.
+         * @return A new thread pool, with its workers started.
+        */
+        explicit ThreadPool(size_t thread_count);
+
+        /**
+         * Destructor for the ThreadPool class. The tasks
+         * which are still queued are run before the workers
+         * are joined.
+        */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * Return the pool owned by the library, with one
+         * worker per hardware thread.
+         *
+         * @return The library thread pool.
+        */
+        static ThreadPool& get_instance();
+
+        /**
+         * Return the number of worker threads.
+         *
+         * @return The number of workers.
+        */
+        size_t get_thread_count() const;
+
+        /**
+         * Queue a task for execution.
+         *
+         * @param task The task which shall be run.
+        */
+        void submit(std::function<void()> task);
+
+        /**
+         * Run body over [begin, end), split into chunks of
+         * at least grain indices, and wait for all of them.
+         * The calling thread takes part in the work. The first
+         * exception thrown by a chunk is rethrown here.
+         *
+         * @param begin The first index.
+         * @param end One past the last index.
+         * @param grain The minimal number of indices per chunk.
+         * @param body The function run over every chunk, given
+         * the bounds [chunk_begin, chunk_end) of the chunk.
+        */
+        void parallel_for(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& body);
+    };
+}
+
+#endif
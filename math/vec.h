@@ -0,0 +1,391 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __THMATH_VEC_
+#define __THMATH_VEC_
+
+#include "vector.h"
+#include "../exception/illegal_access_exception.h"
+#include "../exception/different_size_exception.h"
+#include "../exception/messages.h"
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+namespace thmath
+{
+    /**
+     * Fixed-dimension vector in R^N, stored inline (on the
+     * stack) rather than on the heap. All arithmetic is
+     * constexpr, and operations between vectors of different
+     * dimensions do not compile, so no runtime size checks are
+     * needed. This is meant for the hot 2D/3D geometry paths;
+     * a Vec converts to and from the dynamic Vector whenever
+     * the two need to meet.
+     *
+     * @tparam N The dimension of the vector.
+     * @tparam T The type of the components.
+    */
+    template <size_t N, typename T = double>
+    class Vec
+    {
+        static_assert(N > 0, "A vector must have at least one component.");
+        static_assert(std::is_arithmetic<T>::value, "The components of a vector must be arithmetic.");
+
+    private:
+        T entries[N];
+
+    public:
+        /**
+         * Default constructor for the Vec class, which
+         * creates the null vector.
+         *
+         * @return A new vector object.
+        */
+        constexpr Vec() : entries{}
+        {
+
+        }
+
+        /**
+         * Component constructor for the Vec class. Exactly
+         * N components must be given, otherwise the call
+         * does not compile.
+         *
+         * @param components The components of the vector,
+         * from left to right.
+         * @return A new vector object.
+        */
+        template <typename... Args, typename = typename std::enable_if<
+            sizeof...(Args) == N && std::conjunction<std::is_arithmetic<Args>...>::value
+        >::type>
+        constexpr Vec(Args... components) : entries{static_cast<T>(components)...}
+        {
+
+        }
+
+        /**
+         * Conversion constructor from a dynamic vector. As the
+         * size of the vector is only known at runtime, it is
+         * checked here.
+         *
+         * @param vec The vector which shall be converted.
+         * @return A new vector object.
+        */
+        explicit Vec(const Vector& vec) : entries{}
+        {
+            if (vec.get_size() != N)
+            {
+                throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+            }
+            const double* source = vec.get_entries();
+            for (size_t index = 0; index < N; index++)
+            {
+                this->entries[index] = static_cast<T>(source[index]);
+            }
+        }
+
+        /**
+         * Conversion operator to a dynamic vector, so that a
+         * Vec can be passed wherever a Vector is expected.
+         *
+         * @return A new (heap allocated) vector object.
+        */
+        operator Vector() const
+        {
+            double converted[N];
+            for (size_t index = 0; index < N; index++)
+            {
+                converted[index] = static_cast<double>(this->entries[index]);
+            }
+            return Vector(N, converted);
+        }
+
+        /**
+         * Obtain the i-th component of the vector
+         * from left to right.
+         *
+         * @param index The index which we are interested
+         * in retrieving
+         * @return The component at the i-th position.
+        */
+        constexpr T get_component(const size_t index) const
+        {
+            if (index >= N)
+            {
+                throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+            }
+            return this->entries[index];
+        }
+
+        /**
+         * Unchecked access to the i-th component.
+         *
+         * @param index The index of the component.
+         * @return The component at the i-th position.
+        */
+        constexpr T operator[](const size_t index) const
+        {
+            return this->entries[index];
+        }
+
+        /**
+         * Unchecked mutable access to the i-th component.
+         *
+         * @param index The index of the component.
+         * @return A reference to the component.
+        */
+        constexpr T& operator[](const size_t index)
+        {
+            return this->entries[index];
+        }
+
+        /**
+         * Obtain the array containing all the entries
+         * for this vector object.
+         *
+         * @return The entries inside this vector object.
+        */
+        constexpr const T* get_entries() const
+        {
+            return this->entries;
+        }
+
+        /**
+         * Return the size of the vector, i.e. the
+         * value of N.
+         *
+         * @return The size of the vector.
+        */
+        static constexpr size_t get_size()
+        {
+            return N;
+        }
+
+        /**
+         * Perform the dot product between two
+         * vectors of the same dimension.
+         *
+         * @param vec The other vector.
+         * @return The scalar product of the two vectors.
+        */
+        constexpr T dot_product(const Vec& vec) const
+        {
+            T result{};
+            for (size_t index = 0; index < N; index++)
+            {
+                result += this->entries[index] * vec.entries[index];
+            }
+            return result;
+        }
+
+        /**
+         * Perform the vector (cross) product between
+         * two vectors. Only defined in R^2 and R^3; as with
+         * Vector, the product of two planar vectors is the
+         * vector (0, 0, z).
+         *
+         * @param vec The vector which we are
+         * crossing with the current one.
+         * @return The cross product of the two vectors.
+        */
+        constexpr Vec<3, T> vector_product(const Vec& vec) const
+        {
+            static_assert(N == 2 || N == 3, "The vector product is only defined in R^2 and R^3.");
+            if constexpr (N == 2)
+            {
+                return Vec<3, T>(T{}, T{}, this->entries[0] * vec.entries[1] - this->entries[1] * vec.entries[0]);
+            }
+            else
+            {
+                return Vec<3, T>(
+                    this->entries[1] * vec.entries[2] - this->entries[2] * vec.entries[1],
+                    this->entries[2] * vec.entries[0] - this->entries[0] * vec.entries[2],
+                    this->entries[0] * vec.entries[1] - this->entries[1] * vec.entries[0]
+                );
+            }
+        }
+
+        /**
+         * Return the square of the Euclidian norm, which,
+         * unlike the norm itself, can be computed at
+         * compile time.
+         *
+         * @return The squared L2 norm of the vector.
+        */
+        constexpr T norm_squared() const
+        {
+            return dot_product(*this);
+        }
+
+        /**
+         * Return the Euclidian (L2) norm of this vector.
+         *
+         * @return The Euclidian (L2) norm of the vector.
+        */
+        double norm() const
+        {
+            return std::sqrt(static_cast<double>(norm_squared()));
+        }
+
+        /**
+         * Multiplies the given vector by a real parameter,
+         * modifying it.
+         *
+         * @param lambda The scale factor.
+         * @return The scaled vector itself.
+        */
+        constexpr Vec& scale(T lambda)
+        {
+            for (size_t index = 0; index < N; index++)
+            {
+                this->entries[index] *= lambda;
+            }
+            return *this;
+        }
+
+        /**
+         * Normalizes the vector by its Euclidian norm.
+         *
+         * @return The same vector object, but
+         * normalized by its L2 norm.
+        */
+        Vec& normalized()
+        {
+            double l2_norm = norm();
+            for (size_t index = 0; index < N; index++)
+            {
+                this->entries[index] = static_cast<T>(this->entries[index] / l2_norm);
+            }
+            return *this;
+        }
+
+        /**
+         * Return the angle between two vectors, defined
+         * as the dot product over the product of L2 norms.
+         *
+         * @param vec The other vector.
+         * @param cosine Whether or not the cosine shall
+         * be returned instead of the angle.
+         * @return The angle between the two vectors.
+        */
+        double angle(const Vec& vec, bool cosine = false) const
+        {
+            double cos = static_cast<double>(dot_product(vec)) / std::sqrt(
+                static_cast<double>(norm_squared()) * static_cast<double>(vec.norm_squared())
+            );
+            return cosine ? cos : std::acos(cos);
+        }
+
+        constexpr Vec operator+(const Vec& vec) const
+        {
+            Vec result;
+            for (size_t index = 0; index < N; index++)
+            {
+                result.entries[index] = this->entries[index] + vec.entries[index];
+            }
+            return result;
+        }
+
+        constexpr Vec& operator+=(const Vec& vec)
+        {
+            for (size_t index = 0; index < N; index++)
+            {
+                this->entries[index] += vec.entries[index];
+            }
+            return *this;
+        }
+
+        constexpr Vec operator-(const Vec& vec) const
+        {
+            Vec result;
+            for (size_t index = 0; index < N; index++)
+            {
+                result.entries[index] = this->entries[index] - vec.entries[index];
+            }
+            return result;
+        }
+
+        constexpr Vec& operator-=(const Vec& vec)
+        {
+            for (size_t index = 0; index < N; index++)
+            {
+                this->entries[index] -= vec.entries[index];
+            }
+            return *this;
+        }
+
+        constexpr Vec operator*(T lambda) const
+        {
+            Vec result(*this);
+            return result.scale(lambda);
+        }
+
+        constexpr Vec& operator*=(T lambda)
+        {
+            return scale(lambda);
+        }
+
+        constexpr bool operator==(const Vec& vec) const
+        {
+            for (size_t index = 0; index < N; index++)
+            {
+                if (this->entries[index] != vec.entries[index])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        constexpr bool operator!=(const Vec& vec) const
+        {
+            return !(*this == vec);
+        }
+
+        /**
+         * Stringify the vector object, in the same
+         * format as Vector::to_string.
+         *
+         * @return The stringified version of the vector.
+        */
+        std::string to_string() const
+        {
+            std::string s = "Vector={size=" + std::to_string(N) + ", elements=[";
+            for (size_t index = 0; index < N - 1; index++)
+            {
+                s += std::to_string(this->entries[index]) + ", ";
+            }
+            s += std::to_string(this->entries[N - 1]) + "]}";
+            return s;
+        }
+    };
+
+    using Vec2 = Vec<2>;
+    using Vec3 = Vec<3>;
+}
+
+#endif
@@ -22,6 +22,9 @@
  */
 
 #include "vector.h"
+#include "simd.h"
+#include "norm.h"
+#include "predicates.h"
 #include "../exception/illegal_access_exception.h"
 #include "../exception/different_size_exception.h"
 #include "../exception/illegal_size_exception.h"
@@ -33,39 +36,180 @@
 #include <numeric>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 
-thmath::Vector::Vector(size_t size, double* entries)
+namespace
+{
+    // Statistics of the norm cache. Every thread counts into its own
+    // counters, so that norm() never contends on a shared cache line;
+    // reading them sums the counters of the live threads with what the
+    // exited ones had counted.
+    struct NormCacheCounters
+    {
+        std::atomic<size_t> hits{0};
+        std::atomic<size_t> misses{0};
+
+        NormCacheCounters();
+        ~NormCacheCounters();
+    };
+
+    struct NormCacheRegistry
+    {
+        std::mutex mutex;
+        std::vector<NormCacheCounters*> live;
+        size_t retired_hits = 0;
+        size_t retired_misses = 0;
+        // The totals at the last reset.
+        size_t reset_hits = 0;
+        size_t reset_misses = 0;
+    };
+
+    // Never destroyed, since threads may exit after the static objects are.
+    NormCacheRegistry& registry()
+    {
+        static NormCacheRegistry* instance = new NormCacheRegistry();
+        return *instance;
+    }
+
+    NormCacheCounters::NormCacheCounters()
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        registry().live.push_back(this);
+    }
+
+    NormCacheCounters::~NormCacheCounters()
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        std::vector<NormCacheCounters*>& live = registry().live;
+        live.erase(std::find(live.begin(), live.end(), this));
+        registry().retired_hits += this->hits.load(std::memory_order_relaxed);
+        registry().retired_misses += this->misses.load(std::memory_order_relaxed);
+    }
+
+    NormCacheCounters& norm_cache_counters()
+    {
+        thread_local NormCacheCounters counters;
+        return counters;
+    }
+
+    // Only the owning thread writes its counters: no read-modify-write needed.
+    void count(std::atomic<size_t>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // The totals since the start, with the registry locked.
+    thmath::Vector::NormCacheStatistics norm_cache_totals(const NormCacheRegistry& registry)
+    {
+        thmath::Vector::NormCacheStatistics totals{registry.retired_hits, registry.retired_misses};
+        for (const NormCacheCounters* counters : registry.live)
+        {
+            totals.hits += counters->hits.load(std::memory_order_relaxed);
+            totals.misses += counters->misses.load(std::memory_order_relaxed);
+        }
+        return totals;
+    }
+}
+
+thmath::Vector::Vector(size_t size, const double* entries, std::pmr::memory_resource* resource) : resource(resource)
 {
     if (size <= 0)
     {
         throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
     }
+    this->entries = allocate_entries(size);
     this->size = size;
-    this->entries = new double[size];
 
     std::copy(entries, entries + size, this->entries);
 }
 
-thmath::Vector::Vector(const Vector& other) : size(other.size), entries(new double[other.size])
+thmath::Vector::Vector(const size_t size, std::pmr::memory_resource* resource) : resource(resource)
 {
+    this->entries = allocate_entries(size);
+    this->size = size;
+}
+
+thmath::Vector::Vector(const Vector& other) : Vector(other, memory::get_default_resource())
+{
+
+}
+
+thmath::Vector::Vector(const Vector& other, std::pmr::memory_resource* resource) : resource(resource)
+{
+    this->entries = allocate_entries(other.size);
+    this->size = other.size;
     std::copy(other.entries, other.entries + other.size, this->entries);
+    this->norm_caching = other.norm_caching;
+    copy_norm(other);
+}
+
+thmath::Vector::Vector(Vector&& other) noexcept : entries(other.entries), size(other.size), resource(other.resource)
+{
+    this->norm_caching = other.norm_caching;
+    copy_norm(other);
+    other.entries = nullptr;
+    other.size = 0;
+    other.invalidate_norm();
 }
 
-thmath::Vector::Vector(std::initializer_list<double> entries)
+thmath::Vector::Vector(std::initializer_list<double> entries, std::pmr::memory_resource* resource) : resource(resource)
 {
     if (entries.size() <= 0)
     {
         throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
     }
+    this->entries = allocate_entries(entries.size());
     this->size = entries.size();
-    this->entries = new double[this->size];
 
     std::copy(entries.begin(), entries.end(), this->entries);
 }
 
 thmath::Vector::~Vector()
 {
-    delete[] this->entries;
+    deallocate_entries();
+}
+
+double* thmath::Vector::allocate_entries(const size_t size) const
+{
+    return static_cast<double*>(this->resource->allocate(size * sizeof(double), alignof(double)));
+}
+
+void thmath::Vector::copy_norm(const Vector& other)
+{
+    if (this->norm_caching && other.norm_valid.load(std::memory_order_acquire))
+    {
+        this->cached_norm.store(other.cached_norm.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        this->norm_valid.store(true, std::memory_order_release);
+    }
+    else
+    {
+        invalidate_norm();
+    }
+}
+
+void thmath::Vector::store_norm(double value) const
+{
+    if (this->norm_caching)
+    {
+        count(norm_cache_counters().misses);
+        this->cached_norm.store(value, std::memory_order_relaxed);
+        this->norm_valid.store(true, std::memory_order_release);
+    }
+}
+
+void thmath::Vector::deallocate_entries()
+{
+    if (this->entries != nullptr)
+    {
+        this->resource->deallocate(this->entries, this->size * sizeof(double), alignof(double));
+        this->entries = nullptr;
+    }
+}
+
+std::pmr::memory_resource* thmath::Vector::get_resource() const
+{
+    return this->resource;
 }
 
 double thmath::Vector::get_component(const int index) const
@@ -77,11 +221,46 @@ double thmath::Vector::get_component(const int index) const
     return this->entries[index];
 }
 
-double* thmath::Vector::get_entries() const
+const double* thmath::Vector::get_entries() const
+{
+    return this->entries;
+}
+
+double* thmath::Vector::mutable_entries()
 {
+    invalidate_norm();
     return this->entries;
 }
 
+void thmath::Vector::set_norm_caching(bool enabled)
+{
+    this->norm_caching = enabled;
+    invalidate_norm();
+}
+
+bool thmath::Vector::is_norm_caching() const
+{
+    return this->norm_caching;
+}
+
+thmath::Vector::NormCacheStatistics thmath::Vector::get_norm_cache_statistics()
+{
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    NormCacheStatistics totals = norm_cache_totals(registry());
+    return NormCacheStatistics{
+        totals.hits - registry().reset_hits,
+        totals.misses - registry().reset_misses
+    };
+}
+
+void thmath::Vector::reset_norm_cache_statistics()
+{
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    NormCacheStatistics totals = norm_cache_totals(registry());
+    registry().reset_hits = totals.hits;
+    registry().reset_misses = totals.misses;
+}
+
 size_t thmath::Vector::get_size() const
 {
     return this->size;
@@ -89,31 +268,49 @@ size_t thmath::Vector::get_size() const
 
 double thmath::Vector::norm(double p) const
 {
-    double max_abs = *std::max_element(this->entries, this->entries + this->size, [](double a, double b) {
-        return std::abs(a) < std::abs(b);
-    });
-
-    std::vector<double> scaled_entries(this->size);
-    std::transform(this->entries, this->entries + this->size, scaled_entries.begin(), [max_abs](double x) {
-        return x / max_abs;
-    });
-
-    return max_abs * std::pow(
-        std::accumulate(scaled_entries.begin(), scaled_entries.end(), 0.0, [p](double total, double x) {
-            return total + std::pow(std::abs(x), p);
-        }),
-        1.0 / p
-    );
+    return norms::lp(this->entries, this->size, p);
 }
 
 double thmath::Vector::norm() const
 {
-    return norm(2);
+    if (this->norm_valid.load(std::memory_order_acquire))
+    {
+        count(norm_cache_counters().hits);
+        return this->cached_norm.load(std::memory_order_relaxed);
+    }
+    double result = norms::l2(this->entries, this->size);
+    store_norm(result);
+    return result;
+}
+
+double thmath::Vector::norm(execution::Policy policy) const
+{
+    if (!execution::is_parallel(policy, this->size) || this->norm_valid.load(std::memory_order_acquire))
+    {
+        return norm();
+    }
+    const double* entries = this->entries;
+    std::vector<double> partials = execution::map_chunks(this->size, [entries](size_t begin, size_t end) {
+        return norms::l2(entries + begin, end - begin);
+    });
+    double largest = norms::infinity(partials.data(), partials.size());
+    if (largest == 0.0 || !std::isfinite(largest))
+    {
+        return largest;
+    }
+    double sum = 0.0;
+    for (double partial : partials)
+    {
+        sum += (partial / largest) * (partial / largest);
+    }
+    double result = largest * std::sqrt(sum);
+    store_norm(result);
+    return result;
 }
 
 double thmath::Vector::infinity_norm() const
 {
-    return *std::max_element(this->entries, this->entries + this->size);
+    return norms::infinity(this->entries, this->size);
 }
 
 double thmath::Vector::dot_product(const Vector& vec) const
@@ -122,9 +319,67 @@ double thmath::Vector::dot_product(const Vector& vec) const
     {
         throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
     }
-    return std::inner_product(
-        this->entries, this->entries + this->size, vec.entries, 0.0
-    );
+    return simd::dot(this->entries, vec.entries, this->size);
+}
+
+double thmath::Vector::dot_product(const Vector& vec, execution::Policy policy) const
+{
+    if (this->size != vec.size) 
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    if (!execution::is_parallel(policy, this->size))
+    {
+        return simd::dot(this->entries, vec.entries, this->size);
+    }
+    const double* a = this->entries;
+    const double* b = vec.entries;
+    std::vector<double> partials = execution::map_chunks(this->size, [a, b](size_t begin, size_t end) {
+        return simd::dot(a + begin, b + begin, end - begin);
+    });
+    return std::accumulate(partials.begin(), partials.end(), 0.0);
+}
+
+thmath::Vector::DotNorms thmath::Vector::dot_norms(const Vector& vec) const
+{
+    if (this->size != vec.size)
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    if (this->norm_valid.load(std::memory_order_acquire) && vec.norm_valid.load(std::memory_order_acquire))
+    {
+        return DotNorms{simd::dot(this->entries, vec.entries, this->size), norm(), vec.norm()};
+    }
+    double sums[3];
+    simd::dot_norms(this->entries, vec.entries, this->size, sums);
+    DotNorms result{
+        sums[0],
+        norms::l2_from_squares(this->entries, this->size, sums[1]),
+        norms::l2_from_squares(vec.entries, vec.size, sums[2])
+    };
+    store_norm(result.norm);
+    vec.store_norm(result.other_norm);
+    return result;
+}
+
+void thmath::Vector::multi_dot(const Vector* const* others, size_t count, double* results) const
+{
+    // The entries are gathered in blocks, so that no allocation is needed.
+    const size_t BLOCK = 12;
+    const double* entries[BLOCK];
+    for (size_t first = 0; first < count; first += BLOCK)
+    {
+        size_t block = std::min(BLOCK, count - first);
+        for (size_t other = 0; other < block; other++)
+        {
+            if (others[first + other]->size != this->size)
+            {
+                throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+            }
+            entries[other] = others[first + other]->entries;
+        }
+        simd::multi_dot(this->entries, entries, block, this->size, results + first);
+    }
 }
 
 thmath::Vector thmath::Vector::vector_product(const Vector& vec) const
@@ -149,17 +404,88 @@ thmath::Vector thmath::Vector::vector_product(const Vector& vec) const
 
 thmath::Vector& thmath::Vector::scale(double lambda)
 {
-    std::transform(
-        this->entries, this->entries + this->size, this->entries, [lambda](double element){
-            return element * lambda;
-        }
-    );
+    invalidate_norm();
+    simd::scale(this->entries, lambda, this->size);
+    return *this;
+}
+
+thmath::Vector& thmath::Vector::scale(double lambda, execution::Policy policy)
+{
+    if (!execution::is_parallel(policy, this->size))
+    {
+        return scale(lambda);
+    }
+    invalidate_norm();
+    double* entries = this->entries;
+    execution::parallel_for(this->size, [entries, lambda](size_t begin, size_t end) {
+        simd::scale(entries + begin, lambda, end - begin);
+    });
+    return *this;
+}
+
+thmath::Vector& thmath::Vector::add(const Vector& vec, execution::Policy policy)
+{
+    if (this->size != vec.size)
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    if (!execution::is_parallel(policy, this->size))
+    {
+        return *this += vec;
+    }
+    invalidate_norm();
+    double* a = this->entries;
+    const double* b = vec.entries;
+    execution::parallel_for(this->size, [a, b](size_t begin, size_t end) {
+        simd::add(a + begin, b + begin, end - begin);
+    });
+    return *this;
+}
+
+thmath::Vector& thmath::Vector::subtract(const Vector& vec, execution::Policy policy)
+{
+    if (this->size != vec.size)
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    if (!execution::is_parallel(policy, this->size))
+    {
+        return *this -= vec;
+    }
+    invalidate_norm();
+    double* a = this->entries;
+    const double* b = vec.entries;
+    execution::parallel_for(this->size, [a, b](size_t begin, size_t end) {
+        simd::subtract(a + begin, b + begin, end - begin);
+    });
+    return *this;
+}
+
+thmath::Vector& thmath::Vector::axpy(double alpha, const Vector& vec)
+{
+    return axpby(alpha, vec, 1.0);
+}
+
+thmath::Vector& thmath::Vector::axpby(double alpha, const Vector& vec, double beta)
+{
+    if (this->size != vec.size)
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    invalidate_norm();
+    simd::axpby(this->entries, alpha, vec.entries, beta, this->size);
     return *this;
 }
 
+thmath::Vector& thmath::Vector::scale_add(double lambda, const Vector& vec)
+{
+    return axpby(1.0, vec, lambda);
+}
+
 thmath::Vector& thmath::Vector::normalized(double p)
 {
     double p_norm = norm(p);
+    invalidate_norm();
     std::transform(
         this->entries, this->entries + this->size, this->entries, [p_norm](double element){
             return element / p_norm;
@@ -170,7 +496,14 @@ thmath::Vector& thmath::Vector::normalized(double p)
 
 thmath::Vector& thmath::Vector::normalized()
 {
-    return normalized(2);
+    double l2_norm = norm();
+    invalidate_norm();
+    std::transform(
+        this->entries, this->entries + this->size, this->entries, [l2_norm](double element){
+            return element / l2_norm;
+        }
+    );
+    return *this;
 }
 
 double thmath::Vector::angle(const Vector& vec, bool cosine) const
@@ -179,7 +512,8 @@ double thmath::Vector::angle(const Vector& vec, bool cosine) const
     {
         throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
     }
-    double cos = dot_product(vec) / (norm() * vec.norm());
+    DotNorms sums = dot_norms(vec);
+    double cos = sums.dot / (sums.norm * sums.other_norm);
     return cosine ? cos : std::acos(cos);
 }
 
@@ -190,12 +524,17 @@ bool thmath::Vector::is_parallel(const Vector& vec) const
         throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
     }
 
-    return std::abs(dot_product(vec)) == norm() * vec.norm();
+    return predicates::parallel(this->entries, vec.entries, this->size);
 }
 
 bool thmath::Vector::is_perpendicular(const Vector& vec) const
 {
-    return dot_product(vec) == 0;
+    if (this->size != vec.size)
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+
+    return predicates::perpendicular(this->entries, vec.entries, this->size);
 }
 
 bool thmath::Vector::operator==(const Vector& vec) const
@@ -218,26 +557,37 @@ thmath::Vector& thmath::Vector::operator=(const Vector& vec)
 {
     if (this != &vec)
     {
-        delete[] this->entries;
-        this->size = vec.size;
-        this->entries = new double[vec.size];
+        if (this->size != vec.size)
+        {
+            double* resized = allocate_entries(vec.size);
+            deallocate_entries();
+            this->entries = resized;
+            this->size = vec.size;
+        }
         std::copy(vec.entries, vec.entries + vec.size, this->entries);
+        copy_norm(vec);
     }
     return *this;
 }
 
-thmath::Vector thmath::Vector::operator+(const Vector& vec) const
+thmath::Vector& thmath::Vector::operator=(Vector&& vec)
 {
-    if (this->size != vec.size)
+    if (this == &vec)
     {
-        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+        return *this;
     }
-    double* final_entries = new double[this->size];
-    for (int index = 0; index < this->size; index++)
+    if (this->resource != vec.resource && !this->resource->is_equal(*vec.resource))
     {
-        final_entries[index] = this->entries[index] + vec.entries[index];
+        return *this = static_cast<const Vector&>(vec);
     }
-    return Vector(this->size, final_entries);
+    deallocate_entries();
+    this->entries = vec.entries;
+    this->size = vec.size;
+    copy_norm(vec);
+    vec.entries = nullptr;
+    vec.size = 0;
+    vec.invalidate_norm();
+    return *this;
 }
 
 thmath::Vector& thmath::Vector::operator+=(const Vector& vec)
@@ -246,60 +596,26 @@ thmath::Vector& thmath::Vector::operator+=(const Vector& vec)
     {
         throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
     }
-    std::transform(
-            this->entries, this->entries + this->size, vec.entries, this->entries, [](double a, double b){
-            return a + b;
-        }
-    );
+    invalidate_norm();
+    simd::add(this->entries, vec.entries, this->size);
     return *this;
 }
 
-thmath::Vector thmath::Vector::operator-(const Vector& vec) const
-{
-    if (this->size != vec.size)
-    {
-        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
-    }
-    double* final_entries = new double[this->size];
-    for (int index = 0; index < this->size; index++)
-    {
-        final_entries[index] = this->entries[index] - vec.entries[index];
-    }
-    return Vector(this->size, final_entries);
-}
-
 thmath::Vector& thmath::Vector::operator-=(const Vector& vec)
 {
     if (this->size != vec.size)
     {
         throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
     }
-    std::transform(
-            this->entries, this->entries + this->size, vec.entries, this->entries, [](double a, double b){
-            return a - b;
-        }
-    );
+    invalidate_norm();
+    simd::subtract(this->entries, vec.entries, this->size);
     return *this;
 }
 
-thmath::Vector thmath::Vector::operator*(double lambda) const
-{
-    double* scaled = new double[this->size];
-    std::transform(
-        this->entries, this->entries + this->size, scaled, [lambda](double d){
-            return lambda * d;
-        }
-    );
-    return Vector(this->size, scaled);
-}
-
 thmath::Vector& thmath::Vector::operator*=(double lambda)
 {
-    std::transform(
-        this->entries, this->entries + this->size, this->entries, [lambda](double d){
-            return lambda * d;
-        }
-    );
+    invalidate_norm();
+    simd::scale(this->entries, lambda, this->size);
     return *this;
 }
 
@@ -29,6 +29,10 @@
 #define nullvec3 thmath::Vector{0, 0, 0}
 #define nullvec2 thmath::Vector{0, 0}
 
+#include "vector_expression.h"
+#include "memory.h"
+#include "execution.h"
+#include <atomic>
 #include <string>
 
 namespace thmath
@@ -38,6 +42,63 @@ namespace thmath
     private:
         double* entries;
         size_t size;
+        std::pmr::memory_resource* resource;
+        // The cached L2 norm, which is valid while norm_valid is set.
+        // Every mutating member clears the flag; both are atomic so
+        // that const vectors may still be shared between threads.
+        mutable std::atomic<double> cached_norm{0.0};
+        mutable std::atomic<bool> norm_valid{false};
+        bool norm_caching = false;
+
+        void invalidate_norm()
+        {
+            this->norm_valid.store(false, std::memory_order_relaxed);
+        }
+
+        /**
+         * Take over the cached norm of a vector whose
+         * entries have just been copied (or moved) here.
+         *
+         * @param other The source of the entries.
+        */
+        void copy_norm(const Vector& other);
+
+        /**
+         * Cache a freshly computed norm, if caching is enabled,
+         * and count it as a miss.
+         *
+         * @param value The L2 norm of the current entries.
+        */
+        void store_norm(double value) const;
+
+        /**
+         * Allocating constructor for the Vector class. The
+         * storage is left uninitialized, so this is only meant
+         * for results which are about to be written in full
+         * (e.g. the outcome of an arithmetic operator), which
+         * avoids going through a temporary buffer and a copy.
+         * 
+         * @param size The size of the vector.
+         * @param resource The memory resource providing the storage.
+         * @return A new vector object with uninitialized entries.
+        */
+        explicit Vector(const size_t size, std::pmr::memory_resource* resource = memory::get_default_resource());
+
+        // Matrix products fill their result through the allocating constructor.
+        friend class Matrix;
+        friend class CsrMatrix;
+
+        /**
+         * Allocate storage for the given number of entries
+         * from the memory resource of this vector.
+        */
+        double* allocate_entries(const size_t size) const;
+
+        /**
+         * Return the entries of this vector to its memory
+         * resource, leaving the vector without storage.
+        */
+        void deallocate_entries();
 
     public:
         /**
@@ -49,9 +110,16 @@ namespace thmath
          * of n.
          * @param entries A list of doubles containing
          * all components of the vector.
+         * @param resource The memory resource providing the
+         * storage; by default, the one of the current thread
+         * (see memory::get_default_resource).
          * @return A new vector object.
         */
-        Vector(const size_t size, double* entries);
+        Vector(
+            const size_t size,
+            const double* entries,
+            std::pmr::memory_resource* resource = memory::get_default_resource()
+        );
 
         /**
          * Initializer list constructor for the Vector class.
@@ -61,18 +129,60 @@ namespace thmath
          * 
          * @param entries The entries which shall be in the
          * vector.
+         * @param resource The memory resource providing the storage.
          * @return A new vector object.
         */
-        Vector(std::initializer_list<double> entries);
+        Vector(
+            std::initializer_list<double> entries,
+            std::pmr::memory_resource* resource = memory::get_default_resource()
+        );
 
         /**
-         * Copy constructor for the vector class.
+         * Copy constructor for the vector class. As with the
+         * standard polymorphic allocators, the memory resource
+         * is not copied: the copy uses the default one.
          * 
          * @param other The vector which shall be copied.
          * @return A new vector object.
         */
         Vector(const Vector& other);
 
+        /**
+         * Copy constructor for the vector class, allocating
+         * the copy from the given memory resource.
+         * 
+         * @param other The vector which shall be copied.
+         * @param resource The memory resource providing the storage.
+         * @return A new vector object.
+        */
+        Vector(const Vector& other, std::pmr::memory_resource* resource);
+
+        /**
+         * Move constructor for the vector class. The entries
+         * (and memory resource) of the other vector are taken
+         * over without any allocation, leaving it empty.
+         * 
+         * @param other The vector which shall be moved.
+         * @return A new vector object.
+        */
+        Vector(Vector&& other) noexcept;
+
+        /**
+         * Expression constructor for the vector class. This
+         * evaluates an arithmetic expression built out of the
+         * operators +, - and * (e.g. a + b - c * k) in a single
+         * pass, writing the result straight into the new vector.
+         * 
+         * @param expression The expression which shall be evaluated.
+         * @param resource The memory resource providing the storage.
+         * @return A new vector object.
+        */
+        template <typename E>
+        Vector(
+            const VectorExpression<E>& expression,
+            std::pmr::memory_resource* resource = memory::get_default_resource()
+        );
+
         /**
          * Default destructor for any vector object.
         */
@@ -94,7 +204,54 @@ namespace thmath
          * 
          * @return The entries inside this vector object.
         */
-        double* get_entries() const;
+        const double* get_entries() const;
+
+        /**
+         * Obtain the array of entries for writing. This drops
+         * the cached norm, so the array must not be written
+         * after the next call to norm().
+         * 
+         * @return The entries inside this vector object.
+        */
+        double* mutable_entries();
+
+        /**
+         * Enable or disable the caching of the L2 norm of this
+         * vector (disabled by default). While it is enabled, norm()
+         * only runs the first time after every modification; copy
+         * constructed vectors inherit the setting.
+         * 
+         * @param enabled Whether the norm shall be cached.
+        */
+        void set_norm_caching(bool enabled);
+
+        /**
+         * Check whether the L2 norm of this vector is cached.
+         * 
+         * @return Whether the norm is cached.
+        */
+        bool is_norm_caching() const;
+
+        struct NormCacheStatistics
+        {
+            size_t hits;    /**< Calls answered from the cache. */
+            size_t misses;  /**< Calls which computed (and cached) the norm. */
+        };
+
+        /**
+         * Return the number of hits and misses of the norm
+         * cache, over all vectors and threads, since the last
+         * reset. Every thread counts on its own, so counting
+         * costs no synchronization on the norm() path.
+         * 
+         * @return The statistics of the norm cache.
+        */
+        static NormCacheStatistics get_norm_cache_statistics();
+
+        /**
+         * Reset the statistics of the norm cache to zero.
+        */
+        static void reset_norm_cache_statistics();
 
         /**
          * Return the size of the vector, i.e. the
@@ -105,6 +262,14 @@ namespace thmath
         */
         size_t get_size() const;
 
+        /**
+         * Return the memory resource which provides
+         * the storage of this vector.
+         * 
+         * @return The memory resource.
+        */
+        std::pmr::memory_resource* get_resource() const;
+
         /**
          * Compute the Lp norm of this vector object,
          * where p is a real parameter. Note that the Lp
@@ -114,6 +279,9 @@ namespace thmath
          * 
          * This is particularly useful when we are not
          * only interested in the Euclidian norm of this object.
+         * The norm is computed in a single pass, without any
+         * scratch memory; p = 1, 2, infinity and integer values
+         * of p use dedicated kernels.
          * 
          * @param p The real parameter for which we want to
          * compute the norm
@@ -123,16 +291,29 @@ namespace thmath
 
         /**
          * Return the Euclidian (L2) norm of this
-         * vector. This function simply calls the Lp
-         * norm implementation.
+         * vector. This function uses the dedicated
+         * (overflow-safe) L2 kernel, and caches the
+         * result (see set_norm_caching).
          * 
          * @return The Euclidian (L2) norm of the vector.
         */
         double norm() const;
 
+        /**
+         * Return the Euclidian (L2) norm of this vector,
+         * computed under the given execution policy. With a
+         * parallel policy, every chunk computes its own
+         * (overflow-safe) norm, and the partial norms are
+         * then combined with the same scaling.
+         * 
+         * @param policy The execution policy.
+         * @return The Euclidian (L2) norm of the vector.
+        */
+        double norm(execution::Policy policy) const;
+
         /**
          * Return the infinity-norm of this vector, i.e.
-         * the maximum element within its components.
+         * the maximum absolute value within its components.
          * 
          * Note that one can easily prove that the infinity
          * norm returns the maximum element by dividing through
@@ -156,6 +337,47 @@ namespace thmath
         */
         double dot_product(const Vector& vec) const;
 
+        /**
+         * Perform the dot product between two vectors
+         * under the given execution policy. The partial
+         * sums of the chunks are added in chunk order.
+         * 
+         * @param vec The other vector.
+         * @param policy The execution policy.
+         * @return The scalar product of the two vectors.
+        */
+        double dot_product(const Vector& vec, execution::Policy policy) const;
+
+        struct DotNorms
+        {
+            double dot;         /**< The scalar product of the two vectors. */
+            double norm;        /**< The L2 norm of this vector. */
+            double other_norm;  /**< The L2 norm of the other vector. */
+        };
+
+        /**
+         * Compute the scalar product of two vectors and both
+         * of their L2 norms in a single pass over the entries.
+         * The norms are exactly those returned by norm(), and
+         * are cached just the same.
+         * 
+         * @param vec The other vector.
+         * @return The scalar product and the two norms.
+        */
+        DotNorms dot_norms(const Vector& vec) const;
+
+        /**
+         * Compute the scalar products of this vector with
+         * several others, reading this vector once per block
+         * of them rather than once per product.
+         * 
+         * @param others The count vectors, all of the same
+         * size as this one.
+         * @param count The number of other vectors.
+         * @param results Receives the count scalar products.
+        */
+        void multi_dot(const Vector* const* others, size_t count, double* results) const;
+
         /**
          * Perform the vector product between the
          * two given vector objects, and return a
@@ -181,6 +403,82 @@ namespace thmath
         */
         Vector& scale(double lambda);
 
+        /**
+         * Rescale the vector under the given execution policy.
+         * 
+         * @param lambda The scale factor.
+         * @param policy The execution policy.
+         * @return The rescaled vector itself.
+        */
+        Vector& scale(double lambda, execution::Policy policy);
+
+        /**
+         * Add another vector onto this one (as +=), under
+         * the given execution policy.
+         * 
+         * @param vec The vector which shall be added.
+         * @param policy The execution policy.
+         * @return The modified vector.
+        */
+        Vector& add(const Vector& vec, execution::Policy policy);
+
+        /**
+         * Subtract another vector from this one (as -=),
+         * under the given execution policy.
+         * 
+         * @param vec The vector which shall be subtracted.
+         * @param policy The execution policy.
+         * @return The modified vector.
+        */
+        Vector& subtract(const Vector& vec, execution::Policy policy);
+
+        /**
+         * Add a multiple of the given vector onto this one,
+         * i.e. this = this + alpha * vec (BLAS axpy), in a single
+         * pass and without a temporary vector.
+         * 
+         * @param alpha The factor of the added vector.
+         * @param vec The vector which shall be added.
+         * @return The modified vector.
+        */
+        Vector& axpy(double alpha, const Vector& vec);
+
+        /**
+         * Replace this vector by a linear combination with the
+         * given one, i.e. this = alpha * vec + beta * this (BLAS
+         * axpby), in a single pass.
+         * 
+         * @param alpha The factor of the other vector.
+         * @param vec The other vector.
+         * @param beta The factor of this vector.
+         * @return The modified vector.
+        */
+        Vector& axpby(double alpha, const Vector& vec, double beta);
+
+        /**
+         * Rescale this vector, then add the given one, i.e.
+         * this = lambda * this + vec, in a single pass. The
+         * result is the same as that of scale followed by +=.
+         * 
+         * @param lambda The scale factor of this vector.
+         * @param vec The vector which shall be added.
+         * @return The modified vector.
+        */
+        Vector& scale_add(double lambda, const Vector& vec);
+
+        /**
+         * Evaluate an arithmetic expression into this vector
+         * (as operator=), under the given execution policy.
+         * The expression must not reference this vector with
+         * an offset, since chunks are written concurrently.
+         * 
+         * @param expression The expression which shall be assigned.
+         * @param policy The execution policy.
+         * @return The modified vector.
+        */
+        template <typename E>
+        Vector& assign(const VectorExpression<E>& expression, execution::Policy policy);
+
         /**
          * Normalizes the vector by its Lp norm.
          * 
@@ -204,7 +502,8 @@ namespace thmath
          * vectors. For R^2 and R^3, this is obvious
          * and intuitive; however, for a general R^n
          * vector space, we define the angle as the dot product
-         * over the vectors' product of L2 norms.
+         * over the vectors' product of L2 norms. All three are
+         * computed in a single pass (see dot_norms).
          * 
          * @param vec The other vector which we are
          * measuring the angle with respect to.
@@ -219,7 +518,8 @@ namespace thmath
          * Check whether or not the two given vectors
          * are parallel. Note that this simply checks
          * whether there exists a constant k such that
-         * vec_2 = k * vec_1, essentially.
+         * vec_2 = k * vec_1, essentially. The test is
+         * exact (see predicates::parallel).
          * 
          * @param vec The vector which we are checking
          * parallelism for.
@@ -230,7 +530,8 @@ namespace thmath
         /**
          * Check whether or not the two given vectors
          * are perpendicular. Note that this simply checks
-         * whether their scalar product is null.
+         * whether their scalar product is null, computed
+         * exactly (see predicates::perpendicular).
          * 
          * @param vec The vector which we are checking
          * perpendicularity with.
@@ -238,16 +539,6 @@ namespace thmath
         */
         bool is_perpendicular(const Vector& vec) const;
 
-        /**
-         * Operator overloading for vector addition.
-         * 
-         * @param vec The vector which we are adding
-         * onto our current vector.
-         * @return A new vector object representing the
-         * sum of the two vectors.
-        */
-        Vector operator+(const Vector& vec) const;
-
         /**
          * Operator overloading for vector addition,
          * but without generating a new vector object.
@@ -259,14 +550,14 @@ namespace thmath
         Vector& operator+=(const Vector& vec);
 
         /**
-         * Operator overloading for vector subtraction.
+         * Add an arithmetic expression onto the current
+         * vector, evaluating it in the same pass.
          * 
-         * @param vec The vector which will be subtracted 
-         * from our current vector.
-         * @return A new vector object representing the
-         * difference of the two vectors.
+         * @param expression The expression which shall be added.
+         * @return The modified vector.
         */
-        Vector operator-(const Vector& vec) const;
+        template <typename E>
+        Vector& operator+=(const VectorExpression<E>& expression);
 
         /**
          * Operator overloading for vector subtraction,
@@ -279,14 +570,14 @@ namespace thmath
         Vector& operator-=(const Vector& vec);
 
         /**
-         * Multiply the given vector by the said
-         * real parameter, and return a new vector.
+         * Subtract an arithmetic expression from the current
+         * vector, evaluating it in the same pass.
          * 
-         * @param lambda The amount by which the
-         * vector should be scaled.
-         * @return A new vector scaled by lambda.
+         * @param expression The expression which shall be subtracted.
+         * @return The modified vector.
         */
-        Vector operator*(double lambda) const;
+        template <typename E>
+        Vector& operator-=(const VectorExpression<E>& expression);
 
         /**
          * Multiply the given vector by the said
@@ -317,6 +608,30 @@ namespace thmath
         */
         Vector& operator=(const Vector& other);
 
+        /**
+         * Move assignment operator overloading. The entries
+         * of the other vector are taken over and the old
+         * entries of this vector are released. If the two
+         * vectors use different memory resources, the entries
+         * are copied instead.
+         * 
+         * @param other The vector which shall be moved.
+         * @return The modified vector.
+        */
+        Vector& operator=(Vector&& other);
+
+        /**
+         * Expression assignment operator overloading. The
+         * expression is evaluated in a single pass; the current
+         * entries are reused whenever the size is unchanged.
+         * 
+         * @param expression The expression which shall be
+         * assigned.
+         * @return The modified vector.
+        */
+        template <typename E>
+        Vector& operator=(const VectorExpression<E>& expression);
+
         /**
          * Stringify the vector object for it to be
          * easily printed to console (especially for
@@ -329,6 +644,149 @@ namespace thmath
         */
         std::string to_string() const;
     };
+
+    template <>
+    struct is_vector_operand<Vector> : std::true_type
+    {
+
+    };
+
+    /**
+     * Turn a vector into an expression operand, referencing
+     * its entries without copying them.
+     * 
+     * @param vec The vector.
+     * @return A leaf expression referencing the vector.
+    */
+    inline VectorReference as_expression(const Vector& vec)
+    {
+        return VectorReference(vec.get_entries(), vec.get_size());
+    }
+
+    /**
+     * Leaf of an expression tree owning a temporary vector, so
+     * that an expression such as f() + b may outlive the full
+     * expression it was written in. It can be moved but not
+     * copied, and neither can the expressions holding it.
+    */
+    class VectorValue : public VectorExpression<VectorValue>
+    {
+    private:
+        Vector vec;
+        // The entries keep their address when the vector is moved.
+        const double* entries;
+
+    public:
+        explicit VectorValue(Vector&& vec) : vec(std::move(vec)), entries(this->vec.get_entries())
+        {
+
+        }
+
+        VectorValue(VectorValue&& other) = default;
+        VectorValue(const VectorValue& other) = delete;
+        VectorValue& operator=(const VectorValue& other) = delete;
+
+        size_t get_size() const
+        {
+            return this->vec.get_size();
+        }
+
+        double operator[](size_t index) const
+        {
+            return this->entries[index];
+        }
+    };
+
+    /**
+     * Turn a temporary vector into an expression operand,
+     * moving it (without copying its entries) into the leaf.
+     * 
+     * @param vec The temporary vector.
+     * @return A leaf expression owning the vector.
+    */
+    inline VectorValue as_expression(Vector&& vec)
+    {
+        return VectorValue(std::move(vec));
+    }
+
+    template <typename E>
+    Vector::Vector(const VectorExpression<E>& expression, std::pmr::memory_resource* resource)
+        : Vector(expression.get_size(), resource)
+    {
+        const E& source = expression.self();
+        for (size_t index = 0; index < this->size; index++)
+        {
+            this->entries[index] = source[index];
+        }
+    }
+
+    template <typename E>
+    Vector& Vector::operator=(const VectorExpression<E>& expression)
+    {
+        const E& source = expression.self();
+        if (this->size != source.get_size())
+        {
+            Vector result(source, this->resource);
+            return *this = std::move(result);
+        }
+        invalidate_norm();
+        for (size_t index = 0; index < this->size; index++)
+        {
+            this->entries[index] = source[index];
+        }
+        return *this;
+    }
+
+    template <typename E>
+    Vector& Vector::operator+=(const VectorExpression<E>& expression)
+    {
+        const E& source = expression.self();
+        if (this->size != source.get_size())
+        {
+            throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+        }
+        invalidate_norm();
+        for (size_t index = 0; index < this->size; index++)
+        {
+            this->entries[index] += source[index];
+        }
+        return *this;
+    }
+
+    template <typename E>
+    Vector& Vector::operator-=(const VectorExpression<E>& expression)
+    {
+        const E& source = expression.self();
+        if (this->size != source.get_size())
+        {
+            throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+        }
+        invalidate_norm();
+        for (size_t index = 0; index < this->size; index++)
+        {
+            this->entries[index] -= source[index];
+        }
+        return *this;
+    }
+
+    template <typename E>
+    Vector& Vector::assign(const VectorExpression<E>& expression, execution::Policy policy)
+    {
+        const E& source = expression.self();
+        if (this->size != source.get_size() || !execution::is_parallel(policy, this->size))
+        {
+            return *this = expression;
+        }
+        invalidate_norm();
+        double* target = this->entries;
+        execution::parallel_for(this->size, [target, &source](size_t begin, size_t end) {
+            for (size_t index = begin; index < end; index++)
+            {
+                target[index] = source[index];
+            }
+        });
+        return *this;
+    }
 }
 
 #endif
\ No newline at end of file
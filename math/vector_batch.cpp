@@ -0,0 +1,283 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "vector_batch.h"
+#include "../exception/illegal_access_exception.h"
+#include "../exception/different_size_exception.h"
+#include "../exception/illegal_size_exception.h"
+#include "../exception/messages.h"
+#include <cmath>
+#include <string>
+
+thmath::VectorBatch::VectorBatch(const size_t count) : x(count), y(count), z(count)
+{
+
+}
+
+thmath::VectorBatch::VectorBatch(const std::vector<Vector>& vectors) : VectorBatch(vectors.size())
+{
+    for (size_t index = 0; index < vectors.size(); index++)
+    {
+        set(index, vectors[index]);
+    }
+}
+
+size_t thmath::VectorBatch::get_count() const
+{
+    return this->x.size();
+}
+
+void thmath::VectorBatch::resize(const size_t count)
+{
+    this->x.resize(count);
+    this->y.resize(count);
+    this->z.resize(count);
+}
+
+double* thmath::VectorBatch::get_x()
+{
+    return this->x.data();
+}
+
+double* thmath::VectorBatch::get_y()
+{
+    return this->y.data();
+}
+
+double* thmath::VectorBatch::get_z()
+{
+    return this->z.data();
+}
+
+const double* thmath::VectorBatch::get_x() const
+{
+    return this->x.data();
+}
+
+const double* thmath::VectorBatch::get_y() const
+{
+    return this->y.data();
+}
+
+const double* thmath::VectorBatch::get_z() const
+{
+    return this->z.data();
+}
+
+thmath::Vector thmath::VectorBatch::get(const size_t index) const
+{
+    if (index >= get_count())
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    return Vector{this->x[index], this->y[index], this->z[index]};
+}
+
+void thmath::VectorBatch::set(const size_t index, const Vector& vec)
+{
+    if (index >= get_count())
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    if (vec.get_size() != 3)
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+    const double* entries = vec.get_entries();
+    this->x[index] = entries[0];
+    this->y[index] = entries[1];
+    this->z[index] = entries[2];
+}
+
+void thmath::VectorBatch::push_back(const Vector& vec)
+{
+    // Checked first, so that a rejected vector leaves the batch unchanged.
+    if (vec.get_size() != 3)
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+    resize(get_count() + 1);
+    set(get_count() - 1, vec);
+}
+
+std::vector<thmath::Vector> thmath::VectorBatch::to_vectors() const
+{
+    std::vector<Vector> vectors;
+    vectors.reserve(get_count());
+    for (size_t index = 0; index < get_count(); index++)
+    {
+        vectors.push_back(get(index));
+    }
+    return vectors;
+}
+
+void thmath::VectorBatch::dot_product(const VectorBatch& batch, double* result) const
+{
+    if (get_count() != batch.get_count())
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    const double* ax = this->x.data();
+    const double* ay = this->y.data();
+    const double* az = this->z.data();
+    const double* bx = batch.x.data();
+    const double* by = batch.y.data();
+    const double* bz = batch.z.data();
+    const size_t count = get_count();
+    for (size_t index = 0; index < count; index++)
+    {
+        result[index] = ax[index] * bx[index] + ay[index] * by[index] + az[index] * bz[index];
+    }
+}
+
+void thmath::VectorBatch::vector_product(const VectorBatch& batch, VectorBatch& result) const
+{
+    if (get_count() != batch.get_count())
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    const size_t count = get_count();
+    result.resize(count);
+    const double* ax = this->x.data();
+    const double* ay = this->y.data();
+    const double* az = this->z.data();
+    const double* bx = batch.x.data();
+    const double* by = batch.y.data();
+    const double* bz = batch.z.data();
+    double* rx = result.x.data();
+    double* ry = result.y.data();
+    double* rz = result.z.data();
+    for (size_t index = 0; index < count; index++)
+    {
+        // Read every operand before writing, as the result may alias them.
+        double a0 = ax[index], a1 = ay[index], a2 = az[index];
+        double b0 = bx[index], b1 = by[index], b2 = bz[index];
+        rx[index] = a1 * b2 - a2 * b1;
+        ry[index] = a2 * b0 - a0 * b2;
+        rz[index] = a0 * b1 - a1 * b0;
+    }
+}
+
+void thmath::VectorBatch::norm(double* result) const
+{
+    const double* ax = this->x.data();
+    const double* ay = this->y.data();
+    const double* az = this->z.data();
+    const size_t count = get_count();
+    for (size_t index = 0; index < count; index++)
+    {
+        result[index] = std::sqrt(ax[index] * ax[index] + ay[index] * ay[index] + az[index] * az[index]);
+    }
+}
+
+void thmath::VectorBatch::normalized(VectorBatch& result) const
+{
+    const size_t count = get_count();
+    result.resize(count);
+    const double* ax = this->x.data();
+    const double* ay = this->y.data();
+    const double* az = this->z.data();
+    double* rx = result.x.data();
+    double* ry = result.y.data();
+    double* rz = result.z.data();
+    for (size_t index = 0; index < count; index++)
+    {
+        double a0 = ax[index], a1 = ay[index], a2 = az[index];
+        double inverse = 1.0 / std::sqrt(a0 * a0 + a1 * a1 + a2 * a2);
+        rx[index] = a0 * inverse;
+        ry[index] = a1 * inverse;
+        rz[index] = a2 * inverse;
+    }
+}
+
+thmath::VectorBatch& thmath::VectorBatch::normalized()
+{
+    normalized(*this);
+    return *this;
+}
+
+void thmath::VectorBatch::angle(const VectorBatch& batch, double* result, bool cosine) const
+{
+    if (get_count() != batch.get_count())
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    const double* ax = this->x.data();
+    const double* ay = this->y.data();
+    const double* az = this->z.data();
+    const double* bx = batch.x.data();
+    const double* by = batch.y.data();
+    const double* bz = batch.z.data();
+    const size_t count = get_count();
+    for (size_t index = 0; index < count; index++)
+    {
+        double dot = ax[index] * bx[index] + ay[index] * by[index] + az[index] * bz[index];
+        double norm_a = ax[index] * ax[index] + ay[index] * ay[index] + az[index] * az[index];
+        double norm_b = bx[index] * bx[index] + by[index] * by[index] + bz[index] * bz[index];
+        result[index] = dot / std::sqrt(norm_a * norm_b);
+    }
+    if (!cosine)
+    {
+        for (size_t index = 0; index < count; index++)
+        {
+            result[index] = std::acos(result[index]);
+        }
+    }
+}
+
+thmath::VectorBatch& thmath::VectorBatch::axpy(double alpha, const VectorBatch& batch)
+{
+    if (get_count() != batch.get_count())
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    const size_t count = get_count();
+    double* ax = this->x.data();
+    double* ay = this->y.data();
+    double* az = this->z.data();
+    const double* bx = batch.x.data();
+    const double* by = batch.y.data();
+    const double* bz = batch.z.data();
+    for (size_t index = 0; index < count; index++)
+    {
+        ax[index] += alpha * bx[index];
+        ay[index] += alpha * by[index];
+        az[index] += alpha * bz[index];
+    }
+    return *this;
+}
+
+std::string thmath::VectorBatch::to_string() const
+{
+    std::string s = "VectorBatch={count=" + std::to_string(get_count()) + ", vectors=[";
+    for (size_t index = 0; index < get_count(); index++)
+    {
+        if (index > 0)
+        {
+            s += ", ";
+        }
+        s += "(" + std::to_string(this->x[index]) + ", " + std::to_string(this->y[index]) + ", " + std::to_string(this->z[index]) + ")";
+    }
+    s += "]}";
+    return s;
+}
@@ -0,0 +1,208 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __THMATH_VECTOR_BATCH_
+#define __THMATH_VECTOR_BATCH_
+
+#include "vector.h"
+#include <string>
+#include <vector>
+
+namespace thmath
+{
+    /**
+     * A batch of three-dimensional vectors, stored as a
+     * structure of arrays: three separately allocated arrays,
+     * holding the x, the y and the z components respectively.
+     * Compared to a list of separately allocated Vector
+     * objects, this avoids
+     * the pointer chasing and lets every batch operation run
+     * as a straight, vectorizable loop.
+     *
+     * Batch operations write their results into caller-provided
+     * outputs (arrays of doubles, or another batch of the same
+     * count), which may be reused across calls.
+    */
+    class VectorBatch
+    {
+    private:
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> z;
+
+    public:
+        /**
+         * Default constructor for the VectorBatch class,
+         * creating a batch of null vectors.
+         *
+         * @param count The number of vectors in the batch.
+         * @return A new batch object.
+        */
+        explicit VectorBatch(const size_t count = 0);
+
+        /**
+         * Conversion constructor from a list of vectors.
+         * Every vector must be three-dimensional.
+         *
+         * @param vectors The vectors which shall be stored.
+         * @return A new batch object.
+        */
+        explicit VectorBatch(const std::vector<Vector>& vectors);
+
+        /**
+         * Return the number of vectors in the batch.
+         *
+         * @return The number of vectors.
+        */
+        size_t get_count() const;
+
+        /**
+         * Change the number of vectors in the batch.
+         * Newly added vectors are null.
+         *
+         * @param count The new number of vectors.
+        */
+        void resize(const size_t count);
+
+        /**
+         * Obtain the contiguous x (respectively y, z)
+         * components of all vectors in the batch.
+         *
+         * @return The array of components.
+        */
+        double* get_x();
+        double* get_y();
+        double* get_z();
+        const double* get_x() const;
+        const double* get_y() const;
+        const double* get_z() const;
+
+        /**
+         * Obtain the vector at the given index.
+         *
+         * @param index The index of the vector.
+         * @return A new vector object.
+        */
+        Vector get(const size_t index) const;
+
+        /**
+         * Overwrite the vector at the given index.
+         *
+         * @param index The index of the vector.
+         * @param vec The (three-dimensional) vector
+         * which shall be stored.
+        */
+        void set(const size_t index, const Vector& vec);
+
+        /**
+         * Append a (three-dimensional) vector to the batch.
+         *
+         * @param vec The vector which shall be appended.
+        */
+        void push_back(const Vector& vec);
+
+        /**
+         * Convert the batch back into a list of vectors.
+         *
+         * @return The vectors in the batch.
+        */
+        std::vector<Vector> to_vectors() const;
+
+        /**
+         * Perform the dot product between every pair
+         * of vectors at the same index.
+         *
+         * @param batch The other batch, of the same count.
+         * @param result An array of at least get_count()
+         * doubles, receiving the scalar products.
+        */
+        void dot_product(const VectorBatch& batch, double* result) const;
+
+        /**
+         * Perform the vector product between every pair
+         * of vectors at the same index.
+         *
+         * @param batch The other batch, of the same count.
+         * @param result The batch receiving the cross products;
+         * it is resized if needed and may be one of the operands.
+        */
+        void vector_product(const VectorBatch& batch, VectorBatch& result) const;
+
+        /**
+         * Compute the Euclidian (L2) norm of every vector.
+         *
+         * @param result An array of at least get_count()
+         * doubles, receiving the norms.
+        */
+        void norm(double* result) const;
+
+        /**
+         * Normalize every vector by its Euclidian norm.
+         *
+         * @param result The batch receiving the normalized vectors;
+         * it is resized if needed and may be this batch.
+        */
+        void normalized(VectorBatch& result) const;
+
+        /**
+         * Normalize every vector in the batch by its
+         * Euclidian norm, in place.
+         *
+         * @return The same batch, normalized.
+        */
+        VectorBatch& normalized();
+
+        /**
+         * Compute the angle between every pair of
+         * vectors at the same index.
+         *
+         * @param batch The other batch, of the same count.
+         * @param result An array of at least get_count()
+         * doubles, receiving the angles.
+         * @param cosine Whether or not the cosines shall
+         * be returned instead of the angles.
+        */
+        void angle(const VectorBatch& batch, double* result, bool cosine = false) const;
+
+        /**
+         * Add a scaled batch onto this batch, i.e.
+         * compute this = this + alpha * batch.
+         *
+         * @param alpha The scale factor.
+         * @param batch The other batch, of the same count.
+         * @return The modified batch.
+        */
+        VectorBatch& axpy(double alpha, const VectorBatch& batch);
+
+        /**
+         * Stringify the batch, for debugging purposes.
+         *
+         * @return The stringified batch.
+        */
+        std::string to_string() const;
+    };
+}
+
+#endif
@@ -0,0 +1,336 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __THMATH_VECTOR_EXPRESSION_
+#define __THMATH_VECTOR_EXPRESSION_
+
+#include "../exception/different_size_exception.h"
+#include "../exception/messages.h"
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace thmath
+{
+    /**
+     * Base class of every lazily evaluated vector expression.
+     * An expression such as a + b - c * k is not computed when
+     * it is written; instead, the operators build a small tree
+     * of expression objects which is evaluated component by
+     * component, in a single loop, once it is assigned to a
+     * Vector. No intermediate vectors are allocated.
+     *
+     * The operators return these expression objects, not vectors:
+     * to call a Vector member on a result, construct a Vector from
+     * it first, e.g. Vector(a + b).norm(). Expressions reference
+     * their named operands, so an expression stored with auto must
+     * not outlive them; temporary vectors (e.g. f() + b) are moved
+     * into the expression instead, which then cannot be copied.
+     *
+     * @tparam E The concrete expression type (CRTP).
+    */
+    template <typename E>
+    class VectorExpression
+    {
+    public:
+        /**
+         * Obtain the concrete expression object.
+         *
+         * @return The expression, as its concrete type.
+        */
+        const E& self() const
+        {
+            return static_cast<const E&>(*this);
+        }
+
+        /**
+         * Return the size of the vector which this
+         * expression evaluates to.
+         *
+         * @return The size of the expression.
+        */
+        size_t get_size() const
+        {
+            return self().get_size();
+        }
+
+        /**
+         * Evaluate the i-th component of the expression.
+         * No bounds checking is performed.
+         *
+         * @param index The component which shall be evaluated.
+         * @return The value of the component.
+        */
+        double operator[](size_t index) const
+        {
+            return self()[index];
+        }
+    };
+
+    /**
+     * Leaf of an expression tree, referencing the entries
+     * of an already existing vector.
+    */
+    class VectorReference : public VectorExpression<VectorReference>
+    {
+    private:
+        const double* entries;
+        size_t size;
+
+    public:
+        VectorReference(const double* entries, size_t size) : entries(entries), size(size)
+        {
+
+        }
+
+        size_t get_size() const
+        {
+            return this->size;
+        }
+
+        double operator[](size_t index) const
+        {
+            return this->entries[index];
+        }
+    };
+
+    /**
+     * Leaf of an expression tree, referencing strided entries
+     * in memory (e.g. those of a VectorView).
+    */
+    class StridedVectorReference : public VectorExpression<StridedVectorReference>
+    {
+    private:
+        const double* entries;
+        size_t size;
+        size_t stride;
+
+    public:
+        StridedVectorReference(const double* entries, size_t size, size_t stride)
+            : entries(entries), size(size), stride(stride)
+        {
+
+        }
+
+        size_t get_size() const
+        {
+            return this->size;
+        }
+
+        double operator[](size_t index) const
+        {
+            return this->entries[index * this->stride];
+        }
+    };
+
+    /**
+     * Component-wise sum of two expressions.
+    */
+    template <typename L, typename R>
+    class VectorSum : public VectorExpression<VectorSum<L, R>>
+    {
+    private:
+        L lhs;
+        R rhs;
+
+    public:
+        VectorSum(L lhs, R rhs) : lhs(std::move(lhs)), rhs(std::move(rhs))
+        {
+            if (this->lhs.get_size() != this->rhs.get_size())
+            {
+                throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+            }
+        }
+
+        size_t get_size() const
+        {
+            return this->lhs.get_size();
+        }
+
+        double operator[](size_t index) const
+        {
+            return this->lhs[index] + this->rhs[index];
+        }
+    };
+
+    /**
+     * Component-wise difference of two expressions.
+    */
+    template <typename L, typename R>
+    class VectorDifference : public VectorExpression<VectorDifference<L, R>>
+    {
+    private:
+        L lhs;
+        R rhs;
+
+    public:
+        VectorDifference(L lhs, R rhs) : lhs(std::move(lhs)), rhs(std::move(rhs))
+        {
+            if (this->lhs.get_size() != this->rhs.get_size())
+            {
+                throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+            }
+        }
+
+        size_t get_size() const
+        {
+            return this->lhs.get_size();
+        }
+
+        double operator[](size_t index) const
+        {
+            return this->lhs[index] - this->rhs[index];
+        }
+    };
+
+    /**
+     * An expression multiplied by a real parameter.
+    */
+    template <typename E>
+    class ScaledVector : public VectorExpression<ScaledVector<E>>
+    {
+    private:
+        E expression;
+        double lambda;
+
+    public:
+        ScaledVector(E expression, double lambda) : expression(std::move(expression)), lambda(lambda)
+        {
+
+        }
+
+        size_t get_size() const
+        {
+            return this->expression.get_size();
+        }
+
+        double operator[](size_t index) const
+        {
+            return this->lambda * this->expression[index];
+        }
+    };
+
+    /**
+     * Trait marking the types which may appear as operands
+     * of the vector operators. Every expression qualifies;
+     * containers (such as Vector) opt in by specializing this
+     * trait and providing an as_expression overload.
+    */
+    template <typename T>
+    struct is_vector_operand : std::is_base_of<VectorExpression<T>, T>
+    {
+
+    };
+
+    /**
+     * Turn an expression into an operand, which is a no-op.
+     *
+     * @param expression The expression.
+     * @return The same expression, as its concrete type.
+    */
+    template <typename E>
+    const E& as_expression(const VectorExpression<E>& expression)
+    {
+        return expression.self();
+    }
+
+    /**
+     * Turn a temporary expression into an operand, moving it
+     * (and whatever temporaries it owns) into the new one.
+     *
+     * @param expression The expression.
+     * @return The same expression, as its concrete type.
+    */
+    template <typename E>
+    E&& as_expression(VectorExpression<E>&& expression)
+    {
+        return static_cast<E&&>(expression);
+    }
+
+    // The type of the operand built from T, where T is deduced
+    // from a forwarding reference (i.e. is an lvalue reference
+    // for named operands).
+    template <typename T>
+    using expression_type = typename std::decay<decltype(as_expression(std::declval<T>()))>::type;
+
+    template <typename L, typename R>
+    using enable_if_vector_operands = typename std::enable_if<
+        is_vector_operand<typename std::decay<L>::type>::value
+        && is_vector_operand<typename std::decay<R>::type>::value
+    >::type;
+
+    /**
+     * Operator overloading for vector addition. The sum
+     * is evaluated lazily, once assigned to a vector.
+     *
+     * @param lhs The left operand.
+     * @param rhs The right operand.
+     * @return An expression representing the sum of
+     * the two vectors.
+    */
+    template <typename L, typename R, typename = enable_if_vector_operands<L, R>>
+    VectorSum<expression_type<L>, expression_type<R>> operator+(L&& lhs, R&& rhs)
+    {
+        return VectorSum<expression_type<L>, expression_type<R>>(
+            as_expression(std::forward<L>(lhs)),
+            as_expression(std::forward<R>(rhs))
+        );
+    }
+
+    /**
+     * Operator overloading for vector subtraction. The
+     * difference is evaluated lazily, once assigned to a vector.
+     *
+     * @param lhs The left operand.
+     * @param rhs The right operand.
+     * @return An expression representing the difference
+     * of the two vectors.
+    */
+    template <typename L, typename R, typename = enable_if_vector_operands<L, R>>
+    VectorDifference<expression_type<L>, expression_type<R>> operator-(L&& lhs, R&& rhs)
+    {
+        return VectorDifference<expression_type<L>, expression_type<R>>(
+            as_expression(std::forward<L>(lhs)),
+            as_expression(std::forward<R>(rhs))
+        );
+    }
+
+    /**
+     * Multiply the given vector by the said real parameter.
+     * The product is evaluated lazily, once assigned to a vector.
+     *
+     * @param vec The vector which shall be scaled.
+     * @param lambda The amount by which the vector
+     * should be scaled.
+     * @return An expression representing the scaled vector.
+    */
+    template <typename V, typename = typename std::enable_if<is_vector_operand<typename std::decay<V>::type>::value>::type>
+    ScaledVector<expression_type<V>> operator*(V&& vec, double lambda)
+    {
+        return ScaledVector<expression_type<V>>(as_expression(std::forward<V>(vec)), lambda);
+    }
+}
+
+#endif
@@ -0,0 +1,199 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "vector_view.h"
+#include "simd.h"
+#include "norm.h"
+#include "predicates.h"
+#include "../exception/illegal_access_exception.h"
+#include "../exception/different_size_exception.h"
+#include "../exception/illegal_size_exception.h"
+#include "../exception/messages.h"
+#include <cmath>
+#include <string>
+
+thmath::VectorView::VectorView(const double* entries, const size_t size, const size_t stride)
+    : entries(entries), size(size), stride(stride)
+{
+    if (stride == 0)
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+}
+
+thmath::VectorView::VectorView(const Vector& vec) : entries(vec.get_entries()), size(vec.get_size()), stride(1)
+{
+
+}
+
+double thmath::VectorView::get_component(const size_t index) const
+{
+    if (index >= this->size)
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    return this->entries[index * this->stride];
+}
+
+const double* thmath::VectorView::get_entries() const
+{
+    return this->entries;
+}
+
+size_t thmath::VectorView::get_size() const
+{
+    return this->size;
+}
+
+size_t thmath::VectorView::get_stride() const
+{
+    return this->stride;
+}
+
+bool thmath::VectorView::is_contiguous() const
+{
+    return this->stride == 1;
+}
+
+thmath::VectorView thmath::VectorView::subview(const size_t offset, const size_t size, const size_t stride) const
+{
+    if (size > 0 && offset + (size - 1) * stride >= this->size)
+    {
+        throw IllegalAccessException(ILLEGAL_ACCESS_MESSAGE);
+    }
+    return VectorView(this->entries + offset * this->stride, size, stride * this->stride);
+}
+
+thmath::Vector thmath::VectorView::to_vector() const
+{
+    return Vector(as_expression(*this));
+}
+
+double thmath::VectorView::norm(double p) const
+{
+    return norms::lp(this->entries, this->size, p, this->stride);
+}
+
+double thmath::VectorView::norm() const
+{
+    return norms::l2(this->entries, this->size, this->stride);
+}
+
+double thmath::VectorView::infinity_norm() const
+{
+    return norms::infinity(this->entries, this->size, this->stride);
+}
+
+double thmath::VectorView::dot_product(const VectorView& view) const
+{
+    if (this->size != view.size)
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    if (is_contiguous() && view.is_contiguous())
+    {
+        return simd::dot(this->entries, view.entries, this->size);
+    }
+    double result = 0.0;
+    for (size_t index = 0; index < this->size; index++)
+    {
+        result += (*this)[index] * view[index];
+    }
+    return result;
+}
+
+thmath::Vector thmath::VectorView::vector_product(const VectorView& view) const
+{
+    if (this->size != view.size || this->size > 3 || this->size < 2)
+    {
+        throw IllegalSizeException(ILLEGAL_SIZE_MESSAGE);
+    }
+    if (this->size == 2)
+    {
+        double z = (*this)[0] * view[1] - (*this)[1] * view[0];
+        return Vector{0, 0, z};
+    }
+    double x = (*this)[1] * view[2] - (*this)[2] * view[1];
+    double y = -((*this)[0] * view[2] - (*this)[2] * view[0]);
+    double z = (*this)[0] * view[1] - (*this)[1] * view[0];
+    return Vector{x, y, z};
+}
+
+double thmath::VectorView::angle(const VectorView& view, bool cosine) const
+{
+    if (this->size != view.size)
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    double cos = dot_product(view) / (norm() * view.norm());
+    return cosine ? cos : std::acos(cos);
+}
+
+bool thmath::VectorView::is_parallel(const VectorView& view) const
+{
+    if (this->size != view.size)
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    return predicates::parallel(this->entries, view.entries, this->size, this->stride, view.stride);
+}
+
+bool thmath::VectorView::is_perpendicular(const VectorView& view) const
+{
+    if (this->size != view.size)
+    {
+        throw DifferentSizeException(DIFFERENT_SIZE_MESSAGE);
+    }
+    return predicates::perpendicular(this->entries, view.entries, this->size, this->stride, view.stride);
+}
+
+bool thmath::VectorView::operator==(const VectorView& view) const
+{
+    if (this->size != view.size)
+    {
+        return false;
+    }
+    for (size_t index = 0; index < this->size; index++)
+    {
+        if ((*this)[index] != view[index])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string thmath::VectorView::to_string() const
+{
+    std::string s = "Vector={size=" + std::to_string(this->size) + ", elements=[";
+    for (size_t index = 0; index < this->size; index++)
+    {
+        if (index > 0)
+        {
+            s += ", ";
+        }
+        s += std::to_string((*this)[index]);
+    }
+    s += "]}";
+    return s;
+}
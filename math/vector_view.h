@@ -0,0 +1,253 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifndef __THMATH_VECTOR_VIEW_
+#define __THMATH_VECTOR_VIEW_
+
+#include "vector.h"
+#include "vector_expression.h"
+#include <string>
+
+namespace thmath
+{
+    /**
+     * Non-owning, read-only view of n doubles in memory,
+     * optionally strided (the i-th component is found at
+     * entries[i * stride]). A view never copies nor frees the
+     * entries; it can be borrowed from a Vector, or placed over
+     * any foreign buffer (e.g. a memory-mapped file), which must
+     * outlive it.
+     *
+     * Views support the same algorithms as Vector, and can be
+     * used as operands of the vector operators, e.g.
+     * Vector sum = view_a + view_b * 2.
+    */
+    class VectorView
+    {
+    private:
+        const double* entries;
+        size_t size;
+        size_t stride;
+
+    public:
+        /**
+         * Constructor for the VectorView class, over
+         * foreign memory.
+         *
+         * @param entries The first component.
+         * @param size The number of components.
+         * @param stride The distance (in doubles) between
+         * two consecutive components.
+         * @return A new view object.
+        */
+        VectorView(const double* entries, const size_t size, const size_t stride = 1);
+
+        /**
+         * Borrow a view of all the entries of a vector. The
+         * view is invalidated once the vector is resized or
+         * destroyed.
+         *
+         * @param vec The vector which is viewed.
+         * @return A new view object.
+        */
+        VectorView(const Vector& vec);
+
+        /**
+         * Obtain the i-th component of the view.
+         *
+         * @param index The index which we are interested
+         * in retrieving
+         * @return The component at the i-th position.
+        */
+        double get_component(const size_t index) const;
+
+        /**
+         * Unchecked access to the i-th component.
+         *
+         * @param index The index of the component.
+         * @return The component at the i-th position.
+        */
+        double operator[](const size_t index) const
+        {
+            return this->entries[index * this->stride];
+        }
+
+        /**
+         * Obtain a pointer to the first component.
+         *
+         * @return The first component of the view.
+        */
+        const double* get_entries() const;
+
+        /**
+         * Return the number of components in the view.
+         *
+         * @return The size of the view.
+        */
+        size_t get_size() const;
+
+        /**
+         * Return the distance, in doubles, between
+         * two consecutive components.
+         *
+         * @return The stride of the view.
+        */
+        size_t get_stride() const;
+
+        /**
+         * Return whether the components are contiguous
+         * in memory, i.e. whether the stride is 1.
+         *
+         * @return Whether the view is contiguous.
+        */
+        bool is_contiguous() const;
+
+        /**
+         * Obtain a view of a part of this view.
+         *
+         * @param offset The index of the first component.
+         * @param size The number of components.
+         * @param stride The stride, relative to this view.
+         * @return A new view object.
+        */
+        VectorView subview(const size_t offset, const size_t size, const size_t stride = 1) const;
+
+        /**
+         * Copy the viewed components into a new vector.
+         *
+         * @return A new vector object.
+        */
+        Vector to_vector() const;
+
+        /**
+         * Compute the Lp norm of the viewed components.
+         *
+         * @param p The real parameter for which we want to
+         * compute the norm
+         * @return The norm.
+        */
+        double norm(double p) const;
+
+        /**
+         * Compute the Euclidian (L2) norm of the viewed components.
+         *
+         * @return The Euclidian (L2) norm.
+        */
+        double norm() const;
+
+        /**
+         * Compute the infinity-norm of the viewed components.
+         *
+         * @return The infinity norm.
+        */
+        double infinity_norm() const;
+
+        /**
+         * Perform the dot product between two views.
+         *
+         * @param view The other view.
+         * @return The scalar product of the two views.
+        */
+        double dot_product(const VectorView& view) const;
+
+        /**
+         * Perform the vector product (cross product) between
+         * two views of 2 or 3 components, as Vector::vector_product.
+         *
+         * @param view The view which we are crossing with
+         * the current one.
+         * @return A new vector object representing the cross
+         * product between the two views.
+        */
+        Vector vector_product(const VectorView& view) const;
+
+        /**
+         * Return the angle between two views, defined
+         * as the dot product over the product of L2 norms.
+         *
+         * @param view The other view.
+         * @param cosine Whether or not the cosine shall
+         * be returned instead of the angle.
+         * @return The angle between the two views.
+        */
+        double angle(const VectorView& view, bool cosine = false) const;
+
+        /**
+         * Check whether or not the two views are parallel,
+         * i.e. whether one is exactly a multiple of the other
+         * (see predicates::parallel).
+         *
+         * @param view The other view.
+         * @return Whether or not they are parallel.
+        */
+        bool is_parallel(const VectorView& view) const;
+
+        /**
+         * Check whether or not the two views are perpendicular,
+         * i.e. whether their scalar product is exactly null
+         * (see predicates::perpendicular).
+         *
+         * @param view The other view.
+         * @return Whether or not they are perpendicular.
+        */
+        bool is_perpendicular(const VectorView& view) const;
+
+        /**
+         * Check whether the viewed components are equal.
+         *
+         * @param view The other view.
+         * @return Whether or not the two views are equal
+         * component-wise.
+        */
+        bool operator==(const VectorView& view) const;
+
+        /**
+         * Stringify the view, in the same format as
+         * Vector::to_string.
+         *
+         * @return The stringified version of the view.
+        */
+        std::string to_string() const;
+    };
+
+    template <>
+    struct is_vector_operand<VectorView> : std::true_type
+    {
+
+    };
+
+    /**
+     * Turn a view into an expression operand.
+     *
+     * @param view The view.
+     * @return A leaf expression referencing the viewed entries.
+    */
+    inline StridedVectorReference as_expression(const VectorView& view)
+    {
+        return StridedVectorReference(view.get_entries(), view.get_size(), view.get_stride());
+    }
+}
+
+#endif
@@ -0,0 +1,258 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Checks every convolution method against the naive sums: DIRECT,
+// FFT, the blocked FFT path taken for real signals much longer than
+// the kernel, and StreamingConvolver with overlap-add and
+// overlap-save, kernels longer than the block included.
+
+#include "../math/convolution.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using thmath::Complex;
+    using thmath::ConvolutionMethod;
+    using thmath::StreamingConvolver;
+    using thmath::StreamingMethod;
+
+    const double EPSILON = std::numeric_limits<double>::epsilon();
+
+    // (signal size, kernel size). With the kernels of 31 and 100
+    // values, the longer signals take the blocked FFT path (more than
+    // two blocks of 226 and 413 samples); the others one transform.
+    const size_t SIZES[][2] = {
+        {1, 1}, {5, 3}, {3, 5}, {64, 64}, {100, 7}, {300, 31}, {452, 31},
+        {453, 31}, {1000, 31}, {1001, 100}, {5000, 100}, {2000, 600}, {20000, 600}
+    };
+
+    // (kernel size, block size) of the streaming cases.
+    const size_t STREAMING_SIZES[][2] = {
+        {1, 16}, {3, 1}, {5, 16}, {16, 16}, {17, 16}, {50, 16}, {100, 7}, {257, 64}
+    };
+
+    const size_t STREAMING_BLOCKS[] = {1, 2, 10, 40};
+
+    int failures = 0;
+
+    void check(bool condition, const char* name, size_t signal_size, size_t kernel_size, double error)
+    {
+        if (!condition)
+        {
+            std::printf("FAILED: %s, sizes %zu and %zu, error %g\n", name, signal_size, kernel_size, error);
+            failures++;
+        }
+    }
+
+    double magnitude(double value)
+    {
+        return std::fabs(value);
+    }
+
+    double magnitude(const Complex& value)
+    {
+        return std::hypot(value.get_real(), value.get_imaginary());
+    }
+
+    double conjugate(double value)
+    {
+        return value;
+    }
+
+    Complex conjugate(const Complex& value)
+    {
+        return value.conjugate();
+    }
+
+    double random_value(std::mt19937_64& generator, double)
+    {
+        return std::uniform_real_distribution<double>(-1.0, 1.0)(generator);
+    }
+
+    Complex random_value(std::mt19937_64& generator, const Complex&)
+    {
+        std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+        double real = distribution(generator);
+        return Complex(real, distribution(generator));
+    }
+
+    template <typename T>
+    std::vector<T> make_data(size_t size, std::mt19937_64& generator)
+    {
+        std::vector<T> data(size);
+        for (T& value : data)
+        {
+            value = random_value(generator, T());
+        }
+        return data;
+    }
+
+    template <typename T>
+    std::vector<T> naive_convolve(const std::vector<T>& signal, const std::vector<T>& kernel)
+    {
+        std::vector<T> result(signal.size() + kernel.size() - 1, T());
+        for (size_t i = 0; i < signal.size(); i++)
+        {
+            for (size_t j = 0; j < kernel.size(); j++)
+            {
+                result[i + j] += signal[i] * kernel[j];
+            }
+        }
+        return result;
+    }
+
+    // c[k + m - 1] = sum(a[j + k] conj(b[j])), i.e. the convolution
+    // with the reversed, conjugated kernel.
+    template <typename T>
+    std::vector<T> naive_correlate(const std::vector<T>& signal, const std::vector<T>& kernel)
+    {
+        std::vector<T> reversed(kernel.size());
+        for (size_t j = 0; j < kernel.size(); j++)
+        {
+            reversed[j] = conjugate(kernel[kernel.size() - 1 - j]);
+        }
+        return naive_convolve(signal, reversed);
+    }
+
+    template <typename T>
+    double l2(const std::vector<T>& values)
+    {
+        double sum = 0.0;
+        for (const T& value : values)
+        {
+            sum += magnitude(value) * magnitude(value);
+        }
+        return std::sqrt(sum);
+    }
+
+    // The largest error in units of EPSILON |a| |b|, the scale of the
+    // error of the transforms (and a bound on every output).
+    template <typename T>
+    double relative_error(const T* result, size_t size, const std::vector<T>& reference, double scale)
+    {
+        if (size != reference.size())
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+        double error = 0.0;
+        for (size_t k = 0; k < size; k++)
+        {
+            error = std::max(error, magnitude(result[k] - reference[k]));
+        }
+        return error / (EPSILON * scale);
+    }
+
+    // Both the naive sums and the transforms round by a few EPSILON
+    // per term or per stage.
+    double tolerance(size_t signal_size, size_t kernel_size)
+    {
+        double size = static_cast<double>(signal_size + kernel_size);
+        return 2.0 * std::sqrt(static_cast<double>(std::min(signal_size, kernel_size))) + 8.0 * std::log2(size) + 8.0;
+    }
+
+    template <typename T>
+    void test_batch(std::mt19937_64& generator, const char* type)
+    {
+        const ConvolutionMethod METHODS[] = {ConvolutionMethod::AUTOMATIC, ConvolutionMethod::DIRECT, ConvolutionMethod::FFT};
+        const char* NAMES[] = {"automatic", "direct", "fft"};
+        char name[64];
+        for (const auto& sizes : SIZES)
+        {
+            std::vector<T> signal = make_data<T>(sizes[0], generator);
+            std::vector<T> kernel = make_data<T>(sizes[1], generator);
+            std::vector<T> convolution = naive_convolve(signal, kernel);
+            std::vector<T> correlation = naive_correlate(signal, kernel);
+            double scale = l2(signal) * l2(kernel);
+            double bound = tolerance(sizes[0], sizes[1]);
+            for (size_t method = 0; method < 3; method++)
+            {
+                std::vector<T> result = thmath::convolution::convolve(signal, kernel, METHODS[method]);
+                double error = relative_error(result.data(), result.size(), convolution, scale);
+                std::snprintf(name, sizeof(name), "convolve %s %s", type, NAMES[method]);
+                check(error <= bound, name, sizes[0], sizes[1], error);
+
+                result = thmath::convolution::correlate(signal, kernel, METHODS[method]);
+                error = relative_error(result.data(), result.size(), correlation, scale);
+                std::snprintf(name, sizeof(name), "correlate %s %s", type, NAMES[method]);
+                check(error <= bound, name, sizes[0], sizes[1], error);
+            }
+        }
+        std::vector<T> empty;
+        std::vector<T> some = make_data<T>(5, generator);
+        check(thmath::convolution::convolve(empty, some).empty(), "convolve empty", 0, 5, 0.0);
+        check(thmath::convolution::correlate(some, empty).empty(), "correlate empty", 5, 0, 0.0);
+    }
+
+    // Feeds the signal block by block, every block but the first in
+    // place, then flushes; twice, since flush() resets the convolver.
+    void test_streaming(std::mt19937_64& generator, StreamingMethod method, const char* name)
+    {
+        for (const auto& sizes : STREAMING_SIZES)
+        {
+            size_t kernel_size = sizes[0];
+            size_t block_size = sizes[1];
+            std::vector<double> kernel = make_data<double>(kernel_size, generator);
+            StreamingConvolver convolver(kernel, block_size, method);
+            check(convolver.get_fft_size() >= block_size + kernel_size - 1, name, block_size, kernel_size, 0.0);
+            for (size_t blocks : STREAMING_BLOCKS)
+            {
+                for (int run = 0; run < 2; run++)
+                {
+                    std::vector<double> signal = make_data<double>(blocks * block_size, generator);
+                    std::vector<double> reference = naive_convolve(signal, kernel);
+                    std::vector<double> output(signal.size() + kernel_size - 1, 0.0);
+                    std::copy(signal.begin(), signal.end(), output.begin());
+                    for (size_t block = 0; block < blocks; block++)
+                    {
+                        const double* input = block == 0 ? signal.data() : output.data() + block * block_size;
+                        convolver.process(input, output.data() + block * block_size);
+                    }
+                    convolver.flush(output.data() + blocks * block_size);
+                    double error = relative_error(output.data(), output.size(), reference, l2(signal) * l2(kernel));
+                    check(error <= tolerance(signal.size(), kernel_size), name, signal.size(), kernel_size, error);
+                }
+            }
+        }
+    }
+}
+
+int main()
+{
+    std::mt19937_64 generator(17);
+    test_batch<double>(generator, "real");
+    test_batch<Complex>(generator, "complex");
+    test_streaming(generator, StreamingMethod::OVERLAP_ADD, "overlap-add");
+    test_streaming(generator, StreamingMethod::OVERLAP_SAVE, "overlap-save");
+    if (failures > 0)
+    {
+        std::printf("%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("all checks passed\n");
+    return 0;
+}
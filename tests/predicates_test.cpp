@@ -0,0 +1,270 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Checks the exact predicates, and the Line and Vector tests built on
+// them, on inputs where plain floating point gets the sign wrong.
+// The expected answers come from exact integer arithmetic: every
+// coordinate is an integer below 2^30, so every product fits in 64
+// bits while most of them do not fit in a double.
+
+#include "../math/line.h"
+#include "../math/predicates.h"
+#include "../math/vector.h"
+#include "../math/vector_view.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+    using thmath::Line;
+    using thmath::Vec2;
+    using thmath::Vec3;
+    using thmath::Vector;
+    using thmath::VectorView;
+
+    // Coordinates of the random integer cases are below 2^COORDINATE_BITS.
+    const int COORDINATE_BITS = 29;
+
+    const int RANDOM_CASES = 100000;
+
+    int failures = 0;
+
+    void check(bool condition, const char* name, int index)
+    {
+        if (!condition)
+        {
+            std::printf("FAILED: %s, case %d\n", name, index);
+            failures++;
+        }
+    }
+
+    template <typename T>
+    int sign(T value)
+    {
+        return (value > 0) - (value < 0);
+    }
+
+    int64_t coordinate(std::mt19937_64& generator)
+    {
+        return static_cast<int64_t>(generator() >> (64 - COORDINATE_BITS)) - (int64_t(1) << (COORDINATE_BITS - 1));
+    }
+
+    // -1, 0 or 1, so that about a third of the cases are exact.
+    int64_t nudge(std::mt19937_64& generator)
+    {
+        return static_cast<int64_t>(generator() % 3) - 1;
+    }
+
+    Vec3 to_vec3(const int64_t* point)
+    {
+        return Vec3(static_cast<double>(point[0]), static_cast<double>(point[1]), static_cast<double>(point[2]));
+    }
+
+    // Shewchuk's example: a walks a 256 x 256 grid of doubles around
+    // (0.5, 0.5), b = (12, 12) and c = (24, 24). The exact determinant
+    // is 12 (a_y - a_x), whose sign is that of j - i, but the naive
+    // formula gets a large part of the grid wrong.
+    void test_orient2d()
+    {
+        const double ulp = std::ldexp(1.0, -53);
+        const Vec2 b(12.0, 12.0);
+        const Vec2 c(24.0, 24.0);
+        for (int i = 0; i < 256; i++)
+        {
+            for (int j = 0; j < 256; j++)
+            {
+                Vec2 a(0.5 + i * ulp, 0.5 + j * ulp);
+                check(sign(thmath::predicates::orient2d(a, b, c)) == sign(j - i), "orient2d grid", i * 256 + j);
+            }
+        }
+    }
+
+    // The same walk in R^3: a, b and c lie on the plane z = x, far from
+    // the origin, and d = (0.5 + i ulp, 0.25, 0.5 + k ulp), so d lies
+    // on the plane exactly when i = k, and on either side otherwise.
+    void test_orient3d()
+    {
+        const double ulp = std::ldexp(1.0, -53);
+        const Vec3 a(12.0, 3.0, 12.0);
+        const Vec3 b(24.0, -7.0, 24.0);
+        const Vec3 c(-5.0, 17.0, -5.0);
+        // The side of z > x, where the answer is not in doubt.
+        const int above = sign(thmath::predicates::orient3d(a, b, c, Vec3(0.0, 0.0, 100.0)));
+        check(above != 0, "orient3d reference", 0);
+        for (int i = 0; i < 256; i++)
+        {
+            for (int k = 0; k < 256; k++)
+            {
+                Vec3 d(0.5 + i * ulp, 0.25, 0.5 + k * ulp);
+                check(sign(thmath::predicates::orient3d(a, b, c, d)) == above * sign(k - i), "orient3d grid", i * 256 + k);
+            }
+        }
+    }
+
+    // A point p = o + m d, nudged by at most one unit per coordinate.
+    void test_collinear(std::mt19937_64& generator)
+    {
+        for (int test = 0; test < RANDOM_CASES; test++)
+        {
+            int64_t origin[3], direction[3], point[3], end[3];
+            int64_t multiple = static_cast<int64_t>(generator() % 7) - 3;
+            for (int k = 0; k < 3; k++)
+            {
+                origin[k] = coordinate(generator);
+                direction[k] = coordinate(generator);
+                point[k] = origin[k] + multiple * direction[k] + nudge(generator);
+                end[k] = origin[k] + direction[k];
+            }
+            bool expected = true;
+            for (int k = 0; k < 3; k++)
+            {
+                int n = (k + 1) % 3;
+                int l = (k + 2) % 3;
+                if ((point[n] - origin[n]) * direction[l] != (point[l] - origin[l]) * direction[n])
+                {
+                    expected = false;
+                }
+            }
+            Vec3 o = to_vec3(origin);
+            Vec3 p = to_vec3(point);
+            check(thmath::predicates::on_line(o, to_vec3(direction), p) == expected, "on_line", test);
+            check(thmath::predicates::collinear(o, to_vec3(end), p) == expected, "collinear", test);
+        }
+    }
+
+    // v = m u, nudged; w has w . u = 0 exactly, unless nudged,
+    // through a third component of u that is a power of two.
+    void test_parallel_perpendicular(std::mt19937_64& generator)
+    {
+        const int64_t SHIFT = 10;
+        for (int test = 0; test < RANDOM_CASES; test++)
+        {
+            int64_t u[3], v[3], w[3];
+            int64_t multiple = static_cast<int64_t>(generator() % 7) + 1;
+            for (int k = 0; k < 3; k++)
+            {
+                u[k] = coordinate(generator);
+                v[k] = multiple * u[k] + nudge(generator);
+            }
+            bool parallel = true;
+            for (int i = 0; i < 3; i++)
+            {
+                for (int j = i + 1; j < 3; j++)
+                {
+                    if (u[i] * v[j] != u[j] * v[i])
+                    {
+                        parallel = false;
+                    }
+                }
+            }
+            double ud[3] = {static_cast<double>(u[0]), static_cast<double>(u[1]), static_cast<double>(u[2])};
+            double vd[3] = {static_cast<double>(v[0]), static_cast<double>(v[1]), static_cast<double>(v[2])};
+            check(thmath::predicates::parallel(ud, vd, 3) == parallel, "parallel", test);
+
+            u[0] = coordinate(generator);
+            u[1] = coordinate(generator);
+            u[2] = int64_t(1) << SHIFT;
+            w[0] = (coordinate(generator) >> SHIFT) << SHIFT;
+            w[1] = (coordinate(generator) >> SHIFT) << SHIFT;
+            w[2] = -((u[0] * w[0] + u[1] * w[1]) >> SHIFT) + nudge(generator);
+            bool perpendicular = u[0] * w[0] + u[1] * w[1] + u[2] * w[2] == 0;
+            double pu[3] = {static_cast<double>(u[0]), static_cast<double>(u[1]), static_cast<double>(u[2])};
+            double pw[3] = {static_cast<double>(w[0]), static_cast<double>(w[1]), static_cast<double>(w[2])};
+            check(thmath::predicates::perpendicular(pu, pw, 3) == perpendicular, "perpendicular", test);
+        }
+    }
+
+    // A line holds both of its points and is parallel to itself the
+    // other way around, whatever rounding b - a suffered.
+    void test_line(std::mt19937_64& generator)
+    {
+        std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+        for (int test = 0; test < RANDOM_CASES; test++)
+        {
+            Vec3 a(distribution(generator), distribution(generator), distribution(generator));
+            Vec3 b(distribution(generator) * 1e6, distribution(generator), distribution(generator) * 1e-6);
+            Line line(a, b);
+            Line reversed(b, a);
+            check(line.contains(a), "Line contains a", test);
+            check(line.contains(b), "Line contains b", test);
+            check(line.is_parallel(reversed), "Line is_parallel reversed", test);
+            check(line == reversed, "Line == reversed", test);
+        }
+        Line decimal(Vec3(0.1, 0.2, 0.3), Vec3(0.4, 0.5, 0.6));
+        check(decimal.contains(Vec3(0.4, 0.5, 0.6)), "Line decimal contains b", 0);
+        check(!decimal.contains(Vec3(0.4, 0.5, std::nextafter(0.6, 1.0))), "Line decimal misses b + ulp", 0);
+        check(Line(Vector{0.1, 0.2}, Vector{0.7, 0.3}).contains(Vector{0.7, 0.3}), "Line in the plane contains b", 0);
+    }
+
+    // 0.1, 0.2 and 0.3 are not representable, but doubling is exact,
+    // so {0.2, 0.4, 0.6} is exactly twice {0.1, 0.2, 0.3}, although
+    // |x . y| and |x| |y| differ after rounding.
+    void test_vector()
+    {
+        Vector x{0.1, 0.2, 0.3};
+        check(x.is_parallel(Vector{0.2, 0.4, 0.6}), "Vector is_parallel 2x", 0);
+        check(x.is_parallel(Vector{-0.025, -0.05, -0.075}), "Vector is_parallel -x/4", 0);
+        check(x.is_parallel(x), "Vector is_parallel x", 0);
+        check(!x.is_parallel(Vector{0.2, 0.4, std::nextafter(0.6, 1.0)}), "Vector not is_parallel 2x + ulp", 0);
+
+        // (2^27 + 1)^2 rounds to 2^54 + 2^28, so the naive dot product
+        // is -1 rather than 0.
+        const double big = std::ldexp(1.0, 27);
+        Vector u{big + 1.0, big, 1.0};
+        check(u.is_perpendicular(Vector{big + 1.0, -(big + 2.0), -1.0}), "Vector is_perpendicular", 0);
+        check(!u.is_perpendicular(Vector{big + 1.0, -(big + 2.0), -2.0}), "Vector not is_perpendicular", 0);
+        check(Vector{0.1, 0.2, 0.0}.is_perpendicular(Vector{0.2, -0.1, 0.7}), "Vector is_perpendicular decimal", 0);
+
+        // The same vectors, interleaved, through strided views.
+        const double interleaved[] = {0.1, 0.2, 0.2, 0.4, 0.3, 0.6};
+        const double nudged[] = {0.1, 0.2, 0.2, 0.4, 0.3, std::nextafter(0.6, 1.0)};
+        VectorView first(interleaved, 3, 2);
+        VectorView second(interleaved + 1, 3, 2);
+        VectorView skewed(nudged + 1, 3, 2);
+        check(first.is_parallel(second), "VectorView is_parallel 2x", 0);
+        check(second.is_parallel(VectorView(x)), "VectorView is_parallel x", 0);
+        check(!first.is_parallel(skewed), "VectorView not is_parallel 2x + ulp", 0);
+        check(first.vector_product(skewed) == x.vector_product(Vector{0.2, 0.4, std::nextafter(0.6, 1.0)}), "VectorView vector_product", 0);
+        check(VectorView(interleaved, 2, 2).vector_product(VectorView(interleaved + 1, 2, 2)) == Vector{0.0, 0.0, 0.0}, "VectorView vector_product in the plane", 0);
+    }
+}
+
+int main()
+{
+    std::mt19937_64 generator(2024);
+    test_orient2d();
+    test_orient3d();
+    test_collinear(generator);
+    test_parallel_perpendicular(generator);
+    test_line(generator);
+    test_vector();
+    if (failures > 0)
+    {
+        std::printf("%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("all checks passed\n");
+    return 0;
+}
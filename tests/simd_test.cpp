@@ -0,0 +1,236 @@
+/*
+ * This file is part of thmath.
+ *
+ * Developed for the the thmath Mathematics Library.
+ * This product includes software developed by Mihnea Morarescu and
+ * all affiliated contributors of thmath.
+ * See the COPYRIGHT file at the top-level directory of this distribution
+ * for details of code ownership.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+// Checks every SIMD kernel of every instruction set against the scalar
+// one, within the accuracy bounds documented in math/simd.h.
+
+#include "../math/simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using thmath::simd::InstructionSet;
+
+    const double EPSILON = std::numeric_limits<double>::epsilon();
+
+    // Sizes around every vector width and unrolling factor, plus a
+    // few long ones.
+    const size_t SIZES[] = {
+        0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33,
+        63, 64, 65, 100, 127, 128, 129, 1000, 1023, 4099
+    };
+
+    // Up to 9 others, i.e. more than one block of multi_dot.
+    const size_t MAX_OTHERS = 9;
+
+    int failures = 0;
+
+    void check(bool condition, const char* kernel, InstructionSet instruction_set, size_t size)
+    {
+        if (!condition)
+        {
+            std::printf("FAILED: %s, %s, size %zu\n", kernel, thmath::simd::to_string(instruction_set), size);
+            failures++;
+        }
+    }
+
+    struct Data
+    {
+        std::vector<double> a;
+        std::vector<double> b;
+        std::vector<std::vector<double>> others;
+    };
+
+    Data make_data(size_t size, std::mt19937_64& generator)
+    {
+        std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+        Data data;
+        data.a.resize(size);
+        data.b.resize(size);
+        data.others.assign(MAX_OTHERS, std::vector<double>(size));
+        for (size_t i = 0; i < size; i++)
+        {
+            data.a[i] = distribution(generator);
+            data.b[i] = distribution(generator);
+            for (std::vector<double>& other : data.others)
+            {
+                other[i] = distribution(generator);
+            }
+        }
+        return data;
+    }
+
+    // Compare the active kernels against the results of the scalar
+    // ones, recomputed here, on the arrays starting at offset.
+    void check_kernels(InstructionSet instruction_set, const Data& data, size_t offset)
+    {
+        using namespace thmath::simd;
+
+        const size_t size = data.a.size() - offset;
+        const double* a = data.a.data() + offset;
+        const double* b = data.b.data() + offset;
+        const double alpha = 0.75;
+        const double beta = -1.25;
+        const double lambda = 3.0 / 7.0;
+
+        // The in-place kernels run on copies, at the same offset.
+        std::vector<double> buffer(size + offset);
+        double* values = buffer.data() + offset;
+        auto load = [&](const double* source)
+        {
+            std::copy(source, source + size, values);
+        };
+        auto stored = [&]()
+        {
+            return std::vector<double>(values, values + size);
+        };
+
+        set_instruction_set(InstructionSet::SCALAR);
+        double scalar_dot = dot(a, b, size);
+        load(a);
+        scale(values, lambda, size);
+        std::vector<double> scalar_scaled = stored();
+        load(a);
+        add(values, b, size);
+        std::vector<double> scalar_sum = stored();
+        load(a);
+        subtract(values, b, size);
+        std::vector<double> scalar_difference = stored();
+        load(b);
+        axpby(values, alpha, a, beta, size);
+        std::vector<double> scalar_axpby = stored();
+
+        InstructionSet active = set_instruction_set(instruction_set);
+
+        // dot: within n * eps * sum(|a_i * b_i|) of the exact value,
+        // hence within twice that of the scalar result.
+        double magnitude = 0.0;
+        long double exact = 0.0L;
+        for (size_t i = 0; i < size; i++)
+        {
+            magnitude += std::abs(a[i] * b[i]);
+            exact += static_cast<long double>(a[i]) * b[i];
+        }
+        double bound = static_cast<double>(size) * EPSILON * magnitude;
+        double result = dot(a, b, size);
+        check(std::abs(result - static_cast<double>(exact)) <= bound, "dot (exact)", active, size);
+        check(std::abs(result - scalar_dot) <= 2.0 * bound, "dot", active, size);
+
+        // scale, add and subtract: bit-identical.
+        load(a);
+        scale(values, lambda, size);
+        check(stored() == scalar_scaled, "scale", active, size);
+        load(a);
+        add(values, b, size);
+        check(stored() == scalar_sum, "add", active, size);
+        load(a);
+        subtract(values, b, size);
+        check(stored() == scalar_difference, "subtract", active, size);
+
+        // axpby: within 2 * eps * (|alpha * x_i| + |beta * y_i|),
+        // and bit-identical where the product is rounded as well.
+        load(b);
+        axpby(values, alpha, a, beta, size);
+        bool close = true;
+        for (size_t i = 0; i < size; i++)
+        {
+            double terms = std::abs(alpha * a[i]) + std::abs(beta * b[i]);
+            if (active == InstructionSet::SCALAR || active == InstructionSet::SSE2)
+            {
+                close = close && values[i] == scalar_axpby[i];
+            }
+            else
+            {
+                close = close && std::abs(values[i] - scalar_axpby[i]) <= 2.0 * EPSILON * terms;
+            }
+        }
+        check(close, "axpby", active, size);
+
+        // dot_norms and multi_dot: bit-identical to dot.
+        double norms[3];
+        dot_norms(a, b, size, norms);
+        check(norms[0] == result, "dot_norms", active, size);
+        check(norms[1] == dot(a, a, size), "dot_norms", active, size);
+        check(norms[2] == dot(b, b, size), "dot_norms", active, size);
+
+        const double* others[MAX_OTHERS];
+        for (size_t k = 0; k < MAX_OTHERS; k++)
+        {
+            others[k] = data.others[k].data() + offset;
+        }
+        double products[MAX_OTHERS];
+        for (size_t count = 0; count <= MAX_OTHERS; count++)
+        {
+            multi_dot(a, others, count, size, products);
+            bool identical = true;
+            for (size_t k = 0; k < count; k++)
+            {
+                identical = identical && products[k] == dot(a, others[k], size);
+            }
+            check(identical, "multi_dot", active, size);
+        }
+    }
+}
+
+int main()
+{
+    const InstructionSet instruction_sets[] = {
+        InstructionSet::SCALAR,
+        InstructionSet::SSE2,
+        InstructionSet::AVX2,
+        InstructionSet::AVX512
+    };
+
+    std::mt19937_64 generator(20);
+    for (InstructionSet instruction_set : instruction_sets)
+    {
+        InstructionSet active = thmath::simd::set_instruction_set(instruction_set);
+        if (active != instruction_set)
+        {
+            std::printf("%s is not supported, checking %s instead\n",
+                thmath::simd::to_string(instruction_set), thmath::simd::to_string(active));
+        }
+        for (size_t size : SIZES)
+        {
+            // Also one element in, so that no array is aligned.
+            Data data = make_data(size + 1, generator);
+            check_kernels(instruction_set, data, 0);
+            check_kernels(instruction_set, data, 1);
+        }
+    }
+    thmath::simd::set_instruction_set(thmath::simd::get_supported_instruction_set());
+
+    if (failures > 0)
+    {
+        std::printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("all checks passed\n");
+    return 0;
+}